@@ -0,0 +1,110 @@
+#!/usr/bin/env bash
+set -e
+
+# Usage: ./build_falcon_wasm.sh [--host-rng] [--simd] [--snapshot] [--out-dir DIR]
+#
+#   --host-rng   Seed keygen from the host CSPRNG (crypto.getRandomValues /
+#                crypto.randomFillSync) instead of linking libsodium
+#   --simd       Enable WebAssembly SIMD (-msimd128)
+#   --snapshot   Ship falcon.wasm pre-initialized (see falcon-snapshot.js)
+#   --out-dir    Where to write falcon.js and falcon.wasm (default: .)
+
+echo "🚀 Starting Falcon WASM build"
+
+# --- Options ---
+HOST_RNG=0
+SIMD=0
+SNAPSHOT=0
+OUT_DIR="$(pwd)"
+while [ $# -gt 0 ]; do
+  case "$1" in
+    --host-rng) HOST_RNG=1 ;;
+    --simd) SIMD=1 ;;
+    --snapshot) SNAPSHOT=1 ;;
+    --out-dir) shift; OUT_DIR="$1" ;;
+    *) echo "❌ Unknown option: $1"; exit 1 ;;
+  esac
+  shift
+done
+
+# --- Check prerequisites ---
+if ! command -v emcc >/dev/null 2>&1; then
+  echo "❌ Emscripten not found. Run: source ./emsdk_env.sh"
+  exit 1
+fi
+
+if [ ! -f falcon/falcon.c ]; then
+  echo "❌ Falcon sources missing. Run: git submodule update --init --recursive"
+  exit 1
+fi
+
+echo "🧠 Using Emscripten compiler: $(which emcc)"
+
+EXPORTED_FUNCTIONS='["_malloc","_free","_falcon_det1024_keygen_wrapper","_falcon_det1024_sign_compressed_wrapper","_falcon_det1024_convert_compressed_to_ct_wrapper","_falcon_det1024_verify_compressed_wrapper","_falcon_det1024_verify_ct_wrapper","_falcon_det1024_get_salt_version_wrapper","_falcon_det1024_decode_pubkey_wrapper","_falcon_det1024_decode_sig_ct_wrapper","_falcon_det1024_partial_key_size","_falcon_det1024_expand_partial_wrapper","_falcon_det1024_sign_compressed_partial_wrapper","_falcon_det1024_sk_midstate_size","_falcon_det1024_sk_midstate_wrapper","_falcon_det1024_sign_compressed_midstate_wrapper","_falcon_det1024_sign_stream_init","_falcon_det1024_sign_stream_update","_falcon_det1024_sign_stream_finish","_falcon_det1024_sign_stream_abort","_falcon_det1024_verify_stream_init","_falcon_det1024_verify_stream_update","_falcon_det1024_verify_stream_finish","_falcon_det1024_verify_stream_abort","_get_sk_size","_get_pk_size","_get_sig_compressed_max_size","_get_sig_ct_size"]'
+
+FLAGS=(-O3 -s MODULARIZE=1 -s EXPORT_ES6=1 -s ENVIRONMENT=web,worker,node)
+
+# --- RNG source ---
+if [ "$HOST_RNG" = 1 ]; then
+  echo "🎲 RNG: host CSPRNG (no libsodium)"
+  FLAGS+=(-DFALCON_HOST_RNG)
+else
+  if [ ! -f external/libsodium/dist/lib/libsodium.a ]; then
+    echo "❌ libsodium.a missing. Run ./build_libsodium_wasm.sh or use --host-rng"
+    exit 1
+  fi
+  echo "🎲 RNG: libsodium"
+  FLAGS+=(-Iexternal/libsodium/dist/include -Lexternal/libsodium/dist/lib -lsodium)
+fi
+
+if [ "$SIMD" = 1 ]; then
+  echo "⚡ WebAssembly SIMD enabled"
+  FLAGS+=(-msimd128)
+fi
+
+# --- Build ---
+mkdir -p "$OUT_DIR"
+echo "🔨 Building $OUT_DIR/falcon.js ..."
+emcc "${FLAGS[@]}" \
+  -s EXPORTED_FUNCTIONS="$EXPORTED_FUNCTIONS" \
+  -s EXPORTED_RUNTIME_METHODS='["ccall","cwrap","getValue","setValue","HEAPU8"]' \
+  falcon/common.c falcon/codec.c falcon/deterministic.c falcon/falcon.c falcon/fft.c falcon/fpr.c falcon/keygen.c falcon/rng.c falcon/shake.c falcon/sign.c falcon/vrfy.c falcon_wrapper.c \
+  -o "$OUT_DIR/falcon.js"
+
+# --- Pre-initialized snapshot ---
+if [ "$SNAPSHOT" = 1 ]; then
+  echo "📸 Snapshotting initialized memory into falcon.wasm ..."
+  node falcon-snapshot.js --module "$OUT_DIR/falcon.js" --out "$OUT_DIR/falcon.snapshot.wasm"
+  mv "$OUT_DIR/falcon.snapshot.wasm" "$OUT_DIR/falcon.wasm"
+fi
+
+# --- Confirm output ---
+if [ -f "$OUT_DIR/falcon.wasm" ]; then
+  echo "🎯 falcon.wasm: $(wc -c < "$OUT_DIR/falcon.wasm") bytes"
+else
+  echo "❌ falcon.wasm missing — build failed."
+  exit 1
+fi
+
+# --- Check exports ---
+# A module missing an export silently falls back (or is emulated in tests),
+# so every exported function must be present in what was just built
+echo "🔍 Checking exported functions ..."
+MODULE="$OUT_DIR/falcon.js" EXPORTS="$EXPORTED_FUNCTIONS" node --input-type=module -e '
+  const { pathToFileURL } = await import("url");
+  const factory = (await import(pathToFileURL(process.env.MODULE))).default;
+  const module = await factory({ print: () => {}, printErr: () => {} });
+  const missing = JSON.parse(process.env.EXPORTS).filter((name) => typeof module[name] !== "function");
+  if (missing.length > 0) {
+    console.error(`❌ Missing exports: ${missing.join(", ")}`);
+    process.exit(1);
+  }
+'
+
+# --- Run the tests on the real exports ---
+if [ "$OUT_DIR" -ef "$(pwd)" ]; then
+  echo "🧪 Running falcon-test.js against the new build (no emulated exports) ..."
+  FALCON_REQUIRE_EXPORTS=1 node falcon-test.js > /dev/null
+fi
+
+echo "🏁 Falcon WebAssembly build ready. Compare startup with: node falcon-bench.js startup --module $OUT_DIR/falcon.js"
@@ -0,0 +1,74 @@
+/**
+ * Shared confirmation tracker
+ * Follows algod rounds once for all in-flight transactions instead of running
+ * one `algosdk.waitForConfirmation` polling loop per transaction ID.
+ */
+/**
+ * Minimal algod surface used by the tracker (satisfied by `algosdk.Algodv2`)
+ */
+export type AlgodStatusClient = {
+    status(): {
+        do(): Promise<any>;
+    };
+    statusAfterBlock(round: number | bigint): {
+        do(): Promise<any>;
+    };
+    pendingTransactionInformation(txid: string): {
+        do(): Promise<any>;
+    };
+};
+export type ConfirmationTrackerStats = {
+    pending: number;
+    rounds: number;
+    statusRequests: number;
+    pendingInfoRequests: number;
+    confirmed: number;
+    failed: number;
+};
+/**
+ * Tracks many pending transactions against a single round-following loop.
+ *
+ * Each observed round triggers one pass over every pending transaction ID;
+ * callers of `waitForConfirmation` get the same pending-transaction response
+ * `algosdk.waitForConfirmation` would return, or the same errors (pool error,
+ * not confirmed within the requested number of rounds).
+ */
+export declare class ConfirmationTracker {
+    algod: AlgodStatusClient;
+    private _pending;
+    private _loop;
+    private _round;
+    private _stats;
+    constructor(algod: AlgodStatusClient);
+    /**
+     * Number of transaction IDs currently being tracked
+     */
+    get pendingCount(): number;
+    /**
+     * Request counters, useful to compare against per-transaction polling
+     */
+    stats(): ConfirmationTrackerStats;
+    /**
+     * Wait until a transaction is confirmed
+     * @param txId Transaction ID (for groups, any transaction ID of the group)
+     * @param waitRounds Maximum number of rounds to wait (default: 10)
+     * @returns Pending transaction information of the confirmed transaction
+     */
+    waitForConfirmation(txId: string, waitRounds?: number): Promise<any>;
+    /**
+     * Round-following loop; runs while at least one transaction is pending
+     * @private
+     */
+    private _run;
+    /**
+     * Check every pending transaction once for the given round
+     * @private
+     */
+    private _checkPending;
+    /**
+     * Resolve or reject every waiter of a transaction
+     * @private
+     */
+    private _settle;
+}
+export default ConfirmationTracker;
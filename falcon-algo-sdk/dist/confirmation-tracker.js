@@ -0,0 +1,145 @@
+/**
+ * Shared confirmation tracker
+ * Follows algod rounds once for all in-flight transactions instead of running
+ * one `algosdk.waitForConfirmation` polling loop per transaction ID.
+ */
+const getLastRound = (resp) => Number(resp?.lastRound ?? resp?.['last-round'] ?? 0);
+const getConfirmedRound = (resp) => {
+    const round = resp?.confirmedRound ?? resp?.['confirmed-round'];
+    return round ? Number(round) : undefined;
+};
+const getPoolError = (resp) => resp?.poolError ?? resp?.['pool-error'] ?? '';
+/**
+ * Tracks many pending transactions against a single round-following loop.
+ *
+ * Each observed round triggers one pass over every pending transaction ID;
+ * callers of `waitForConfirmation` get the same pending-transaction response
+ * `algosdk.waitForConfirmation` would return, or the same errors (pool error,
+ * not confirmed within the requested number of rounds).
+ */
+export class ConfirmationTracker {
+    constructor(algod) {
+        this.algod = algod;
+        this._pending = new Map();
+        this._loop = null;
+        this._round = null;
+        this._stats = {
+            pending: 0,
+            rounds: 0,
+            statusRequests: 0,
+            pendingInfoRequests: 0,
+            confirmed: 0,
+            failed: 0,
+        };
+    }
+    /**
+     * Number of transaction IDs currently being tracked
+     */
+    get pendingCount() {
+        return this._pending.size;
+    }
+    /**
+     * Request counters, useful to compare against per-transaction polling
+     */
+    stats() {
+        return { ...this._stats, pending: this._pending.size };
+    }
+    /**
+     * Wait until a transaction is confirmed
+     * @param txId Transaction ID (for groups, any transaction ID of the group)
+     * @param waitRounds Maximum number of rounds to wait (default: 10)
+     * @returns Pending transaction information of the confirmed transaction
+     */
+    waitForConfirmation(txId, waitRounds = 10) {
+        return new Promise((resolve, reject) => {
+            const existing = this._pending.get(txId);
+            if (existing) {
+                existing.waiters.push({ resolve, reject });
+                existing.waitRounds = Math.max(existing.waitRounds, waitRounds);
+                if (existing.lastRound !== null && this._round !== null) {
+                    existing.lastRound = Math.max(existing.lastRound, this._round + waitRounds);
+                }
+            }
+            else {
+                this._pending.set(txId, { txId, waitRounds, lastRound: null, waiters: [{ resolve, reject }] });
+            }
+            if (!this._loop) {
+                this._loop = this._run();
+            }
+        });
+    }
+    /**
+     * Round-following loop; runs while at least one transaction is pending
+     * @private
+     */
+    async _run() {
+        try {
+            this._stats.statusRequests++;
+            let round = getLastRound(await this.algod.status().do());
+            while (this._pending.size > 0) {
+                this._round = round;
+                this._stats.rounds++;
+                await this._checkPending(round);
+                if (this._pending.size === 0)
+                    break;
+                this._stats.statusRequests++;
+                const next = getLastRound(await this.algod.statusAfterBlock(round).do());
+                round = Math.max(next, round + 1);
+            }
+        }
+        catch (error) {
+            // Status failures affect every caller, as they would for each waitForConfirmation loop
+            const failed = Array.from(this._pending.values());
+            this._pending.clear();
+            for (const tx of failed) {
+                this._settle(tx, null, error instanceof Error ? error : new Error(String(error)));
+            }
+        }
+        // Cleared in the same tick as the final empty check so new waiters restart the loop
+        this._round = null;
+        this._loop = null;
+    }
+    /**
+     * Check every pending transaction once for the given round
+     * @private
+     */
+    async _checkPending(round) {
+        const batch = Array.from(this._pending.values());
+        for (const tx of batch) {
+            if (tx.lastRound === null)
+                tx.lastRound = round + tx.waitRounds;
+        }
+        this._stats.pendingInfoRequests += batch.length;
+        const responses = await Promise.all(batch.map((tx) => this.algod.pendingTransactionInformation(tx.txId).do().catch(() => null)));
+        batch.forEach((tx, i) => {
+            const info = responses[i];
+            if (getConfirmedRound(info) !== undefined) {
+                this._pending.delete(tx.txId);
+                this._settle(tx, info, null);
+            }
+            else if (getPoolError(info)) {
+                this._pending.delete(tx.txId);
+                this._settle(tx, null, new Error(`Transaction Rejected: ${getPoolError(info)}`));
+            }
+            else if (round >= tx.lastRound) {
+                this._pending.delete(tx.txId);
+                this._settle(tx, null, new Error(`Transaction not confirmed after ${tx.waitRounds} rounds`));
+            }
+        });
+    }
+    /**
+     * Resolve or reject every waiter of a transaction
+     * @private
+     */
+    _settle(tx, info, error) {
+        if (error) {
+            this._stats.failed++;
+            tx.waiters.forEach((w) => w.reject(error));
+        }
+        else {
+            this._stats.confirmed++;
+            tx.waiters.forEach((w) => w.resolve(info));
+        }
+    }
+}
+export default ConfirmationTracker;
@@ -4,6 +4,19 @@
  */
 import algosdk, { Algodv2, LogicSigAccount, Transaction } from 'algosdk';
 import Falcon from 'falcon-signatures';
+import { ConfirmationTracker } from './confirmation-tracker.js';
+import { LogicSigEvaluation, LogicSigEvaluator } from './lsig-evaluator.js';
+import { PreparedFalconAccount } from './prepared-account.js';
+import { SubmissionPipeline, SubmissionPipelineOptions, SubmissionResult } from './submission-pipeline.js';
+export { ConfirmationTracker } from './confirmation-tracker.js';
+export type { AlgodStatusClient, ConfirmationTrackerStats } from './confirmation-tracker.js';
+export { PreparedFalconAccount } from './prepared-account.js';
+export { LogicSigBlobTemplate, rawTxIDFromBytes } from './lsig-template.js';
+export { LogicSigEvaluator } from './lsig-evaluator.js';
+export type { LogicSigEvaluation, LogicSigEvaluatorStats } from './lsig-evaluator.js';
+export type { PreparableAccountInfo, PreparedSignedTx } from './prepared-account.js';
+export { SubmissionPipeline, isTransientAlgodError } from './submission-pipeline.js';
+export type { AlgodSubmitClient, LatencySummary, StageLatency, SubmissionJob, SubmissionPipelineOptions, SubmissionPipelineStats, SubmissionResult, } from './submission-pipeline.js';
 /**
  * Network configurations
  */
@@ -58,6 +71,51 @@ export type ConversionInfo = {
     network: string;
     type: 'converted-to-falcon';
 };
+export type BatchRotationOptions = {
+    /** Accounts whose new keys and LogicSig are prepared at once (default: 8) */
+    concurrency?: number;
+    /** Rekey transactions per atomic group, at most 16 (default: 16) */
+    groupSize?: number;
+    /** Keypair source, e.g. `() => pool.keypair()` for worker threads (default: this SDK's Falcon instance) */
+    keygen?: () => Promise<FalconKeyPair>;
+    /** Submit the rekey groups through a submission pipeline as they are signed (default: false) */
+    submit?: boolean | SubmissionPipelineOptions;
+    /** Called as each account's new keys and LogicSig are ready */
+    onProgress?: (done: number, total: number) => void;
+};
+export type RotatedAccountInfo = (FalconAccountInfo | ConversionInfo) & {
+    previousLogicSig: LogicSigInfo;
+    rotated: string;
+};
+export type BatchRotationResult = {
+    accounts: RotatedAccountInfo[];
+    groups: {
+        txIds: string[];
+        signedTransactions: Uint8Array[];
+    }[];
+    submissions: PromiseSettledResult<SubmissionResult>[] | null;
+    elapsedMs: number;
+    rotationsPerSecond: number;
+    /** Time spent in each stage, summed over accounts and groups (stages overlap) */
+    stageMs: {
+        keygen: number;
+        derive: number;
+        sign: number;
+    };
+};
+/**
+ * Thrown by `rotateFalconKeysBatch` when an account fails partway through.
+ * Groups signed before the failure may already be submitted and confirm,
+ * rekeying their accounts, so `result` holds everything produced so far:
+ * `accounts` and `groups` are indexed like a full result, with gaps where
+ * nothing was prepared or signed. Keep the new keys of every signed group.
+ */
+export declare class BatchRotationError extends Error {
+    readonly result: BatchRotationResult;
+    /** The error of the account (or group) that failed */
+    readonly cause: unknown;
+    constructor(cause: unknown, result: BatchRotationResult);
+}
 type SignedLogicSigTx = {
     txID: string;
     blob: Uint8Array;
@@ -82,7 +140,20 @@ export declare class FalconAlgoSDK {
     falcon: Falcon;
     initialized: boolean;
     private _initPromise;
+    private _confirmations;
+    private _evaluator;
     constructor(network?: NetworkConfig, customAlgod?: Algodv2 | null);
+    /**
+     * Shared confirmation tracker for the current algod client.
+     * All submissions wait through it, so status polling is shared across
+     * every in-flight transaction instead of repeated per transaction ID.
+     */
+    get confirmations(): ConfirmationTracker;
+    /**
+     * Offline evaluator for Falcon LogicSig transactions, sharing this SDK's
+     * Falcon instance and its cache of decoded programs.
+     */
+    get logicSigEvaluator(): LogicSigEvaluator;
     /**
      * Initialize the Falcon module
      * @private
@@ -101,6 +172,14 @@ export declare class FalconAlgoSDK {
      * @private
      */
     private _generateTealProgram;
+    /**
+     * Compile the TEAL program for counters 0..255 until its LogicSig address
+     * is off the Ed25519 curve
+     * @param falconPublicKey Falcon public key
+     * @returns Selected counter, compiled program and LogicSig address
+     * @private
+     */
+    private _compileOffCurveProgram;
     /**
      * Core Function 1: Create a new Falcon-protected Algorand account
      * @param options Options for account creation
@@ -138,6 +217,14 @@ export declare class FalconAlgoSDK {
      * Falcon account and moving funds.
      */
     createLogicSig(accountInfo: FalconAccountInfo | ConversionInfo, txid: string): Promise<LogicSigAccount>;
+    /**
+     * Prepare a Falcon account for repeated signing.
+     *
+     * Decodes the program and Falcon keys and builds the LogicSig template once;
+     * the returned object's `sign(txn)` only handles per-transaction data.
+     * Applies the same off-curve guard as `createLogicSig`.
+     */
+    prepareAccount(accountInfo: FalconAccountInfo | ConversionInfo): Promise<PreparedFalconAccount>;
     /**
      * Sign a transaction with Falcon-protected account
      */
@@ -166,6 +253,22 @@ export declare class FalconAlgoSDK {
         previousAddress: string;
         rotated: string;
     }>;
+    /**
+     * Additional Function: Rotate the Falcon keys of many accounts in place
+     *
+     * Each account is rekeyed from its current LogicSig to one for a fresh Falcon
+     * keypair, so its address and funds stay where they are. Up to `concurrency`
+     * accounts generate keys and search for an off-curve LogicSig address at
+     * once; rekey transactions are grouped `groupSize` at a time and each group
+     * is signed (with the accounts' current keys) as soon as its accounts are
+     * ready. The returned account infos take effect once their group confirms.
+     *
+     * If an account fails, no further groups are signed; the call waits for
+     * groups already being signed or submitted and throws a
+     * `BatchRotationError` carrying their accounts, so no submitted rekey loses
+     * its new keys.
+     */
+    rotateFalconKeysBatch(accounts: (FalconAccountInfo | ConversionInfo)[], options?: BatchRotationOptions): Promise<BatchRotationResult>;
     /**
      * Additional Function: Create a multi-signature transaction group
      */
@@ -178,6 +281,20 @@ export declare class FalconAlgoSDK {
         confirmedRound: number;
         groupSize: number;
     }>;
+    /**
+     * Additional Function: Check signed transactions offline before submission
+     *
+     * Runs each Falcon LogicSig program against its transaction with the local
+     * Falcon verifier, in place of an algod dryrun/simulate round-trip. Results
+     * for programs outside the Falcon template are marked `unsupported`.
+     */
+    evaluateLogicSigs(signedTransactions: Uint8Array[]): Promise<LogicSigEvaluation[]>;
+    /**
+     * Create a pipeline that keeps several groups in flight on this SDK's algod
+     * client and confirmation tracker, retrying transient send errors.
+     * `{ transactions, accounts }` jobs are signed with `signTransactionGroup`.
+     */
+    createSubmissionPipeline(options?: SubmissionPipelineOptions): SubmissionPipeline;
     /**
      * Additional Function: Estimate transaction fees for Falcon transactions
      */
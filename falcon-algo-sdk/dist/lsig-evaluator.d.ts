@@ -0,0 +1,78 @@
+import Falcon from 'falcon-signatures';
+export type LogicSigEvaluation = {
+    txID: string;
+    /** The program approved the transaction */
+    pass: boolean;
+    /** Why the transaction was rejected or could not be evaluated */
+    error?: string;
+    /** Not a Falcon template program (or not a LogicSig); check it with algod instead */
+    unsupported?: boolean;
+    /** Opcode cost of the program */
+    cost: number;
+};
+export type LogicSigEvaluatorStats = {
+    evaluated: number;
+    passed: number;
+    rejected: number;
+    unsupported: number;
+    programs: number;
+};
+/**
+ * Evaluates Falcon LogicSig transactions offline.
+ *
+ * Programs are decoded once and cached. Each transaction's program is run up
+ * to its falcon_verify, and the signature checks of a whole call are done in
+ * one `Falcon.verifyBatch`. Programs outside the Falcon template are reported
+ * as `unsupported` rather than guessed at.
+ */
+export declare class LogicSigEvaluator {
+    readonly cacheSize: number;
+    private _falcon;
+    private _programs;
+    private _stats;
+    /**
+     * @param falcon Falcon instance used for verification
+     * @param options.cacheSize Decoded programs kept (default: 1024)
+     */
+    constructor(falcon: Falcon, options?: {
+        cacheSize?: number;
+    });
+    /**
+     * Run a program against its arguments and a raw 32-byte transaction ID,
+     * without the signed-transaction checks of `evaluate`
+     */
+    evaluateProgram(program: Uint8Array, args: Uint8Array[], rawTxId: Uint8Array): Promise<Omit<LogicSigEvaluation, 'txID'>>;
+    /**
+     * Evaluate signed transactions (e.g. a signed group)
+     * @param signedTransactions Encoded signed transactions
+     * @returns One result per transaction, in order
+     */
+    evaluate(signedTransactions: Uint8Array[]): Promise<LogicSigEvaluation[]>;
+    /**
+     * Evaluate signed transactions and throw if any would be rejected, e.g. as
+     * a `SubmissionPipeline` preflight. Unsupported transactions are let through.
+     */
+    assertPass(signedTransactions: Uint8Array[]): Promise<void>;
+    /**
+     * Evaluation counters and cached programs
+     */
+    stats(): LogicSigEvaluatorStats;
+    /**
+     * Signature checks in one `Falcon.verifyBatch`, or one `verify` each with
+     * falcon-signatures releases before 1.5.0, which lack it
+     * @private
+     */
+    private _verifyBatch;
+    /**
+     * Decoded program from the cache, decoding it on a miss
+     * @private
+     */
+    private _parse;
+    /**
+     * Execute a decoded program up to the signature check its result depends
+     * on, which is returned for batch verification instead of being run
+     * @private
+     */
+    private _run;
+}
+export default LogicSigEvaluator;
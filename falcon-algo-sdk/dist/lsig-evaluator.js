@@ -0,0 +1,285 @@
+/**
+ * Offline LogicSig evaluation
+ * Runs Falcon LogicSig programs (the template of `_generateTealProgram`)
+ * against signed transactions with the local Falcon verifier, so failing
+ * transactions are caught before submission without an algod dryrun or
+ * simulate round-trip.
+ */
+import algosdk from 'algosdk';
+// Opcodes used by the Falcon LogicSig template
+const OP_BYTECBLOCK = 0x26;
+const OP_ARG = 0x2c;
+const OP_ARG_0 = 0x2d; // arg_0 .. arg_3 are 0x2d .. 0x30
+const OP_ARG_3 = 0x30;
+const OP_TXN = 0x31;
+const OP_PUSHBYTES = 0x80;
+const OP_FALCON_VERIFY = 0x85;
+const TXN_FIELD_TXID = 0x17;
+const FALCON_VERIFY_VERSION = 12;
+const FALCON_VERIFY_COST = 1700;
+const FALCON_PK_SIZE = 1793;
+const LOGICSIG_BUDGET = 20000;
+/**
+ * Read an unsigned LEB128 varuint
+ */
+function readVarUint(program, pc) {
+    let value = 0;
+    for (let shift = 0; pc < program.length && shift < 35; shift += 7) {
+        const byte = program[pc++];
+        value += (byte & 0x7f) * 2 ** shift;
+        if ((byte & 0x80) === 0)
+            return { value, next: pc };
+    }
+    throw new Error('Truncated varuint');
+}
+/**
+ * Decode a program into straight-line instructions. Only the opcodes of the
+ * Falcon template are understood; anything else marks the program unsupported.
+ */
+function parseProgram(program) {
+    const parsed = { program, instructions: [], cost: 0, address: null };
+    try {
+        const { value: version, next } = readVarUint(program, 0);
+        if (version < FALCON_VERIFY_VERSION) {
+            return { ...parsed, error: `falcon_verify needs program version ${FALCON_VERIFY_VERSION}, got ${version}` };
+        }
+        let pc = next;
+        while (pc < program.length) {
+            const opcode = program[pc++];
+            parsed.cost += opcode === OP_FALCON_VERIFY ? FALCON_VERIFY_COST : 1;
+            if (opcode === OP_BYTECBLOCK) {
+                // Constants are never referenced by the template (the counter only shifts the address)
+                const count = readVarUint(program, pc);
+                pc = count.next;
+                for (let i = 0; i < count.value; i++) {
+                    const length = readVarUint(program, pc);
+                    pc = length.next + length.value;
+                }
+            }
+            else if (opcode === OP_ARG) {
+                parsed.instructions.push({ op: 'arg', index: program[pc++] });
+            }
+            else if (opcode >= OP_ARG_0 && opcode <= OP_ARG_3) {
+                parsed.instructions.push({ op: 'arg', index: opcode - OP_ARG_0 });
+            }
+            else if (opcode === OP_TXN && program[pc] === TXN_FIELD_TXID) {
+                parsed.instructions.push({ op: 'txid' });
+                pc++;
+            }
+            else if (opcode === OP_PUSHBYTES) {
+                const length = readVarUint(program, pc);
+                pc = length.next + length.value;
+                parsed.instructions.push({ op: 'push', bytes: program.subarray(length.next, pc) });
+            }
+            else if (opcode === OP_FALCON_VERIFY) {
+                parsed.instructions.push({ op: 'falcon_verify' });
+            }
+            else {
+                const name = opcode === OP_TXN ? `txn field ${program[pc]}` : `opcode 0x${opcode.toString(16).padStart(2, '0')}`;
+                return { ...parsed, error: `Unsupported ${name} at pc ${pc - 1}`, unsupported: true };
+            }
+            if (pc > program.length)
+                throw new Error('Truncated immediate');
+        }
+    }
+    catch (error) {
+        return { ...parsed, error: `Malformed program: ${error.message}` };
+    }
+    if (parsed.cost > LOGICSIG_BUDGET) {
+        return { ...parsed, error: `Program cost ${parsed.cost} exceeds the LogicSig budget of ${LOGICSIG_BUDGET}` };
+    }
+    return parsed;
+}
+/**
+ * Evaluates Falcon LogicSig transactions offline.
+ *
+ * Programs are decoded once and cached. Each transaction's program is run up
+ * to its falcon_verify, and the signature checks of a whole call are done in
+ * one `Falcon.verifyBatch`. Programs outside the Falcon template are reported
+ * as `unsupported` rather than guessed at.
+ */
+export class LogicSigEvaluator {
+    /**
+     * @param falcon Falcon instance used for verification
+     * @param options.cacheSize Decoded programs kept (default: 1024)
+     */
+    constructor(falcon, options = {}) {
+        this._falcon = falcon;
+        this.cacheSize = options.cacheSize ?? 1024;
+        this._programs = new Map();
+        this._stats = { evaluated: 0, passed: 0, rejected: 0, unsupported: 0 };
+    }
+    /**
+     * Run a program against its arguments and a raw 32-byte transaction ID,
+     * without the signed-transaction checks of `evaluate`
+     */
+    async evaluateProgram(program, args, rawTxId) {
+        const parsed = this._parse(program);
+        const run = this._run(parsed, args, rawTxId);
+        if ('error' in run)
+            return run;
+        const [{ ok, error }] = await this._verifyBatch([run.check]);
+        return error ? { pass: false, error, cost: parsed.cost } : { pass: ok, ...(ok ? {} : { error: 'falcon_verify failed' }), cost: parsed.cost };
+    }
+    /**
+     * Evaluate signed transactions (e.g. a signed group)
+     * @param signedTransactions Encoded signed transactions
+     * @returns One result per transaction, in order
+     */
+    async evaluate(signedTransactions) {
+        const results = new Array(signedTransactions.length);
+        const checks = [];
+        const owners = [];
+        for (let i = 0; i < signedTransactions.length; i++) {
+            let stxn;
+            try {
+                stxn = algosdk.decodeSignedTransaction(signedTransactions[i]);
+            }
+            catch (error) {
+                results[i] = { txID: '', pass: false, error: `Undecodable signed transaction: ${error.message}`, cost: 0 };
+                continue;
+            }
+            const txID = stxn.txn.txID();
+            const lsig = stxn.lsig;
+            if (!lsig) {
+                results[i] = { txID, pass: false, error: 'Not a LogicSig transaction', unsupported: true, cost: 0 };
+                continue;
+            }
+            if (lsig.sig || lsig.msig || lsig.lmsig) {
+                results[i] = { txID, pass: false, error: 'Delegated LogicSig', unsupported: true, cost: 0 };
+                continue;
+            }
+            const parsed = this._parse(lsig.logic);
+            if (!parsed.error) {
+                parsed.address ?? (parsed.address = new algosdk.LogicSigAccount(parsed.program).address().toString());
+                const authorizer = (stxn.sgnr ?? stxn.txn.sender).toString();
+                if (authorizer !== parsed.address) {
+                    results[i] = { txID, pass: false, error: `LogicSig ${parsed.address} is not the authorizer ${authorizer}`, cost: parsed.cost };
+                    continue;
+                }
+            }
+            const run = this._run(parsed, lsig.args ?? [], stxn.txn.rawTxID());
+            if ('error' in run) {
+                results[i] = { txID, ...run };
+                continue;
+            }
+            checks.push(run.check);
+            owners.push(i);
+            results[i] = { txID, pass: false, cost: parsed.cost };
+        }
+        const verified = checks.length > 0 ? await this._verifyBatch(checks) : [];
+        verified.forEach(({ ok, error }, j) => {
+            const result = results[owners[j]];
+            result.pass = ok;
+            if (!ok)
+                result.error = error ?? 'falcon_verify failed';
+        });
+        for (const result of results) {
+            this._stats.evaluated++;
+            if (result.pass)
+                this._stats.passed++;
+            else if (result.unsupported)
+                this._stats.unsupported++;
+            else
+                this._stats.rejected++;
+        }
+        return results;
+    }
+    /**
+     * Evaluate signed transactions and throw if any would be rejected, e.g. as
+     * a `SubmissionPipeline` preflight. Unsupported transactions are let through.
+     */
+    async assertPass(signedTransactions) {
+        const failures = (await this.evaluate(signedTransactions)).filter((r) => !r.pass && !r.unsupported);
+        if (failures.length > 0) {
+            throw new Error(`LogicSig rejected ${failures.map((r) => `${r.txID}: ${r.error}`).join('; ')}`);
+        }
+    }
+    /**
+     * Evaluation counters and cached programs
+     */
+    stats() {
+        return { ...this._stats, programs: this._programs.size };
+    }
+    /**
+     * Signature checks in one `Falcon.verifyBatch`, or one `verify` each with
+     * falcon-signatures releases before 1.5.0, which lack it
+     * @private
+     */
+    async _verifyBatch(checks) {
+        if (typeof this._falcon.verifyBatch === 'function')
+            return this._falcon.verifyBatch(checks);
+        return Promise.all(checks.map(async ({ message, signature, publicKey }) => {
+            try {
+                return { ok: await this._falcon.verify(message, signature, publicKey) };
+            }
+            catch (error) {
+                return { ok: false, error: error.message };
+            }
+        }));
+    }
+    /**
+     * Decoded program from the cache, decoding it on a miss
+     * @private
+     */
+    _parse(program) {
+        const key = Buffer.from(program.buffer, program.byteOffset, program.byteLength).toString('latin1');
+        let parsed = this._programs.get(key);
+        if (parsed) {
+            // Refresh LRU position
+            this._programs.delete(key);
+        }
+        else {
+            parsed = parseProgram(program.slice());
+            if (this._programs.size >= this.cacheSize) {
+                this._programs.delete(this._programs.keys().next().value);
+            }
+        }
+        this._programs.set(key, parsed);
+        return parsed;
+    }
+    /**
+     * Execute a decoded program up to the signature check its result depends
+     * on, which is returned for batch verification instead of being run
+     * @private
+     */
+    _run(parsed, args, rawTxId) {
+        const fail = (error) => ({ pass: false, error, cost: parsed.cost });
+        if (parsed.error)
+            return { ...fail(parsed.error), ...(parsed.unsupported ? { unsupported: true } : {}) };
+        const stack = [];
+        for (const instruction of parsed.instructions) {
+            switch (instruction.op) {
+                case 'arg':
+                    if (instruction.index >= args.length)
+                        return fail(`Missing LogicSig argument ${instruction.index}`);
+                    stack.push(args[instruction.index]);
+                    break;
+                case 'txid':
+                    stack.push(rawTxId);
+                    break;
+                case 'push':
+                    stack.push(instruction.bytes);
+                    break;
+                case 'falcon_verify': {
+                    const [message, signature, publicKey] = stack.splice(-3);
+                    if (!(message instanceof Uint8Array) || !(signature instanceof Uint8Array) || !(publicKey instanceof Uint8Array)) {
+                        return fail('falcon_verify needs three byte arrays on the stack');
+                    }
+                    if (publicKey.length !== FALCON_PK_SIZE) {
+                        return fail(`Invalid Falcon public key length: ${publicKey.length}, expected ${FALCON_PK_SIZE}`);
+                    }
+                    stack.push({ verify: { message, signature, publicKey } });
+                    break;
+                }
+            }
+        }
+        // A LogicSig approves only if it ends with exactly one non-zero integer
+        const result = stack[0];
+        if (stack.length !== 1 || result instanceof Uint8Array) {
+            return fail(`Program must end with one integer on the stack, got ${stack.length} values`);
+        }
+        return { check: result.verify };
+    }
+}
+export default LogicSigEvaluator;
@@ -0,0 +1,41 @@
+/**
+ * Pre-encoded LogicSig signed-transaction skeletons
+ * Splices a Falcon signature and encoded transaction into the constant
+ * msgpack encoding of an account's LogicSig, producing the same bytes as
+ * `algosdk.signLogicSigTransactionObject` without re-encoding the program.
+ */
+/**
+ * Transaction ID of an encoded transaction: SHA-512/256 over "TX" || txn
+ */
+export declare function rawTxIDFromBytes(txnBytes: Uint8Array): Uint8Array;
+/**
+ * Canonical msgpack layout of a signed LogicSig transaction (keys sorted):
+ *
+ *   map{ "lsig": map{ "arg": [bin sig], "l": bin program },
+ *        ["sgnr": bin 32 address,]      // only when the sender is rekeyed
+ *        "txn": <encoded transaction> }
+ *
+ * Everything except the signature, the transaction and the outer map size is
+ * constant per account and encoded once here.
+ */
+export declare class LogicSigBlobTemplate {
+    readonly program: Uint8Array;
+    private _lsigHead;
+    private _programTail;
+    private _sgnr;
+    private _txnKey;
+    /**
+     * @param program Compiled LogicSig program
+     * @param lsigPublicKey 32-byte public key of the LogicSig address
+     */
+    constructor(program: Uint8Array, lsigPublicKey: Uint8Array);
+    /**
+     * Assemble a signed transaction blob
+     * @param signature Falcon signature (LogicSig arg 0)
+     * @param txnBytes msgpack-encoded transaction (`txn.toByte()`)
+     * @param rekeyed Whether the sender differs from the LogicSig address
+     * @returns Signed transaction bytes, ready for sendRawTransaction
+     */
+    encode(signature: Uint8Array, txnBytes: Uint8Array, rekeyed: boolean): Uint8Array;
+}
+export default LogicSigBlobTemplate;
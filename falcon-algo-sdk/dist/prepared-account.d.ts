@@ -0,0 +1,52 @@
+/**
+ * Prepared Falcon accounts
+ * Decodes an account's keys and LogicSig program once so that signing a
+ * transaction only handles per-transaction data.
+ */
+import { LogicSigAccount, Transaction } from 'algosdk';
+import Falcon from 'falcon-signatures';
+import { LogicSigBlobTemplate } from './lsig-template.js';
+export type PreparableAccountInfo = {
+    falconKeys: {
+        publicKey: string;
+        secretKey?: string;
+    };
+    logicSig: {
+        program: string;
+        address: string;
+    };
+};
+export type PreparedSignedTx = {
+    txID: string;
+    blob: Uint8Array;
+};
+/**
+ * Falcon account with decoded program, LogicSig template and keys.
+ * Create it with `FalconAlgoSDK.prepareAccount()`.
+ */
+export declare class PreparedFalconAccount {
+    readonly address: string;
+    readonly program: Uint8Array;
+    readonly publicKey: Uint8Array;
+    readonly lsig: LogicSigAccount;
+    readonly template: LogicSigBlobTemplate;
+    private _lsigAddress;
+    private _secretKey;
+    private _falcon;
+    constructor(falcon: Falcon, accountInfo: PreparableAccountInfo);
+    /**
+     * Whether the account holds a secret key and can sign
+     */
+    get canSign(): boolean;
+    /**
+     * Falcon signature over a raw 32-byte transaction ID (LogicSig arg 0)
+     */
+    signTxID(rawTxId: Uint8Array): Promise<Uint8Array>;
+    /**
+     * Sign a transaction; output matches `algosdk.signLogicSigTransactionObject`
+     * for the LogicSig built by `FalconAlgoSDK.createLogicSig`.
+     * The transaction is encoded once and spliced into the account's template.
+     */
+    sign(transaction: Transaction): Promise<PreparedSignedTx>;
+}
+export default PreparedFalconAccount;
@@ -0,0 +1,156 @@
+/**
+ * Pipelined transaction submission
+ * Keeps several groups between signing and confirmation at once, retries
+ * transient algod errors with jittered exponential backoff and records the
+ * latency of each stage (sign, send, confirm).
+ */
+import { AlgodStatusClient, ConfirmationTracker } from './confirmation-tracker.js';
+/**
+ * Minimal algod surface used by the pipeline (satisfied by `algosdk.Algodv2`)
+ */
+export type AlgodSubmitClient = AlgodStatusClient & {
+    sendRawTransaction(stxOrStxs: Uint8Array | Uint8Array[]): {
+        do(): Promise<any>;
+    };
+};
+/**
+ * One group to submit: already signed, a signing callback, or transactions
+ * with their accounts (requires the pipeline's `signGroup`)
+ */
+export type SubmissionJob = {
+    signedTransactions: Uint8Array[];
+} | {
+    sign: () => Promise<Uint8Array[]>;
+} | {
+    transactions: any[];
+    accounts: any[];
+};
+export type StageLatency = {
+    signMs: number;
+    sendMs: number;
+    confirmMs: number;
+    totalMs: number;
+};
+export type SubmissionResult = {
+    txId: string;
+    confirmedRound: number;
+    groupSize: number;
+    attempts: number;
+    latency: StageLatency;
+};
+export type LatencySummary = {
+    count: number;
+    mean: number;
+    p50: number;
+    p95: number;
+    max: number;
+};
+export type SubmissionPipelineStats = {
+    inFlight: number;
+    queued: number;
+    submitted: number;
+    confirmed: number;
+    failed: number;
+    retries: number;
+    latency: Record<'sign' | 'send' | 'confirm' | 'total', LatencySummary>;
+};
+export type SubmissionPipelineOptions = {
+    /** Groups between signing and confirmation at once (default: 8) */
+    concurrency?: number;
+    /** Send retries after a transient error (default: 5) */
+    maxRetries?: number;
+    /** First backoff delay in milliseconds (default: 100) */
+    baseDelayMs?: number;
+    /** Largest backoff delay in milliseconds (default: 5000) */
+    maxDelayMs?: number;
+    /** Rounds to wait for confirmation (default: 10) */
+    maxRounds?: number;
+    /** Classifies send errors worth retrying (default: network errors, 429 and 5xx) */
+    isTransient?: (error: any) => boolean;
+    /** Transaction ID of a signed group, used when a retried send finds the group already accepted */
+    txIdOf?: (signedTransactions: Uint8Array[]) => string;
+    /** Signs `{ transactions, accounts }` jobs (set by `FalconAlgoSDK.createSubmissionPipeline`) */
+    signGroup?: (transactions: any[], accounts: any[]) => Promise<Uint8Array[]>;
+    /** Checks each signed group before it is sent; a rejection fails the job unsent (e.g. `LogicSigEvaluator.assertPass`) */
+    preflight?: (signedTransactions: Uint8Array[]) => Promise<void>;
+    /** Confirmation tracker to wait through (default: a new tracker on `algod`) */
+    confirmations?: ConfirmationTracker;
+};
+/**
+ * Default transient error test: connection failures, HTTP 429 and 5xx
+ */
+export declare function isTransientAlgodError(error: any): boolean;
+/**
+ * Submits transaction groups with up to `concurrency` in flight.
+ *
+ * Each job is signed, sent and confirmed in turn; while one group waits for
+ * confirmation the next ones are already being signed and sent. Send errors
+ * classified as transient are retried with exponential backoff and equal
+ * jitter; if a retried send reports the group as already accepted, the
+ * pipeline waits for its confirmation instead of failing. Confirmation
+ * failures (pool errors, not confirmed in time) are not retried, since the
+ * group would have to be re-signed.
+ */
+export declare class SubmissionPipeline {
+    algod: AlgodSubmitClient;
+    confirmations: ConfirmationTracker;
+    concurrency: number;
+    maxRetries: number;
+    baseDelayMs: number;
+    maxDelayMs: number;
+    maxRounds: number;
+    private _isTransient;
+    private _txIdOf;
+    private _signGroup;
+    private _preflight;
+    private _queue;
+    private _inFlight;
+    private _idle;
+    private _counters;
+    private _latency;
+    constructor(algod: AlgodSubmitClient, options?: SubmissionPipelineOptions);
+    /**
+     * Queue a group; resolves once it is confirmed
+     * @param job Signed group, signing callback, or transactions with accounts
+     * @returns Transaction ID, confirmed round, attempts and per-stage latency
+     */
+    submit(job: SubmissionJob): Promise<SubmissionResult>;
+    /**
+     * Queue many groups; resolves with each group's result or error, in order
+     */
+    submitAll(jobs: Iterable<SubmissionJob>): Promise<PromiseSettledResult<SubmissionResult>[]>;
+    /**
+     * Wait until no group is queued or in flight
+     */
+    drain(): Promise<void>;
+    /**
+     * Counters and per-stage latency percentiles (over the last 1024 groups)
+     */
+    stats(): SubmissionPipelineStats;
+    /**
+     * Start queued jobs while fewer than `concurrency` are in flight
+     * @private
+     */
+    private _pump;
+    /**
+     * Sign, check, send (with retries) and confirm one group
+     * @private
+     */
+    private _run;
+    /**
+     * Produce the signed group of a job
+     * @private
+     */
+    private _sign;
+    /**
+     * Send a signed group, retrying transient errors with jittered backoff
+     * @private
+     */
+    private _send;
+    /**
+     * Keep the most recent latency samples of a stage
+     * @private
+     */
+    private _record;
+}
+export default SubmissionPipeline;
@@ -0,0 +1,215 @@
+/**
+ * Pipelined transaction submission
+ * Keeps several groups between signing and confirmation at once, retries
+ * transient algod errors with jittered exponential backoff and records the
+ * latency of each stage (sign, send, confirm).
+ */
+import algosdk from 'algosdk';
+import { ConfirmationTracker } from './confirmation-tracker.js';
+// Latency samples kept per stage for the percentile summaries
+const LATENCY_WINDOW = 1024;
+const TRANSIENT_CODES = new Set(['ECONNRESET', 'ECONNREFUSED', 'ETIMEDOUT', 'EPIPE', 'EAI_AGAIN', 'UND_ERR_SOCKET']);
+/**
+ * Default transient error test: connection failures, HTTP 429 and 5xx
+ */
+export function isTransientAlgodError(error) {
+    if (TRANSIENT_CODES.has(error?.code ?? error?.cause?.code))
+        return true;
+    const status = Number(error?.status ?? error?.response?.status);
+    if (status === 429 || (status >= 500 && status < 600))
+        return true;
+    return /status (429|5\d\d)|socket hang up|timed? ?out|network error(?!.*status 4)/i.test(String(error?.message ?? ''));
+}
+const ALREADY_ACCEPTED = /already in (the )?(ledger|pool)|transaction already/i;
+const defaultTxIdOf = (signedTransactions) => algosdk.decodeSignedTransaction(signedTransactions[0]).txn.txID();
+const getConfirmedRound = (resp) => Number(resp?.confirmedRound ?? resp?.['confirmed-round'] ?? 0);
+const sleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+const summarize = (samples) => {
+    if (samples.length === 0)
+        return { count: 0, mean: 0, p50: 0, p95: 0, max: 0 };
+    const sorted = [...samples].sort((a, b) => a - b);
+    const at = (p) => sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+    return {
+        count: sorted.length,
+        mean: sorted.reduce((a, b) => a + b, 0) / sorted.length,
+        p50: at(0.5),
+        p95: at(0.95),
+        max: sorted[sorted.length - 1],
+    };
+};
+/**
+ * Submits transaction groups with up to `concurrency` in flight.
+ *
+ * Each job is signed, sent and confirmed in turn; while one group waits for
+ * confirmation the next ones are already being signed and sent. Send errors
+ * classified as transient are retried with exponential backoff and equal
+ * jitter; if a retried send reports the group as already accepted, the
+ * pipeline waits for its confirmation instead of failing. Confirmation
+ * failures (pool errors, not confirmed in time) are not retried, since the
+ * group would have to be re-signed.
+ */
+export class SubmissionPipeline {
+    constructor(algod, options = {}) {
+        this.algod = algod;
+        this.confirmations = options.confirmations ?? new ConfirmationTracker(algod);
+        this.concurrency = Math.max(1, options.concurrency ?? 8);
+        this.maxRetries = options.maxRetries ?? 5;
+        this.baseDelayMs = options.baseDelayMs ?? 100;
+        this.maxDelayMs = options.maxDelayMs ?? 5000;
+        this.maxRounds = options.maxRounds ?? 10;
+        this._isTransient = options.isTransient ?? isTransientAlgodError;
+        this._txIdOf = options.txIdOf ?? defaultTxIdOf;
+        this._signGroup = options.signGroup ?? null;
+        this._preflight = options.preflight ?? null;
+        this._queue = [];
+        this._inFlight = 0;
+        this._idle = [];
+        this._counters = { submitted: 0, confirmed: 0, failed: 0, retries: 0 };
+        this._latency = { sign: [], send: [], confirm: [], total: [] };
+    }
+    /**
+     * Queue a group; resolves once it is confirmed
+     * @param job Signed group, signing callback, or transactions with accounts
+     * @returns Transaction ID, confirmed round, attempts and per-stage latency
+     */
+    submit(job) {
+        return new Promise((resolve, reject) => {
+            this._queue.push({ job, resolve, reject });
+            this._pump();
+        });
+    }
+    /**
+     * Queue many groups; resolves with each group's result or error, in order
+     */
+    submitAll(jobs) {
+        return Promise.allSettled(Array.from(jobs, (job) => this.submit(job)));
+    }
+    /**
+     * Wait until no group is queued or in flight
+     */
+    drain() {
+        if (this._inFlight === 0 && this._queue.length === 0)
+            return Promise.resolve();
+        return new Promise((resolve) => this._idle.push(resolve));
+    }
+    /**
+     * Counters and per-stage latency percentiles (over the last 1024 groups)
+     */
+    stats() {
+        return {
+            inFlight: this._inFlight,
+            queued: this._queue.length,
+            ...this._counters,
+            latency: {
+                sign: summarize(this._latency.sign),
+                send: summarize(this._latency.send),
+                confirm: summarize(this._latency.confirm),
+                total: summarize(this._latency.total),
+            },
+        };
+    }
+    /**
+     * Start queued jobs while fewer than `concurrency` are in flight
+     * @private
+     */
+    _pump() {
+        while (this._inFlight < this.concurrency && this._queue.length > 0) {
+            const { job, resolve, reject } = this._queue.shift();
+            this._inFlight++;
+            this._run(job).then((result) => {
+                this._counters.confirmed++;
+                resolve(result);
+            }, (error) => {
+                this._counters.failed++;
+                reject(error instanceof Error ? error : new Error(String(error)));
+            }).finally(() => {
+                this._inFlight--;
+                this._pump();
+                if (this._inFlight === 0 && this._queue.length === 0) {
+                    this._idle.splice(0).forEach((resolve) => resolve());
+                }
+            });
+        }
+    }
+    /**
+     * Sign, check, send (with retries) and confirm one group
+     * @private
+     */
+    async _run(job) {
+        const start = performance.now();
+        const signed = await this._sign(job);
+        if (this._preflight)
+            await this._preflight(signed);
+        const signedAt = performance.now();
+        const { txId, attempts } = await this._send(signed);
+        const sentAt = performance.now();
+        this._counters.submitted++;
+        const confirmation = await this.confirmations.waitForConfirmation(txId, this.maxRounds);
+        const confirmedAt = performance.now();
+        const latency = {
+            signMs: signedAt - start,
+            sendMs: sentAt - signedAt,
+            confirmMs: confirmedAt - sentAt,
+            totalMs: confirmedAt - start,
+        };
+        this._record('sign', latency.signMs);
+        this._record('send', latency.sendMs);
+        this._record('confirm', latency.confirmMs);
+        this._record('total', latency.totalMs);
+        return {
+            txId,
+            confirmedRound: getConfirmedRound(confirmation),
+            groupSize: signed.length,
+            attempts,
+            latency,
+        };
+    }
+    /**
+     * Produce the signed group of a job
+     * @private
+     */
+    async _sign(job) {
+        if ('signedTransactions' in job)
+            return job.signedTransactions;
+        if ('sign' in job)
+            return job.sign();
+        if (!this._signGroup) {
+            throw new Error('Jobs with transactions and accounts need the signGroup option');
+        }
+        return this._signGroup(job.transactions, job.accounts);
+    }
+    /**
+     * Send a signed group, retrying transient errors with jittered backoff
+     * @private
+     */
+    async _send(signed) {
+        for (let attempt = 1;; attempt++) {
+            try {
+                const response = await this.algod.sendRawTransaction(signed).do();
+                return { txId: response.txid, attempts: attempt };
+            }
+            catch (error) {
+                // An earlier attempt reached algod even though its response was lost
+                if (attempt > 1 && ALREADY_ACCEPTED.test(String(error?.message ?? ''))) {
+                    return { txId: this._txIdOf(signed), attempts: attempt };
+                }
+                if (attempt > this.maxRetries || !this._isTransient(error))
+                    throw error;
+                this._counters.retries++;
+                const delay = Math.min(this.maxDelayMs, this.baseDelayMs * 2 ** (attempt - 1));
+                await sleep(delay / 2 + Math.random() * (delay / 2));
+            }
+        }
+    }
+    /**
+     * Keep the most recent latency samples of a stage
+     * @private
+     */
+    _record(stage, ms) {
+        const samples = this._latency[stage];
+        samples.push(ms);
+        if (samples.length > LATENCY_WINDOW)
+            samples.shift();
+    }
+}
+export default SubmissionPipeline;
@@ -12,6 +12,28 @@ import algosdk, {
 import Falcon from 'falcon-signatures';
 import { Point } from '@noble/ed25519';
 import { base32 } from 'rfc4648';
+import { ConfirmationTracker } from './confirmation-tracker.js';
+import { LogicSigEvaluation, LogicSigEvaluator } from './lsig-evaluator.js';
+import { PreparedFalconAccount } from './prepared-account.js';
+import { SubmissionPipeline, SubmissionPipelineOptions, SubmissionResult } from './submission-pipeline.js';
+
+export { ConfirmationTracker } from './confirmation-tracker.js';
+export type { AlgodStatusClient, ConfirmationTrackerStats } from './confirmation-tracker.js';
+export { PreparedFalconAccount } from './prepared-account.js';
+export type { PreparableAccountInfo, PreparedSignedTx } from './prepared-account.js';
+export { LogicSigBlobTemplate, rawTxIDFromBytes } from './lsig-template.js';
+export { LogicSigEvaluator } from './lsig-evaluator.js';
+export type { LogicSigEvaluation, LogicSigEvaluatorStats } from './lsig-evaluator.js';
+export { SubmissionPipeline, isTransientAlgodError } from './submission-pipeline.js';
+export type {
+  AlgodSubmitClient,
+  LatencySummary,
+  StageLatency,
+  SubmissionJob,
+  SubmissionPipelineOptions,
+  SubmissionPipelineStats,
+  SubmissionResult,
+} from './submission-pipeline.js';
 
 /**
  * Network configurations
@@ -95,6 +117,55 @@ export type ConversionInfo = {
   type: 'converted-to-falcon';
 };
 
+export type BatchRotationOptions = {
+  /** Accounts whose new keys and LogicSig are prepared at once (default: 8) */
+  concurrency?: number;
+  /** Rekey transactions per atomic group, at most 16 (default: 16) */
+  groupSize?: number;
+  /** Keypair source, e.g. `() => pool.keypair()` for worker threads (default: this SDK's Falcon instance) */
+  keygen?: () => Promise<FalconKeyPair>;
+  /** Submit the rekey groups through a submission pipeline as they are signed (default: false) */
+  submit?: boolean | SubmissionPipelineOptions;
+  /** Called as each account's new keys and LogicSig are ready */
+  onProgress?: (done: number, total: number) => void;
+};
+
+export type RotatedAccountInfo = (FalconAccountInfo | ConversionInfo) & {
+  previousLogicSig: LogicSigInfo;
+  rotated: string;
+};
+
+export type BatchRotationResult = {
+  accounts: RotatedAccountInfo[];
+  groups: { txIds: string[]; signedTransactions: Uint8Array[] }[];
+  submissions: PromiseSettledResult<SubmissionResult>[] | null;
+  elapsedMs: number;
+  rotationsPerSecond: number;
+  /** Time spent in each stage, summed over accounts and groups (stages overlap) */
+  stageMs: { keygen: number; derive: number; sign: number };
+};
+
+/**
+ * Thrown by `rotateFalconKeysBatch` when an account fails partway through.
+ * Groups signed before the failure may already be submitted and confirm,
+ * rekeying their accounts, so `result` holds everything produced so far:
+ * `accounts` and `groups` are indexed like a full result, with gaps where
+ * nothing was prepared or signed. Keep the new keys of every signed group.
+ */
+export class BatchRotationError extends Error {
+  readonly result: BatchRotationResult;
+  /** The error of the account (or group) that failed */
+  readonly cause: unknown;
+
+  constructor(cause: unknown, result: BatchRotationResult) {
+    const message = cause instanceof Error ? cause.message : String(cause);
+    super(`Batch rotation failed with ${result.groups.filter(Boolean).length} of ${result.groups.length} groups signed: ${message}`);
+    this.name = 'BatchRotationError';
+    this.result = result;
+    this.cause = cause;
+  }
+}
+
 type SignedLogicSigTx = {
   txID: string;
   blob: Uint8Array;
@@ -146,6 +217,8 @@ export class FalconAlgoSDK {
   falcon: Falcon;
   initialized: boolean;
   private _initPromise: Promise<void>;
+  private _confirmations: ConfirmationTracker | null;
+  private _evaluator: LogicSigEvaluator | null;
 
   constructor(network: NetworkConfig = Networks.TESTNET, customAlgod: Algodv2 | null = null) {
     this.network = network;
@@ -153,6 +226,29 @@ export class FalconAlgoSDK {
     this.falcon = new Falcon();
     this.initialized = false;
     this._initPromise = this._initialize();
+    this._confirmations = null;
+    this._evaluator = null;
+  }
+
+  /**
+   * Shared confirmation tracker for the current algod client.
+   * All submissions wait through it, so status polling is shared across
+   * every in-flight transaction instead of repeated per transaction ID.
+   */
+  get confirmations(): ConfirmationTracker {
+    if (!this._confirmations || this._confirmations.algod !== this.algod) {
+      this._confirmations = new ConfirmationTracker(this.algod);
+    }
+    return this._confirmations;
+  }
+
+  /**
+   * Offline evaluator for Falcon LogicSig transactions, sharing this SDK's
+   * Falcon instance and its cache of decoded programs.
+   */
+  get logicSigEvaluator(): LogicSigEvaluator {
+    this._evaluator ??= new LogicSigEvaluator(this.falcon);
+    return this._evaluator;
   }
 
   /**
@@ -192,6 +288,31 @@ pushbytes 0x${Buffer.from(falconPublicKey).toString('hex')}
 falcon_verify`;
   }
 
+  /**
+   * Compile the TEAL program for counters 0..255 until its LogicSig address
+   * is off the Ed25519 curve
+   * @param falconPublicKey Falcon public key
+   * @returns Selected counter, compiled program and LogicSig address
+   * @private
+   */
+  private async _compileOffCurveProgram(
+    falconPublicKey: Uint8Array,
+  ): Promise<{ counter: number; programBytes: Uint8Array; address: string }> {
+    for (let counter = 0; counter < 256; counter++) {
+      const tealProgram = this._generateTealProgram(falconPublicKey, counter);
+      const compileResp = await this.algod.compile(tealProgram).do();
+      const addressBytes = algosdk.decodeAddress(compileResp.hash).publicKey;
+      if (!isOnCurve(addressBytes)) {
+        return {
+          counter,
+          programBytes: new Uint8Array(Buffer.from(compileResp.result, 'base64')),
+          address: compileResp.hash,
+        };
+      }
+    }
+    throw new Error('Failed to generate an off-curve LogicSig address');
+  }
+
   /**
    * Core Function 1: Create a new Falcon-protected Algorand account
    * @param options Options for account creation
@@ -217,26 +338,9 @@ falcon_verify`;
     }
 
     // 3-4. Create TEAL program and compile until off-curve address is found
-    let tealProgram: string | null = null;
-    let programBytes: Uint8Array | null = null;
-    let escrowAddress: string | null = null;
-    let edpCounter = 0;
-    for (let counter = 0; counter < 256; counter++) {
-      tealProgram = this._generateTealProgram(falconKeys.publicKey, counter);
-      const compileResp = await this.algod.compile(tealProgram).do();
-      programBytes = new Uint8Array(Buffer.from(compileResp.result, 'base64'));
-      const addressBytes = algosdk.decodeAddress(compileResp.hash).publicKey;
-      if (!isOnCurve(addressBytes)) {
-        console.log(`Selected counter: ${counter}`);
-        edpCounter = counter;
-        escrowAddress = compileResp.hash;
-        break;
-      }
-    }
-
-    if (!programBytes || !escrowAddress) {
-      throw new Error('Failed to generate an off-curve LogicSig address');
-    }
+    const { counter: edpCounter, programBytes, address: escrowAddress } =
+      await this._compileOffCurveProgram(falconKeys.publicKey);
+    console.log(`Selected counter: ${edpCounter}`);
 
     const messageToVerify = generateEdKeys && algoAccount
       ? Buffer.from(algoAccount.sk.slice(-32))
@@ -320,27 +424,9 @@ falcon_verify`;
     console.log(`Converting account: ${originalAddress}`);
 
     // 4-5. Create TEAL program and compile until off-curve address is found
-    let tealProgram: string | null = null;
-    let programBytes: Uint8Array | null = null;
-    let escrowAddress: string | null = null;
-    let edpCounter = 0;
-    for (let counter = 0; counter < 256; counter++) {
-      tealProgram = this._generateTealProgram(falconKeyPair.publicKey, counter);
-      const compileResp = await this.algod.compile(tealProgram).do();
-      programBytes = new Uint8Array(Buffer.from(compileResp.result, 'base64'));
-
-      const addressBytes = algosdk.decodeAddress(compileResp.hash).publicKey;
-      if (!isOnCurve(addressBytes)) {
-        console.log(`Selected counter: ${counter}`);
-        edpCounter = counter;
-        escrowAddress = compileResp.hash;
-        break;
-      }
-    }
-
-    if (!programBytes || !escrowAddress) {
-      throw new Error('Failed to generate an off-curve LogicSig address');
-    }
+    const { counter: edpCounter, programBytes, address: escrowAddress } =
+      await this._compileOffCurveProgram(falconKeyPair.publicKey);
+    console.log(`Selected counter: ${edpCounter}`);
 
     // 6. Generate Falcon signature of the account's ed25519 public key
     const falconSignature = await this.falcon.sign(ed25519PublicKey, falconKeyPair.secretKey);
@@ -412,7 +498,7 @@ falcon_verify`;
 
     if (waitForConfirmation) {
       console.log('Waiting for confirmation...');
-      const confirmation = await algosdk.waitForConfirmation(this.algod, txResponse.txid, 10);
+      const confirmation = await this.confirmations.waitForConfirmation(txResponse.txid, 10);
       const confirmedRound = getConfirmedRound(confirmation);
       console.log(`✅ Rekey confirmed in round: ${confirmedRound}`);
 
@@ -454,6 +540,19 @@ falcon_verify`;
     return new algosdk.LogicSigAccount(programBytes, [arg0]);
   }
 
+  /**
+   * Prepare a Falcon account for repeated signing.
+   *
+   * Decodes the program and Falcon keys and builds the LogicSig template once;
+   * the returned object's `sign(txn)` only handles per-transaction data.
+   * Applies the same off-curve guard as `createLogicSig`.
+   */
+  async prepareAccount(accountInfo: FalconAccountInfo | ConversionInfo): Promise<PreparedFalconAccount> {
+    await this._ensureInitialized();
+    assertLsigAddressOffCurve(accountInfo);
+    return new PreparedFalconAccount(this.falcon, accountInfo);
+  }
+
   /**
    * Sign a transaction with Falcon-protected account
    */
@@ -536,6 +635,154 @@ falcon_verify`;
     };
   }
 
+  /**
+   * Additional Function: Rotate the Falcon keys of many accounts in place
+   *
+   * Each account is rekeyed from its current LogicSig to one for a fresh Falcon
+   * keypair, so its address and funds stay where they are. Up to `concurrency`
+   * accounts generate keys and search for an off-curve LogicSig address at
+   * once; rekey transactions are grouped `groupSize` at a time and each group
+   * is signed (with the accounts' current keys) as soon as its accounts are
+   * ready. The returned account infos take effect once their group confirms.
+   *
+   * If an account fails, no further groups are signed; the call waits for
+   * groups already being signed or submitted and throws a
+   * `BatchRotationError` carrying their accounts, so no submitted rekey loses
+   * its new keys.
+   */
+  async rotateFalconKeysBatch(
+    accounts: (FalconAccountInfo | ConversionInfo)[],
+    options: BatchRotationOptions = {},
+  ): Promise<BatchRotationResult> {
+    await this._ensureInitialized();
+
+    const {
+      concurrency = 8,
+      groupSize = 16,
+      keygen = () => this.falcon.keypair(),
+      submit = false,
+      onProgress,
+    } = options;
+    if (!Number.isInteger(groupSize) || groupSize < 1 || groupSize > 16) {
+      throw new Error(`Invalid groupSize: ${groupSize}, expected 1 to 16`);
+    }
+    accounts.forEach(assertLsigAddressOffCurve);
+
+    const started = performance.now();
+    const stageMs = { keygen: 0, derive: 0, sign: 0 };
+    const params: SuggestedParams = await this.algod.getTransactionParams().do();
+    const pipeline = submit ? this.createSubmissionPipeline(submit === true ? {} : submit) : null;
+
+    const rotated: RotatedAccountInfo[] = new Array(accounts.length);
+    const groupCount = Math.ceil(accounts.length / groupSize);
+    const groups: BatchRotationResult['groups'] = new Array(groupCount);
+    const remaining = Array.from({ length: groupCount }, (_, g) => Math.min(groupSize, accounts.length - g * groupSize));
+    const signing: Promise<void>[] = [];
+    const submissions: Promise<SubmissionResult>[] = [];
+
+    const signGroup = async (g: number): Promise<void> => {
+      const start = g * groupSize;
+      const members = accounts.slice(start, start + groupSize);
+      const t0 = performance.now();
+      const transactions = members.map((account, i) => {
+        const sender = 'originalAddress' in account ? account.originalAddress : account.address;
+        return algosdk.makePaymentTxnWithSuggestedParamsFromObject({
+          sender,
+          receiver: sender,
+          amount: 0,
+          rekeyTo: rotated[start + i].logicSig.address,
+          suggestedParams: params,
+        });
+      });
+      const signedTransactions = await this.signTransactionGroup(transactions, members);
+      stageMs.sign += performance.now() - t0;
+
+      groups[g] = { txIds: transactions.map((txn) => txn.txID().toString()), signedTransactions };
+      if (pipeline) {
+        submissions[g] = pipeline.submit({ signedTransactions });
+        submissions[g].catch(() => {});
+      }
+    };
+
+    let done = 0;
+
+    // New keypair and off-curve LogicSig for one account
+    const prepare = async (i: number): Promise<void> => {
+      const account = accounts[i];
+      const t0 = performance.now();
+      const keys = await keygen();
+      const t1 = performance.now();
+      const { counter, programBytes, address } = await this._compileOffCurveProgram(keys.publicKey);
+
+      // Check the new keypair before any account is rekeyed to it
+      const message = Buffer.from(account.logicSig.verificationMessage, 'hex');
+      const signature = await this.falcon.sign(message, keys.secretKey);
+      if (!(await this.falcon.verify(message, signature, keys.publicKey))) {
+        throw new Error(`Failed to verify the new Falcon keys of ${address}`);
+      }
+      stageMs.keygen += t1 - t0;
+      stageMs.derive += performance.now() - t1;
+
+      rotated[i] = {
+        ...account,
+        ...('newAddress' in account ? { newAddress: address } : {}),
+        falconKeys: {
+          publicKey: Falcon.bytesToHex(keys.publicKey),
+          secretKey: Falcon.bytesToHex(keys.secretKey),
+        },
+        logicSig: {
+          counter,
+          program: Buffer.from(programBytes).toString('base64'),
+          address,
+          verificationMessage: account.logicSig.verificationMessage,
+        },
+        previousLogicSig: account.logicSig,
+        rotated: new Date().toISOString(),
+      };
+      onProgress?.(++done, accounts.length);
+
+      const g = Math.floor(i / groupSize);
+      if (--remaining[g] === 0 && !failed) {
+        const signed = signGroup(g);
+        signed.catch(() => {}); // observed below, even if another account fails first
+        signing.push(signed);
+      }
+    };
+
+    let next = 0;
+    let failed = false;
+    const worker = async (): Promise<void> => {
+      while (!failed && next < accounts.length) {
+        try {
+          await prepare(next++);
+        } catch (error) {
+          failed = true;
+          throw error;
+        }
+      }
+    };
+    // Wait for every worker and group even after a failure: a group that is
+    // already signed may be submitted and confirm
+    const outcomes = await Promise.allSettled(
+      Array.from({ length: Math.max(1, Math.min(concurrency, accounts.length)) }, worker),
+    );
+    outcomes.push(...(await Promise.allSettled(signing)));
+    const failure = outcomes.find((outcome): outcome is PromiseRejectedResult => outcome.status === 'rejected');
+
+    const settled = pipeline ? await Promise.allSettled(submissions) : null;
+    const elapsedMs = performance.now() - started;
+    const result: BatchRotationResult = {
+      accounts: rotated,
+      groups,
+      submissions: settled,
+      elapsedMs,
+      rotationsPerSecond: accounts.length / (elapsedMs / 1000),
+      stageMs,
+    };
+    if (failure) throw new BatchRotationError(failure.reason, result);
+    return result;
+  }
+
   /**
    * Additional Function: Create a multi-signature transaction group
    */
@@ -549,9 +796,16 @@ falcon_verify`;
 
     algosdk.assignGroupID(transactions);
 
+    // Prepare each distinct account once for the whole group
+    const prepared = new Map<FalconAccountInfo | ConversionInfo, PreparedFalconAccount>();
     const signedTxns: Uint8Array[] = [];
     for (let i = 0; i < transactions.length; i++) {
-      const signedTxn = await this.signTransaction(transactions[i], accountInfos[i], transactions[i].txID().toString());
+      let account = prepared.get(accountInfos[i]);
+      if (!account) {
+        account = await this.prepareAccount(accountInfos[i]);
+        prepared.set(accountInfos[i], account);
+      }
+      const signedTxn = await account.sign(transactions[i]);
       signedTxns.push(signedTxn.blob);
     }
 
@@ -570,7 +824,7 @@ falcon_verify`;
     const txResponse = await this.algod.sendRawTransaction(signedTransactions).do();
     console.log(`Group submitted with TxID: ${txResponse.txid}`);
 
-    const confirmation = await algosdk.waitForConfirmation(this.algod, txResponse.txid, maxRounds);
+    const confirmation = await this.confirmations.waitForConfirmation(txResponse.txid, maxRounds);
     const confirmedRound = getConfirmedRound(confirmation) ?? 0;
     console.log(`✅ Group confirmed in round: ${confirmedRound}`);
 
@@ -581,6 +835,31 @@ falcon_verify`;
     };
   }
 
+  /**
+   * Additional Function: Check signed transactions offline before submission
+   *
+   * Runs each Falcon LogicSig program against its transaction with the local
+   * Falcon verifier, in place of an algod dryrun/simulate round-trip. Results
+   * for programs outside the Falcon template are marked `unsupported`.
+   */
+  async evaluateLogicSigs(signedTransactions: Uint8Array[]): Promise<LogicSigEvaluation[]> {
+    await this._ensureInitialized();
+    return this.logicSigEvaluator.evaluate(signedTransactions);
+  }
+
+  /**
+   * Create a pipeline that keeps several groups in flight on this SDK's algod
+   * client and confirmation tracker, retrying transient send errors.
+   * `{ transactions, accounts }` jobs are signed with `signTransactionGroup`.
+   */
+  createSubmissionPipeline(options: SubmissionPipelineOptions = {}): SubmissionPipeline {
+    return new SubmissionPipeline(this.algod, {
+      confirmations: this.confirmations,
+      signGroup: (transactions, accounts) => this.signTransactionGroup(transactions, accounts),
+      ...options,
+    });
+  }
+
   /**
    * Additional Function: Estimate transaction fees for Falcon transactions
    */
@@ -0,0 +1,340 @@
+/**
+ * Offline LogicSig evaluation
+ * Runs Falcon LogicSig programs (the template of `_generateTealProgram`)
+ * against signed transactions with the local Falcon verifier, so failing
+ * transactions are caught before submission without an algod dryrun or
+ * simulate round-trip.
+ */
+
+import algosdk from 'algosdk';
+import Falcon from 'falcon-signatures';
+
+// Opcodes used by the Falcon LogicSig template
+const OP_BYTECBLOCK = 0x26;
+const OP_ARG = 0x2c;
+const OP_ARG_0 = 0x2d; // arg_0 .. arg_3 are 0x2d .. 0x30
+const OP_ARG_3 = 0x30;
+const OP_TXN = 0x31;
+const OP_PUSHBYTES = 0x80;
+const OP_FALCON_VERIFY = 0x85;
+const TXN_FIELD_TXID = 0x17;
+
+const FALCON_VERIFY_VERSION = 12;
+const FALCON_VERIFY_COST = 1700;
+const FALCON_PK_SIZE = 1793;
+const LOGICSIG_BUDGET = 20000;
+
+type Instruction =
+  | { op: 'arg'; index: number }
+  | { op: 'txid' }
+  | { op: 'push'; bytes: Uint8Array }
+  | { op: 'falcon_verify' };
+
+/**
+ * Decoded straight-line program, or why it cannot be evaluated offline
+ */
+type ParsedProgram = {
+  program: Uint8Array;
+  instructions: Instruction[];
+  cost: number;
+  address: string | null;
+  error?: string;
+  unsupported?: boolean;
+};
+
+export type LogicSigEvaluation = {
+  txID: string;
+  /** The program approved the transaction */
+  pass: boolean;
+  /** Why the transaction was rejected or could not be evaluated */
+  error?: string;
+  /** Not a Falcon template program (or not a LogicSig); check it with algod instead */
+  unsupported?: boolean;
+  /** Opcode cost of the program */
+  cost: number;
+};
+
+export type LogicSigEvaluatorStats = {
+  evaluated: number;
+  passed: number;
+  rejected: number;
+  unsupported: number;
+  programs: number;
+};
+
+type FalconCheck = { message: Uint8Array; signature: Uint8Array; publicKey: Uint8Array };
+
+// Value on the evaluation stack; falcon_verify leaves its deferred check
+type StackValue = Uint8Array | { verify: FalconCheck };
+
+/**
+ * Read an unsigned LEB128 varuint
+ */
+function readVarUint(program: Uint8Array, pc: number): { value: number; next: number } {
+  let value = 0;
+  for (let shift = 0; pc < program.length && shift < 35; shift += 7) {
+    const byte = program[pc++];
+    value += (byte & 0x7f) * 2 ** shift;
+    if ((byte & 0x80) === 0) return { value, next: pc };
+  }
+  throw new Error('Truncated varuint');
+}
+
+/**
+ * Decode a program into straight-line instructions. Only the opcodes of the
+ * Falcon template are understood; anything else marks the program unsupported.
+ */
+function parseProgram(program: Uint8Array): ParsedProgram {
+  const parsed: ParsedProgram = { program, instructions: [], cost: 0, address: null };
+  try {
+    const { value: version, next } = readVarUint(program, 0);
+    if (version < FALCON_VERIFY_VERSION) {
+      return { ...parsed, error: `falcon_verify needs program version ${FALCON_VERIFY_VERSION}, got ${version}` };
+    }
+
+    let pc = next;
+    while (pc < program.length) {
+      const opcode = program[pc++];
+      parsed.cost += opcode === OP_FALCON_VERIFY ? FALCON_VERIFY_COST : 1;
+
+      if (opcode === OP_BYTECBLOCK) {
+        // Constants are never referenced by the template (the counter only shifts the address)
+        const count = readVarUint(program, pc);
+        pc = count.next;
+        for (let i = 0; i < count.value; i++) {
+          const length = readVarUint(program, pc);
+          pc = length.next + length.value;
+        }
+      } else if (opcode === OP_ARG) {
+        parsed.instructions.push({ op: 'arg', index: program[pc++] });
+      } else if (opcode >= OP_ARG_0 && opcode <= OP_ARG_3) {
+        parsed.instructions.push({ op: 'arg', index: opcode - OP_ARG_0 });
+      } else if (opcode === OP_TXN && program[pc] === TXN_FIELD_TXID) {
+        parsed.instructions.push({ op: 'txid' });
+        pc++;
+      } else if (opcode === OP_PUSHBYTES) {
+        const length = readVarUint(program, pc);
+        pc = length.next + length.value;
+        parsed.instructions.push({ op: 'push', bytes: program.subarray(length.next, pc) });
+      } else if (opcode === OP_FALCON_VERIFY) {
+        parsed.instructions.push({ op: 'falcon_verify' });
+      } else {
+        const name = opcode === OP_TXN ? `txn field ${program[pc]}` : `opcode 0x${opcode.toString(16).padStart(2, '0')}`;
+        return { ...parsed, error: `Unsupported ${name} at pc ${pc - 1}`, unsupported: true };
+      }
+      if (pc > program.length) throw new Error('Truncated immediate');
+    }
+  } catch (error: any) {
+    return { ...parsed, error: `Malformed program: ${error.message}` };
+  }
+  if (parsed.cost > LOGICSIG_BUDGET) {
+    return { ...parsed, error: `Program cost ${parsed.cost} exceeds the LogicSig budget of ${LOGICSIG_BUDGET}` };
+  }
+  return parsed;
+}
+
+/**
+ * Evaluates Falcon LogicSig transactions offline.
+ *
+ * Programs are decoded once and cached. Each transaction's program is run up
+ * to its falcon_verify, and the signature checks of a whole call are done in
+ * one `Falcon.verifyBatch`. Programs outside the Falcon template are reported
+ * as `unsupported` rather than guessed at.
+ */
+export class LogicSigEvaluator {
+  readonly cacheSize: number;
+  private _falcon: Falcon;
+  private _programs: Map<string, ParsedProgram>;
+  private _stats: Omit<LogicSigEvaluatorStats, 'programs'>;
+
+  /**
+   * @param falcon Falcon instance used for verification
+   * @param options.cacheSize Decoded programs kept (default: 1024)
+   */
+  constructor(falcon: Falcon, options: { cacheSize?: number } = {}) {
+    this._falcon = falcon;
+    this.cacheSize = options.cacheSize ?? 1024;
+    this._programs = new Map();
+    this._stats = { evaluated: 0, passed: 0, rejected: 0, unsupported: 0 };
+  }
+
+  /**
+   * Run a program against its arguments and a raw 32-byte transaction ID,
+   * without the signed-transaction checks of `evaluate`
+   */
+  async evaluateProgram(program: Uint8Array, args: Uint8Array[], rawTxId: Uint8Array): Promise<Omit<LogicSigEvaluation, 'txID'>> {
+    const parsed = this._parse(program);
+    const run = this._run(parsed, args, rawTxId);
+    if ('error' in run) return run;
+    const [{ ok, error }] = await this._verifyBatch([run.check]);
+    return error ? { pass: false, error, cost: parsed.cost } : { pass: ok, ...(ok ? {} : { error: 'falcon_verify failed' }), cost: parsed.cost };
+  }
+
+  /**
+   * Evaluate signed transactions (e.g. a signed group)
+   * @param signedTransactions Encoded signed transactions
+   * @returns One result per transaction, in order
+   */
+  async evaluate(signedTransactions: Uint8Array[]): Promise<LogicSigEvaluation[]> {
+    const results: LogicSigEvaluation[] = new Array(signedTransactions.length);
+    const checks: FalconCheck[] = [];
+    const owners: number[] = [];
+
+    for (let i = 0; i < signedTransactions.length; i++) {
+      let stxn: any;
+      try {
+        stxn = algosdk.decodeSignedTransaction(signedTransactions[i]);
+      } catch (error: any) {
+        results[i] = { txID: '', pass: false, error: `Undecodable signed transaction: ${error.message}`, cost: 0 };
+        continue;
+      }
+      const txID = stxn.txn.txID();
+      const lsig = stxn.lsig;
+      if (!lsig) {
+        results[i] = { txID, pass: false, error: 'Not a LogicSig transaction', unsupported: true, cost: 0 };
+        continue;
+      }
+      if (lsig.sig || lsig.msig || lsig.lmsig) {
+        results[i] = { txID, pass: false, error: 'Delegated LogicSig', unsupported: true, cost: 0 };
+        continue;
+      }
+
+      const parsed = this._parse(lsig.logic);
+      if (!parsed.error) {
+        parsed.address ??= new algosdk.LogicSigAccount(parsed.program).address().toString();
+        const authorizer = (stxn.sgnr ?? stxn.txn.sender).toString();
+        if (authorizer !== parsed.address) {
+          results[i] = { txID, pass: false, error: `LogicSig ${parsed.address} is not the authorizer ${authorizer}`, cost: parsed.cost };
+          continue;
+        }
+      }
+      const run = this._run(parsed, lsig.args ?? [], stxn.txn.rawTxID());
+      if ('error' in run) {
+        results[i] = { txID, ...run };
+        continue;
+      }
+      checks.push(run.check);
+      owners.push(i);
+      results[i] = { txID, pass: false, cost: parsed.cost };
+    }
+
+    const verified = checks.length > 0 ? await this._verifyBatch(checks) : [];
+    verified.forEach(({ ok, error }, j) => {
+      const result = results[owners[j]];
+      result.pass = ok;
+      if (!ok) result.error = error ?? 'falcon_verify failed';
+    });
+
+    for (const result of results) {
+      this._stats.evaluated++;
+      if (result.pass) this._stats.passed++;
+      else if (result.unsupported) this._stats.unsupported++;
+      else this._stats.rejected++;
+    }
+    return results;
+  }
+
+  /**
+   * Evaluate signed transactions and throw if any would be rejected, e.g. as
+   * a `SubmissionPipeline` preflight. Unsupported transactions are let through.
+   */
+  async assertPass(signedTransactions: Uint8Array[]): Promise<void> {
+    const failures = (await this.evaluate(signedTransactions)).filter((r) => !r.pass && !r.unsupported);
+    if (failures.length > 0) {
+      throw new Error(`LogicSig rejected ${failures.map((r) => `${r.txID}: ${r.error}`).join('; ')}`);
+    }
+  }
+
+  /**
+   * Evaluation counters and cached programs
+   */
+  stats(): LogicSigEvaluatorStats {
+    return { ...this._stats, programs: this._programs.size };
+  }
+
+  /**
+   * Signature checks in one `Falcon.verifyBatch`, or one `verify` each with
+   * falcon-signatures releases before 1.5.0, which lack it
+   * @private
+   */
+  private async _verifyBatch(checks: FalconCheck[]): Promise<{ ok: boolean; error?: string }[]> {
+    if (typeof this._falcon.verifyBatch === 'function') return this._falcon.verifyBatch(checks);
+    return Promise.all(checks.map(async ({ message, signature, publicKey }) => {
+      try {
+        return { ok: await this._falcon.verify(message, signature, publicKey) };
+      } catch (error: any) {
+        return { ok: false, error: error.message };
+      }
+    }));
+  }
+
+  /**
+   * Decoded program from the cache, decoding it on a miss
+   * @private
+   */
+  private _parse(program: Uint8Array): ParsedProgram {
+    const key = Buffer.from(program.buffer, program.byteOffset, program.byteLength).toString('latin1');
+    let parsed = this._programs.get(key);
+    if (parsed) {
+      // Refresh LRU position
+      this._programs.delete(key);
+    } else {
+      parsed = parseProgram(program.slice());
+      if (this._programs.size >= this.cacheSize) {
+        this._programs.delete(this._programs.keys().next().value as string);
+      }
+    }
+    this._programs.set(key, parsed);
+    return parsed;
+  }
+
+  /**
+   * Execute a decoded program up to the signature check its result depends
+   * on, which is returned for batch verification instead of being run
+   * @private
+   */
+  private _run(
+    parsed: ParsedProgram,
+    args: Uint8Array[],
+    rawTxId: Uint8Array,
+  ): { check: FalconCheck } | { pass: false; error: string; unsupported?: boolean; cost: number } {
+    const fail = (error: string) => ({ pass: false as const, error, cost: parsed.cost });
+    if (parsed.error) return { ...fail(parsed.error), ...(parsed.unsupported ? { unsupported: true } : {}) };
+
+    const stack: StackValue[] = [];
+    for (const instruction of parsed.instructions) {
+      switch (instruction.op) {
+        case 'arg':
+          if (instruction.index >= args.length) return fail(`Missing LogicSig argument ${instruction.index}`);
+          stack.push(args[instruction.index]);
+          break;
+        case 'txid':
+          stack.push(rawTxId);
+          break;
+        case 'push':
+          stack.push(instruction.bytes);
+          break;
+        case 'falcon_verify': {
+          const [message, signature, publicKey] = stack.splice(-3);
+          if (!(message instanceof Uint8Array) || !(signature instanceof Uint8Array) || !(publicKey instanceof Uint8Array)) {
+            return fail('falcon_verify needs three byte arrays on the stack');
+          }
+          if (publicKey.length !== FALCON_PK_SIZE) {
+            return fail(`Invalid Falcon public key length: ${publicKey.length}, expected ${FALCON_PK_SIZE}`);
+          }
+          stack.push({ verify: { message, signature, publicKey } });
+          break;
+        }
+      }
+    }
+
+    // A LogicSig approves only if it ends with exactly one non-zero integer
+    const result = stack[0];
+    if (stack.length !== 1 || result instanceof Uint8Array) {
+      return fail(`Program must end with one integer on the stack, got ${stack.length} values`);
+    }
+    return { check: result.verify };
+  }
+}
+
+export default LogicSigEvaluator;
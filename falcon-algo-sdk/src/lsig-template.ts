@@ -0,0 +1,116 @@
+/**
+ * Pre-encoded LogicSig signed-transaction skeletons
+ * Splices a Falcon signature and encoded transaction into the constant
+ * msgpack encoding of an account's LogicSig, producing the same bytes as
+ * `algosdk.signLogicSigTransactionObject` without re-encoding the program.
+ */
+
+import { createHash } from 'crypto';
+
+const encoder = new TextEncoder();
+
+/**
+ * msgpack fixstr for a short map key
+ */
+function msgpackKey(key: string): Uint8Array {
+  const bytes = encoder.encode(key);
+  return Uint8Array.of(0xa0 | bytes.length, ...bytes);
+}
+
+/**
+ * Smallest msgpack bin header (bin8/bin16/bin32) for a payload length,
+ * matching the canonical encoding used by algosdk
+ */
+function msgpackBinHeader(length: number): Uint8Array {
+  if (length < 0x100) return Uint8Array.of(0xc4, length);
+  if (length < 0x10000) return Uint8Array.of(0xc5, length >>> 8, length & 0xff);
+  return Uint8Array.of(0xc6, length >>> 24, (length >>> 16) & 0xff, (length >>> 8) & 0xff, length & 0xff);
+}
+
+function concatBytes(parts: Uint8Array[]): Uint8Array {
+  const out = new Uint8Array(parts.reduce((n, p) => n + p.length, 0));
+  let offset = 0;
+  for (const part of parts) {
+    out.set(part, offset);
+    offset += part.length;
+  }
+  return out;
+}
+
+/**
+ * Transaction ID of an encoded transaction: SHA-512/256 over "TX" || txn
+ */
+export function rawTxIDFromBytes(txnBytes: Uint8Array): Uint8Array {
+  return new Uint8Array(createHash('sha512-256').update('TX').update(txnBytes).digest());
+}
+
+/**
+ * Canonical msgpack layout of a signed LogicSig transaction (keys sorted):
+ *
+ *   map{ "lsig": map{ "arg": [bin sig], "l": bin program },
+ *        ["sgnr": bin 32 address,]      // only when the sender is rekeyed
+ *        "txn": <encoded transaction> }
+ *
+ * Everything except the signature, the transaction and the outer map size is
+ * constant per account and encoded once here.
+ */
+export class LogicSigBlobTemplate {
+  readonly program: Uint8Array;
+  private _lsigHead: Uint8Array;
+  private _programTail: Uint8Array;
+  private _sgnr: Uint8Array;
+  private _txnKey: Uint8Array;
+
+  /**
+   * @param program Compiled LogicSig program
+   * @param lsigPublicKey 32-byte public key of the LogicSig address
+   */
+  constructor(program: Uint8Array, lsigPublicKey: Uint8Array) {
+    if (lsigPublicKey.length !== 32) {
+      throw new Error(`LogicSig address must be 32 bytes, got ${lsigPublicKey.length}`);
+    }
+    this.program = program;
+    this._lsigHead = concatBytes([msgpackKey('lsig'), Uint8Array.of(0x82), msgpackKey('arg'), Uint8Array.of(0x91)]);
+    this._programTail = concatBytes([msgpackKey('l'), msgpackBinHeader(program.length), program]);
+    this._sgnr = concatBytes([msgpackKey('sgnr'), msgpackBinHeader(32), lsigPublicKey]);
+    this._txnKey = msgpackKey('txn');
+  }
+
+  /**
+   * Assemble a signed transaction blob
+   * @param signature Falcon signature (LogicSig arg 0)
+   * @param txnBytes msgpack-encoded transaction (`txn.toByte()`)
+   * @param rekeyed Whether the sender differs from the LogicSig address
+   * @returns Signed transaction bytes, ready for sendRawTransaction
+   */
+  encode(signature: Uint8Array, txnBytes: Uint8Array, rekeyed: boolean): Uint8Array {
+    const sigHeader = msgpackBinHeader(signature.length);
+    const size = 1 + this._lsigHead.length + sigHeader.length + signature.length +
+      this._programTail.length + (rekeyed ? this._sgnr.length : 0) +
+      this._txnKey.length + txnBytes.length;
+
+    // Single exact-size allocation; the program bytes are copied, never re-encoded
+    const out = new Uint8Array(size);
+    let offset = 0;
+    out[offset++] = rekeyed ? 0x83 : 0x82;
+    out.set(this._lsigHead, offset);
+    offset += this._lsigHead.length;
+    out.set(sigHeader, offset);
+    offset += sigHeader.length;
+    out.set(signature, offset);
+    offset += signature.length;
+    out.set(this._programTail, offset);
+    offset += this._programTail.length;
+    if (rekeyed) {
+      out.set(this._sgnr, offset);
+      offset += this._sgnr.length;
+    }
+    out.set(this._txnKey, offset);
+    offset += this._txnKey.length;
+    out.set(txnBytes, offset);
+
+    return out;
+  }
+}
+
+export default LogicSigBlobTemplate;
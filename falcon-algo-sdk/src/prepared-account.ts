@@ -0,0 +1,93 @@
+/**
+ * Prepared Falcon accounts
+ * Decodes an account's keys and LogicSig program once so that signing a
+ * transaction only handles per-transaction data.
+ */
+
+import algosdk, { Address, LogicSigAccount, Transaction } from 'algosdk';
+import Falcon from 'falcon-signatures';
+import { base32 } from 'rfc4648';
+import { LogicSigBlobTemplate, rawTxIDFromBytes } from './lsig-template.js';
+
+export type PreparableAccountInfo = {
+  falconKeys: { publicKey: string; secretKey?: string };
+  logicSig: { program: string; address: string };
+};
+
+export type PreparedSignedTx = {
+  txID: string;
+  blob: Uint8Array;
+};
+
+/**
+ * Falcon account with decoded program, LogicSig template and keys.
+ * Create it with `FalconAlgoSDK.prepareAccount()`.
+ */
+export class PreparedFalconAccount {
+  readonly address: string;
+  readonly program: Uint8Array;
+  readonly publicKey: Uint8Array;
+  readonly lsig: LogicSigAccount;
+  readonly template: LogicSigBlobTemplate;
+  private _lsigAddress: Address;
+  private _secretKey: Uint8Array | null;
+  private _falcon: Falcon;
+
+  constructor(falcon: Falcon, accountInfo: PreparableAccountInfo) {
+    this._falcon = falcon;
+    this.program = new Uint8Array(Buffer.from(accountInfo.logicSig.program, 'base64'));
+    this.publicKey = Falcon.hexToBytes(accountInfo.falconKeys.publicKey);
+    this._secretKey = accountInfo.falconKeys.secretKey
+      ? Falcon.hexToBytes(accountInfo.falconKeys.secretKey)
+      : null;
+
+    // Template without arguments: fixes the program and its address once
+    this.lsig = new algosdk.LogicSigAccount(this.program);
+    this._lsigAddress = this.lsig.address();
+    this.address = this._lsigAddress.toString();
+
+    if (this.address !== accountInfo.logicSig.address) {
+      throw new Error(
+        `LogicSig program hashes to ${this.address}, expected ${accountInfo.logicSig.address}`,
+      );
+    }
+
+    this.template = new LogicSigBlobTemplate(this.program, this._lsigAddress.publicKey);
+  }
+
+  /**
+   * Whether the account holds a secret key and can sign
+   */
+  get canSign(): boolean {
+    return this._secretKey !== null;
+  }
+
+  /**
+   * Falcon signature over a raw 32-byte transaction ID (LogicSig arg 0)
+   */
+  async signTxID(rawTxId: Uint8Array): Promise<Uint8Array> {
+    if (!this._secretKey) {
+      throw new Error(`Prepared account ${this.address} has no Falcon secret key`);
+    }
+    return this._falcon.sign(rawTxId, this._secretKey);
+  }
+
+  /**
+   * Sign a transaction; output matches `algosdk.signLogicSigTransactionObject`
+   * for the LogicSig built by `FalconAlgoSDK.createLogicSig`.
+   * The transaction is encoded once and spliced into the account's template.
+   */
+  async sign(transaction: Transaction): Promise<PreparedSignedTx> {
+    const txnBytes = transaction.toByte();
+    const rawTxId = rawTxIDFromBytes(txnBytes);
+    const arg0 = await this.signTxID(rawTxId);
+    const rekeyed = !transaction.sender.equals(this._lsigAddress);
+
+    return {
+      txID: base32.stringify(rawTxId, { pad: false }),
+      blob: this.template.encode(arg0, txnBytes, rekeyed),
+    };
+  }
+}
+
+export default PreparedFalconAccount;
@@ -0,0 +1,189 @@
+#!/usr/bin/env node
+/**
+ * SDK benchmark against a local mock algod
+ *
+ * Runs the SDK's network flows end to end (algosdk.Algodv2 over HTTP) against
+ * `MockAlgodServer`, so throughput and latency are reproducible and do not
+ * depend on a live network or a funded account.
+ *
+ * Usage: node test/bench.js [flow ...] [--count N] [--concurrency N]
+ *          [--group-size N] [mock algod options]
+ *
+ * Flows:
+ *   accounts     createFalconAccount (Falcon keygen and compile until the
+ *                LogicSig address is off-curve)
+ *   conversion   convertToFalconAccount and submitConversion (rekey sent and
+ *                confirmed)
+ *   payments     createPayment and submitTransactionGroup, --concurrency
+ *                payments at a time
+ *   groups       SubmissionPipeline of --group-size payment groups, signed,
+ *                sent and confirmed with up to --concurrency in flight
+ *
+ * Mock algod options (see test/mock-algod-server.js):
+ *   --round-ms MS               Block interval (default 0: a round per wait)
+ *   --latency ENDPOINT=DIST     e.g. send=lognormal:20:0.5, all=fixed:2
+ *   --error-rate ENDPOINT=P     e.g. send=0.05 (answers 503)
+ *   --confirm-rounds N, --seed N
+ */
+import algosdk from 'algosdk';
+import { performance } from 'perf_hooks';
+import FalconAlgoSDK, { Networks } from '../dist/index.js';
+import { MockAlgodServer, parseServerArgs } from './mock-algod-server.js';
+
+// The SDK reports every step on the console, which would swamp the results
+const log = console.log;
+
+/**
+ * Latency summary of millisecond samples
+ */
+function summarize(samples) {
+  const sorted = Float64Array.from(samples).sort();
+  const at = (p) => sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))] ?? 0;
+  return { mean: sorted.reduce((a, b) => a + b, 0) / (sorted.length || 1), p50: at(0.5), p95: at(0.95), max: at(1) };
+}
+
+/**
+ * Run `count` operations with up to `concurrency` at a time
+ * @returns {Promise<Object>} { ok, failed, firstError, wallMs, latency, calls (algod requests made) }
+ */
+async function runFlow(server, count, concurrency, operation) {
+  const callsBefore = server.stats().calls;
+  const latency = [];
+  let next = 0;
+  let failed = 0;
+  let firstError = null;
+  const start = performance.now();
+  const lane = async () => {
+    while (next < count) {
+      const index = next++;
+      const started = performance.now();
+      try {
+        await operation(index);
+        latency.push(performance.now() - started);
+      } catch (error) {
+        failed++;
+        firstError ??= error;
+      }
+    }
+  };
+  console.log = () => {};
+  try {
+    await Promise.all(Array.from({ length: Math.max(1, Math.min(concurrency, count)) }, lane));
+  } finally {
+    console.log = log;
+  }
+  const calls = Object.fromEntries(Object.entries(server.stats().calls).map(([endpoint, n]) => [endpoint, n - callsBefore[endpoint]]));
+  return { ok: latency.length, failed, firstError, wallMs: performance.now() - start, latency: summarize(latency), calls };
+}
+
+/**
+ * Print a flow result with the algod requests it made per operation
+ */
+function report(name, result) {
+  const perOp = Object.entries(result.calls)
+    .map(([endpoint, n]) => [endpoint, n / Math.max(1, result.ok + result.failed)])
+    .filter(([, n]) => n > 0)
+    .map(([endpoint, n]) => `${endpoint} ${n.toFixed(1)}`)
+    .join(', ');
+  const { latency } = result;
+  log(`  ${name.padEnd(12)} ${(result.ok / (result.wallMs / 1000)).toFixed(1).padStart(8)} ops/s` +
+    `  p50 ${latency.p50.toFixed(1)} ms  p95 ${latency.p95.toFixed(1)} ms  max ${latency.max.toFixed(1)} ms` +
+    `  (${result.ok} ok, ${result.failed} failed)`);
+  log(`  ${''.padEnd(12)} algod requests per operation: ${perOp || 'none'}`);
+  if (result.firstError) log(`  ${''.padEnd(12)} first error: ${result.firstError.message}`);
+}
+
+/**
+ * Falcon accounts to pay from (not timed)
+ */
+async function fundedAccounts(sdk, count) {
+  console.log = () => {};
+  try {
+    const accounts = [];
+    for (let i = 0; i < count; i++) accounts.push(await sdk.createFalconAccount({ generateEdKeys: false }));
+    return accounts;
+  } finally {
+    console.log = log;
+  }
+}
+
+const FLOWS = {
+  async accounts({ sdk, server, count, concurrency }) {
+    return runFlow(server, count, concurrency, () => sdk.createFalconAccount({ generateEdKeys: false }));
+  },
+
+  async conversion({ sdk, server, count, concurrency }) {
+    return runFlow(server, count, concurrency, async () => {
+      const conversion = await sdk.convertToFalconAccount(algosdk.generateAccount());
+      await sdk.submitConversion(conversion);
+    });
+  },
+
+  async payments({ sdk, server, count, concurrency }) {
+    const [sender] = await fundedAccounts(sdk, 1);
+    return runFlow(server, count, concurrency, async (index) => {
+      const signed = await sdk.createPayment(
+        { sender: sender.address, receiver: sender.address, amount: 0, note: `payment ${index}` },
+        sender,
+      );
+      await sdk.submitTransactionGroup([signed.blob]);
+    });
+  },
+
+  async groups({ sdk, server, count, concurrency, groupSize }) {
+    const senders = await fundedAccounts(sdk, Math.min(groupSize, 4));
+    const params = await sdk.algod.getTransactionParams().do();
+    const pipeline = sdk.createSubmissionPipeline({ concurrency, baseDelayMs: 10 });
+    const result = await runFlow(server, count, count, async (index) => {
+      const accounts = Array.from({ length: groupSize }, (_, i) => senders[i % senders.length]);
+      const transactions = accounts.map((account, i) => algosdk.makePaymentTxnWithSuggestedParamsFromObject({
+        sender: account.address,
+        receiver: account.address,
+        amount: 0,
+        note: new TextEncoder().encode(`group ${index} payment ${i}`),
+        suggestedParams: params,
+      }));
+      await pipeline.submit({ transactions, accounts });
+    });
+    const stats = pipeline.stats();
+    log(`  ${''.padEnd(12)} pipeline p50 sign ${stats.latency.sign.p50.toFixed(1)} ms, send ${stats.latency.send.p50.toFixed(1)} ms,` +
+      ` confirm ${stats.latency.confirm.p50.toFixed(1)} ms; ${stats.retries} retries`);
+    return result;
+  },
+};
+
+async function main() {
+  const options = { count: 20, concurrency: 8, groupSize: 4, roundMs: 0 };
+  const names = [];
+  const args = parseServerArgs(process.argv.slice(2), options);
+  for (let i = 0; i < args.length; i++) {
+    if (args[i] === '--count') options.count = parseInt(args[++i], 10);
+    else if (args[i] === '--concurrency') options.concurrency = parseInt(args[++i], 10);
+    else if (args[i] === '--group-size') options.groupSize = parseInt(args[++i], 10);
+    else names.push(args[i]);
+  }
+
+  const { count, concurrency, groupSize, ...serverOptions } = options;
+  const server = new MockAlgodServer(serverOptions);
+  const { server: host, port, token } = await server.listen();
+  try {
+    const sdk = new FalconAlgoSDK(Networks.TESTNET, new algosdk.Algodv2(token, host, port));
+    await sdk._ensureInitialized();
+    log(`🏁 SDK flows against mock algod on port ${port}: ${count} operations, concurrency ${concurrency}` +
+      `${serverOptions.roundMs ? `, ${serverOptions.roundMs} ms rounds` : ''}`);
+
+    for (const name of names.length ? names : Object.keys(FLOWS)) {
+      const flow = FLOWS[name];
+      if (!flow) throw new Error(`Unknown flow: ${name} (available: ${Object.keys(FLOWS).join(', ')})`);
+      report(name, await flow({ sdk, server, count, concurrency, groupSize }));
+    }
+  } finally {
+    await server.close();
+  }
+}
+
+main().catch((error) => {
+  console.log = log;
+  console.error('❌ Benchmark failed:', error);
+  process.exit(1);
+});
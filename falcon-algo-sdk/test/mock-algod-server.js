@@ -0,0 +1,572 @@
+#!/usr/bin/env node
+/**
+ * Mock algod HTTP server for reproducible SDK benchmarks.
+ *
+ * Serves the algod v2 REST endpoints the SDK uses, so an unmodified
+ * `algosdk.Algodv2` client can talk to it:
+ *
+ *   POST /v2/teal/compile                      (Falcon LogicSig template only)
+ *   GET  /v2/transactions/params
+ *   POST /v2/transactions
+ *   GET  /v2/status
+ *   GET  /v2/status/wait-for-block-after/{round}
+ *   GET  /v2/transactions/pending/{txid}       (msgpack or JSON)
+ *
+ * Each endpoint can be given a latency distribution and a random error rate
+ * (both drawn from a seeded generator, so runs repeat), and failures can be
+ * queued with `injectFailures`. Rounds advance every `roundMs` milliseconds,
+ * or, with `roundMs: 0`, whenever a client waits for the next block (as in
+ * the in-process `MockAlgod`). Submitted transactions confirm
+ * `confirmRounds` rounds after submission.
+ *
+ * Usage: node test/mock-algod-server.js [--port 4001] [--round-ms 2800]
+ *          [--latency send=lognormal:20:0.5] [--error-rate send=0.05]
+ */
+import http from 'http';
+import { createHash } from 'crypto';
+import { pathToFileURL } from 'url';
+
+const ENDPOINTS = ['compile', 'params', 'send', 'status', 'pending'];
+
+const STATUS_TEXT = { 400: 'Bad Request', 404: 'Not Found', 429: 'Too Many Requests', 500: 'Internal Server Error', 503: 'Service Unavailable' };
+
+const BASE32 = 'ABCDEFGHIJKLMNOPQRSTUVWXYZ234567';
+
+const sleep = (ms) => (ms > 0 ? new Promise((resolve) => setTimeout(resolve, ms)) : Promise.resolve());
+
+const sha512_256 = (...parts) => {
+  const hash = createHash('sha512-256');
+  for (const part of parts) hash.update(part);
+  return new Uint8Array(hash.digest());
+};
+
+/**
+ * RFC 4648 base32 without padding (Algorand addresses and transaction IDs)
+ */
+function base32(bytes) {
+  let out = '';
+  let bits = 0;
+  let value = 0;
+  for (const byte of bytes) {
+    value = (value << 8) | byte;
+    bits += 8;
+    while (bits >= 5) {
+      out += BASE32[(value >>> (bits - 5)) & 31];
+      bits -= 5;
+    }
+  }
+  if (bits > 0) out += BASE32[(value << (5 - bits)) & 31];
+  return out;
+}
+
+/**
+ * Algorand address of a 32-byte public key: the key and a 4-byte checksum
+ */
+const encodeAddress = (publicKey) => base32([...publicKey, ...sha512_256(publicKey).subarray(28)]);
+
+/**
+ * mulberry32: small seeded generator, so latency and error draws repeat
+ */
+function seededRandom(seed) {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+/**
+ * Parse a latency distribution written as `fixed:MS`, `uniform:MIN:MAX`,
+ * `normal:MEAN:STDDEV`, `lognormal:MEDIAN:SIGMA` or `exponential:MEAN`
+ * (a bare number is fixed)
+ * @param {string} text - Distribution
+ * @returns {Object} Distribution for the `latency` option
+ */
+export function parseLatency(text) {
+  const [dist, ...params] = String(text).split(':');
+  if (params.length === 0 && Number.isFinite(Number(dist))) return { dist: 'fixed', ms: Number(dist) };
+  const [a, b] = params.map(Number);
+  switch (dist) {
+    case 'fixed': return { dist, ms: a };
+    case 'uniform': return { dist, min: a, max: b };
+    case 'normal': return { dist, mean: a, stddev: b };
+    case 'lognormal': return { dist, median: a, sigma: b };
+    case 'exponential': return { dist, mean: a };
+    default: throw new Error(`Unknown latency distribution: ${text}`);
+  }
+}
+
+/**
+ * Draw one latency in milliseconds (never negative)
+ * @param {number|Object} spec - Fixed milliseconds or a distribution (see parseLatency)
+ * @param {Function} random - Uniform generator on [0, 1)
+ * @returns {number} Milliseconds
+ */
+function sampleLatency(spec, random) {
+  if (typeof spec === 'number') return spec;
+  const gaussian = () => Math.sqrt(-2 * Math.log(1 - random())) * Math.cos(2 * Math.PI * random());
+  let ms;
+  switch (spec.dist) {
+    case 'fixed': ms = spec.ms; break;
+    case 'uniform': ms = spec.min + (spec.max - spec.min) * random(); break;
+    case 'normal': ms = spec.mean + spec.stddev * gaussian(); break;
+    case 'lognormal': ms = spec.median * Math.exp(spec.sigma * gaussian()); break;
+    case 'exponential': ms = -spec.mean * Math.log(1 - random()); break;
+    default: throw new Error(`Unknown latency distribution: ${spec.dist}`);
+  }
+  return Math.max(0, ms);
+}
+
+/**
+ * Offset just past the msgpack value starting at `pos`
+ */
+function skipMsgpack(bytes, pos) {
+  const type = bytes[pos++];
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const skipItems = (count, start) => {
+    let at = start;
+    for (let i = 0; i < count; i++) at = skipMsgpack(bytes, at);
+    return at;
+  };
+  if (type === undefined) throw new Error('Truncated msgpack');
+  if (type <= 0x7f || type >= 0xe0 || (type >= 0xc0 && type <= 0xc3)) return pos;
+  if (type <= 0x8f) return skipItems(2 * (type & 0x0f), pos);
+  if (type <= 0x9f) return skipItems(type & 0x0f, pos);
+  if (type <= 0xbf) return pos + (type & 0x1f);
+  switch (type) {
+    case 0xc4: case 0xd9: return pos + 1 + bytes[pos];
+    case 0xc5: case 0xda: return pos + 2 + view.getUint16(pos);
+    case 0xc6: case 0xdb: return pos + 4 + view.getUint32(pos);
+    case 0xc7: return pos + 2 + bytes[pos];
+    case 0xc8: return pos + 3 + view.getUint16(pos);
+    case 0xc9: return pos + 5 + view.getUint32(pos);
+    case 0xca: return pos + 4;
+    case 0xcb: return pos + 8;
+    case 0xcc: case 0xd0: return pos + 1;
+    case 0xcd: case 0xd1: return pos + 2;
+    case 0xce: case 0xd2: return pos + 4;
+    case 0xcf: case 0xd3: return pos + 8;
+    case 0xd4: case 0xd5: case 0xd6: case 0xd7: case 0xd8: return pos + 1 + (1 << (type - 0xd4));
+    case 0xdc: return skipItems(view.getUint16(pos), pos + 2);
+    case 0xdd: return skipItems(view.getUint32(pos), pos + 4);
+    case 0xde: return skipItems(2 * view.getUint16(pos), pos + 2);
+    case 0xdf: return skipItems(2 * view.getUint32(pos), pos + 4);
+    default: throw new Error(`Unsupported msgpack type 0x${type.toString(16)}`);
+  }
+}
+
+/**
+ * Split the body of a transaction submission (concatenated signed
+ * transactions) and locate each transaction's `txn` field
+ * @param {Uint8Array} body - Request body
+ * @returns {Array<Object>} { signed, txId } per transaction
+ */
+export function parseSignedTransactions(body) {
+  const transactions = [];
+  let pos = 0;
+  while (pos < body.length) {
+    const start = pos;
+    const type = body[pos];
+    let fields;
+    if (type >= 0x80 && type <= 0x8f) {
+      fields = type & 0x0f;
+      pos += 1;
+    } else if (type === 0xde) {
+      fields = (body[pos + 1] << 8) | body[pos + 2];
+      pos += 3;
+    } else {
+      throw new Error(`Signed transaction ${transactions.length} is not a msgpack map`);
+    }
+    let txn = null;
+    for (let i = 0; i < fields; i++) {
+      const keyEnd = skipMsgpack(body, pos);
+      const key = Buffer.from(body.subarray(pos + 1, keyEnd)).toString('latin1');
+      const valueEnd = skipMsgpack(body, keyEnd);
+      if (key === 'txn') txn = body.subarray(keyEnd, valueEnd);
+      pos = valueEnd;
+    }
+    if (pos > body.length) throw new Error('Truncated signed transaction');
+    if (!txn) throw new Error(`Signed transaction ${transactions.length} has no txn field`);
+    transactions.push({ signed: body.subarray(start, pos), txId: base32(sha512_256('TX', txn)) });
+  }
+  if (transactions.length === 0) throw new Error('Empty transaction group');
+  return transactions;
+}
+
+/**
+ * Assemble the Falcon LogicSig template of `FalconAlgoSDK._generateTealProgram`
+ * (anything else is rejected like an algod assembler error)
+ * @param {string} source - TEAL source
+ * @returns {Uint8Array} Program bytes
+ */
+export function assembleFalconTemplate(source) {
+  const out = [];
+  const varuint = (value) => {
+    for (; value >= 0x80; value = Math.floor(value / 0x80)) out.push((value & 0x7f) | 0x80);
+    out.push(value);
+  };
+  const hexBytes = (text) => {
+    if (!/^0x([0-9a-fA-F]{2})*$/.test(text)) throw new Error(`Invalid byte constant: ${text}`);
+    return Buffer.from(text.slice(2), 'hex');
+  };
+  source.split('\n').forEach((raw, index) => {
+    const [op, ...args] = raw.replace(/\/\/.*$/, '').trim().split(/\s+/);
+    if (!op) return;
+    if (op === '#pragma' && args[0] === 'version') {
+      if (out.length > 0) throw new Error(`${index + 1}: #pragma version must come first`);
+      varuint(Number(args[1]));
+    } else if (op === 'bytecblock') {
+      out.push(0x26);
+      varuint(args.length);
+      for (const arg of args) {
+        const bytes = hexBytes(arg);
+        varuint(bytes.length);
+        out.push(...bytes);
+      }
+    } else if (op === 'txn' && args[0] === 'TxID') {
+      out.push(0x31, 0x17);
+    } else if (op === 'arg' && /^[0-3]$/.test(args[0])) {
+      out.push(0x2d + Number(args[0]));
+    } else if (op === 'pushbytes') {
+      const bytes = hexBytes(args[0]);
+      out.push(0x80);
+      varuint(bytes.length);
+      out.push(...bytes);
+    } else if (op === 'falcon_verify') {
+      out.push(0x85);
+    } else {
+      throw new Error(`${index + 1}: unsupported in mock assembler: ${raw.trim()}`);
+    }
+  });
+  if (out.length === 0) throw new Error('Empty program');
+  return Uint8Array.from(out);
+}
+
+/**
+ * msgpack pending-transaction response; the submitted signed transaction is
+ * spliced in as is
+ */
+function encodePendingMsgpack(tx, confirmed) {
+  const str = (text) => {
+    const bytes = Buffer.from(text);
+    if (bytes.length < 32) return Buffer.concat([Buffer.of(0xa0 | bytes.length), bytes]);
+    return Buffer.concat([Buffer.of(0xd9, bytes.length), bytes]);
+  };
+  const round = Buffer.alloc(9);
+  round[0] = 0xcf;
+  round.writeBigUInt64BE(BigInt(tx.confirmRound ?? 0), 1);
+  return Buffer.concat([
+    Buffer.of(confirmed ? 0x83 : 0x82),
+    ...(confirmed ? [str('confirmed-round'), round] : []),
+    str('pool-error'), str(tx.poolError),
+    str('txn'), tx.signed,
+  ]);
+}
+
+function httpError(status, message) {
+  const error = new Error(message);
+  error.status = status;
+  return error;
+}
+
+export class MockAlgodServer {
+  /**
+   * @param {Object} options - Server options
+   * @param {number} options.port - Port to listen on (default: 0, any free port)
+   * @param {string} options.host - Interface to listen on (default: 127.0.0.1)
+   * @param {number} options.startRound - First round (default: 1000)
+   * @param {number} options.roundMs - Block interval; 0 advances a round per wait-for-block (default: 0)
+   * @param {number} options.confirmRounds - Rounds from submission to confirmation (default: 1)
+   * @param {Object} options.latency - Per endpoint (compile, params, send, status, pending):
+   *   fixed milliseconds or a distribution, e.g. { send: { dist: 'lognormal', median: 20, sigma: 0.5 } }
+   * @param {Object} options.errorRate - Per endpoint probability of answering 503
+   * @param {number} options.seed - Seed of the latency and error draws (default: 1)
+   */
+  constructor({ port = 0, host = '127.0.0.1', startRound = 1000, roundMs = 0, confirmRounds = 1,
+    latency = {}, errorRate = {}, seed = 1 } = {}) {
+    this.port = port;
+    this.host = host;
+    this.round = startRound;
+    this.roundMs = roundMs;
+    this.confirmRounds = confirmRounds;
+    this.latency = { ...Object.fromEntries(ENDPOINTS.map((e) => [e, 0])), ...latency };
+    this.errorRate = { ...Object.fromEntries(ENDPOINTS.map((e) => [e, 0])), ...errorRate };
+    this.transactions = new Map();
+    this.calls = Object.fromEntries(ENDPOINTS.map((e) => [e, 0]));
+    this.errors = Object.fromEntries(ENDPOINTS.map((e) => [e, 0]));
+    this._random = seededRandom(seed);
+    this._failures = Object.fromEntries(ENDPOINTS.map((e) => [e, []]));
+    this._roundWaiters = [];
+    this._timer = null;
+    this._server = null;
+    this._sockets = new Set();
+  }
+
+  /**
+   * Start listening
+   * @returns {Promise<Object>} { url, server, port, token } (the
+   *   `algosdk.Algodv2(token, server, port)` arguments)
+   */
+  async listen() {
+    this._server = http.createServer((request, response) => this._handle(request, response));
+    this._server.on('connection', (socket) => {
+      this._sockets.add(socket);
+      socket.on('close', () => this._sockets.delete(socket));
+    });
+    await new Promise((resolve, reject) => {
+      this._server.once('error', reject);
+      this._server.listen(this.port, this.host, resolve);
+    });
+    this.port = this._server.address().port;
+    if (this.roundMs > 0) this._timer = setInterval(() => this._advance(this.round + 1), this.roundMs);
+    const server = `http://${this.host}`;
+    return { url: `${server}:${this.port}`, server, port: this.port, token: 'a'.repeat(64) };
+  }
+
+  /**
+   * Stop the server, closing open connections and long polls
+   */
+  async close() {
+    clearInterval(this._timer);
+    this._advance(Infinity);
+    if (!this._server) return;
+    const closed = new Promise((resolve) => this._server.close(resolve));
+    for (const socket of this._sockets) socket.destroy();
+    await closed;
+    this._server = null;
+  }
+
+  /**
+   * Make the next `count` requests to an endpoint fail
+   * @param {string} endpoint - compile, params, send, status or pending
+   * @param {number} count - Number of failing requests
+   * @param {Object} options - status (HTTP status, default 503), message,
+   *   reset (drop the connection instead of answering), lost (send only: the
+   *   group is accepted but the response is lost, so a resend reports it as
+   *   already in the pool)
+   */
+  injectFailures(endpoint, count, { status = 503, message = 'upstream unavailable', reset = false, lost = false } = {}) {
+    if (!ENDPOINTS.includes(endpoint)) throw new Error(`Unknown endpoint: ${endpoint}`);
+    for (let i = 0; i < count; i++) this._failures[endpoint].push({ status, message, reset, lost });
+  }
+
+  /**
+   * Register a pending transaction (e.g. one that never confirms)
+   * @param {string} txId - Transaction ID
+   * @param {Object} options - signed (signed transaction bytes), confirmRounds
+   *   (null never confirms), poolError
+   */
+  addTransaction(txId, { signed = Buffer.of(0x80), confirmRounds = this.confirmRounds, poolError = '' } = {}) {
+    this.transactions.set(txId, {
+      signed: Buffer.from(signed),
+      confirmRound: confirmRounds === null ? null : this.round + confirmRounds,
+      poolError,
+    });
+    return txId;
+  }
+
+  /**
+   * Request and error counters per endpoint
+   * @returns {Object} { round, transactions, calls, errors }
+   */
+  stats() {
+    return { round: this.round, transactions: this.transactions.size, calls: { ...this.calls }, errors: { ...this.errors } };
+  }
+
+  /**
+   * Move to `round` and release the long polls it satisfies
+   * @private
+   */
+  _advance(round) {
+    if (Number.isFinite(round)) this.round = Math.max(this.round, round);
+    this._roundWaiters = this._roundWaiters.filter((waiter) => {
+      if (round <= waiter.after) return true;
+      waiter.resolve();
+      return false;
+    });
+  }
+
+  /**
+   * Resolve once the round is past `after`
+   * @private
+   */
+  _waitForRound(after) {
+    if (this.roundMs === 0) this._advance(after + 1);
+    if (this.round > after) return Promise.resolve();
+    return new Promise((resolve) => this._roundWaiters.push({ after, resolve }));
+  }
+
+  /**
+   * Route, delay, fail or answer one request
+   * @private
+   */
+  async _handle(request, response) {
+    const url = new URL(request.url, 'http://mock');
+    const route = this._route(request.method, url.pathname);
+    const send = (status, body, type = 'application/json') => {
+      const payload = type === 'application/json' ? JSON.stringify(body) : body;
+      response.writeHead(status, { 'Content-Type': type, 'Content-Length': Buffer.byteLength(payload) });
+      response.end(payload);
+    };
+    if (!route) return send(404, { message: `Unknown endpoint: ${request.method} ${url.pathname}` });
+
+    const chunks = [];
+    for await (const chunk of request) chunks.push(chunk);
+    const body = new Uint8Array(Buffer.concat(chunks));
+
+    this.calls[route.endpoint]++;
+    await sleep(sampleLatency(this.latency[route.endpoint], this._random));
+
+    let failure = this._failures[route.endpoint].shift();
+    if (!failure && this._random() < this.errorRate[route.endpoint]) failure = { status: 503, message: 'injected error' };
+    try {
+      if (failure?.reset) {
+        this.errors[route.endpoint]++;
+        request.socket.destroy();
+        return;
+      }
+      if (failure?.lost) {
+        // Accepted, but the client only sees the error
+        await route.handler(body, url);
+        throw httpError(failure.status, failure.message);
+      }
+      if (failure) throw httpError(failure.status, failure.message);
+      const result = await route.handler(body, url);
+      if (result instanceof Uint8Array) send(200, result, 'application/msgpack');
+      else send(200, result);
+    } catch (error) {
+      this.errors[route.endpoint]++;
+      const status = error.status ?? 400;
+      send(status, { message: `${STATUS_TEXT[status] ?? 'Error'}: ${error.message}` });
+    }
+  }
+
+  /**
+   * Endpoint name and handler for a request
+   * @private
+   */
+  _route(method, pathname) {
+    const parts = pathname.split('/').filter(Boolean);
+    if (parts[0] !== 'v2') return null;
+    const path = parts.slice(1).join('/');
+    if (method === 'POST' && path === 'teal/compile') return { endpoint: 'compile', handler: (body) => this._compile(body) };
+    if (method === 'GET' && path === 'transactions/params') return { endpoint: 'params', handler: () => this._params() };
+    if (method === 'POST' && path === 'transactions') return { endpoint: 'send', handler: (body) => this._send(body) };
+    if (method === 'GET' && path === 'status') return { endpoint: 'status', handler: () => this._status() };
+    if (method === 'GET' && parts[1] === 'status' && parts[2] === 'wait-for-block-after' && parts.length === 4) {
+      return { endpoint: 'status', handler: async () => { await this._waitForRound(Number(parts[3])); return this._status(); } };
+    }
+    if (method === 'GET' && parts[1] === 'transactions' && parts[2] === 'pending' && parts.length === 4) {
+      return { endpoint: 'pending', handler: (body, url) => this._pending(decodeURIComponent(parts[3]), url.searchParams.get('format')) };
+    }
+    return null;
+  }
+
+  _compile(body) {
+    const program = assembleFalconTemplate(Buffer.from(body).toString('utf8'));
+    return {
+      hash: encodeAddress(sha512_256('Program', program)),
+      result: Buffer.from(program).toString('base64'),
+    };
+  }
+
+  _params() {
+    return {
+      'consensus-version': 'future',
+      fee: 0,
+      'genesis-hash': Buffer.alloc(32, 7).toString('base64'),
+      'genesis-id': 'mocknet-v1.0',
+      'last-round': this.round,
+      'min-fee': 1000,
+    };
+  }
+
+  _status() {
+    return {
+      'catchup-time': 0,
+      'last-round': this.round,
+      'last-version': 'future',
+      'next-version': 'future',
+      'next-version-round': this.round + 1,
+      'next-version-supported': true,
+      'stopped-at-unsupported-round': false,
+      'time-since-last-round': 0,
+    };
+  }
+
+  _send(body) {
+    const group = parseSignedTransactions(body);
+    for (const { txId } of group) {
+      if (this.transactions.has(txId)) throw httpError(400, `transaction already in the pool: ${txId}`);
+    }
+    for (const { signed, txId } of group) this.addTransaction(txId, { signed });
+    return { txId: group[0].txId };
+  }
+
+  _pending(txId, format) {
+    const tx = this.transactions.get(txId);
+    if (!tx) throw httpError(404, `txn does not exist: ${txId}`);
+    const confirmed = !tx.poolError && tx.confirmRound !== null && this.round >= tx.confirmRound;
+    if (format === 'msgpack') return new Uint8Array(encodePendingMsgpack(tx, confirmed));
+    return {
+      ...(confirmed ? { 'confirmed-round': tx.confirmRound } : {}),
+      'pool-error': tx.poolError,
+      txn: { blob: tx.signed.toString('base64') },
+    };
+  }
+}
+
+/**
+ * Parse `--latency endpoint=dist` / `--error-rate endpoint=rate` style
+ * options into per-endpoint settings
+ */
+function parseEndpointOption(text, parse) {
+  const [endpoint, value] = text.split('=');
+  const targets = endpoint === 'all' ? ENDPOINTS : [endpoint];
+  if (!targets.every((e) => ENDPOINTS.includes(e))) throw new Error(`Unknown endpoint: ${endpoint}`);
+  return Object.fromEntries(targets.map((e) => [e, parse(value)]));
+}
+
+/**
+ * Command-line options shared by the server and the SDK benchmark
+ * @param {Array<string>} args - Arguments
+ * @param {Object} options - Defaults, updated in place
+ * @returns {Array<string>} Arguments that are not server options
+ */
+export function parseServerArgs(args, options) {
+  const rest = [];
+  options.latency ??= {};
+  options.errorRate ??= {};
+  for (let i = 0; i < args.length; i++) {
+    if (args[i] === '--port') options.port = parseInt(args[++i], 10);
+    else if (args[i] === '--round-ms') options.roundMs = Number(args[++i]);
+    else if (args[i] === '--confirm-rounds') options.confirmRounds = parseInt(args[++i], 10);
+    else if (args[i] === '--seed') options.seed = parseInt(args[++i], 10);
+    else if (args[i] === '--latency') Object.assign(options.latency, parseEndpointOption(args[++i], parseLatency));
+    else if (args[i] === '--error-rate') Object.assign(options.errorRate, parseEndpointOption(args[++i], Number));
+    else rest.push(args[i]);
+  }
+  return rest;
+}
+
+if (import.meta.url === pathToFileURL(process.argv[1]).href) {
+  const options = { port: 4001 };
+  const rest = parseServerArgs(process.argv.slice(2), options);
+  if (rest.length > 0) {
+    console.error(`Unknown arguments: ${rest.join(' ')}`);
+    process.exit(1);
+  }
+  const server = new MockAlgodServer(options);
+  const { url, token } = await server.listen();
+  console.log(`Mock algod listening on ${url} (token ${token})`);
+  process.on('SIGINT', async () => {
+    console.log(JSON.stringify(server.stats()));
+    await server.close();
+    process.exit(0);
+  });
+}
+
+export default MockAlgodServer;
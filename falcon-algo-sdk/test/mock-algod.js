@@ -0,0 +1,147 @@
+/**
+ * In-process mock of the algod endpoints used by the SDK.
+ *
+ * Rounds only advance when a client waits on `statusAfterBlock`, so tests are
+ * deterministic. Submitted transactions confirm `confirmRounds` rounds after
+ * submission. Every endpoint counts its calls in `calls`.
+ *
+ * `latencyMs` delays the `send`, `status` (status and statusAfterBlock) and
+ * `pending` endpoints; `injectSendFailures` makes the next sends fail.
+ */
+
+const sleep = (ms) => (ms > 0 ? new Promise((resolve) => setTimeout(resolve, ms)) : Promise.resolve());
+
+const groupKey = (signedTxns) =>
+  (Array.isArray(signedTxns) ? signedTxns : [signedTxns]).map((b) => Buffer.from(b).toString('hex')).join('|');
+
+const STATUS_TEXT = { 400: 'Bad Request', 429: 'Too Many Requests', 500: 'Internal Server Error', 503: 'Service Unavailable' };
+
+export class MockAlgod {
+  constructor({ startRound = 1000, confirmRounds = 2, latencyMs = {} } = {}) {
+    this.round = startRound;
+    this.confirmRounds = confirmRounds;
+    this.latencyMs = { send: 0, status: 0, pending: 0, ...latencyMs };
+    this.transactions = new Map();
+    this.calls = {
+      status: 0,
+      statusAfterBlock: 0,
+      pendingTransactionInformation: 0,
+      sendRawTransaction: 0,
+    };
+    this._txCounter = 0;
+    this._sendFailures = [];
+    this._lost = new Map();
+  }
+
+  /**
+   * Make the next `count` sendRawTransaction calls fail
+   * @param {number} count - Number of failing sends
+   * @param {Object} options - status (HTTP status, default 503), message,
+   *   lost (the group is accepted but the response is lost, so a resend reports
+   *   it as already in the pool)
+   */
+  injectSendFailures(count, { status = 503, message = 'upstream unavailable', lost = false } = {}) {
+    for (let i = 0; i < count; i++) this._sendFailures.push({ status, message, lost });
+  }
+
+  /**
+   * Transaction ID assigned to a group whose send response was lost
+   */
+  txIdOf(signedTxns) {
+    return this._lost.get(groupKey(signedTxns));
+  }
+
+  /**
+   * Register a pending transaction
+   * @param {string} txId - Transaction ID
+   * @param {Object} options - confirmRounds (null never confirms), poolError
+   */
+  addTransaction(txId, { confirmRounds = this.confirmRounds, poolError = '' } = {}) {
+    this.transactions.set(txId, {
+      confirmRound: confirmRounds === null ? null : this.round + confirmRounds,
+      poolError,
+    });
+    return txId;
+  }
+
+  getTransactionParams() {
+    return {
+      do: async () => ({
+        fee: 0,
+        minFee: 1000,
+        flatFee: false,
+        firstValid: this.round,
+        lastValid: this.round + 1000,
+        genesisID: 'mocknet-v1.0',
+        genesisHash: new Uint8Array(32).fill(7),
+      }),
+    };
+  }
+
+  status() {
+    return {
+      do: async () => {
+        this.calls.status++;
+        await sleep(this.latencyMs.status);
+        return { lastRound: BigInt(this.round) };
+      },
+    };
+  }
+
+  statusAfterBlock(round) {
+    return {
+      do: async () => {
+        this.calls.statusAfterBlock++;
+        await sleep(this.latencyMs.status);
+        this.round = Math.max(this.round, Number(round) + 1);
+        return { lastRound: BigInt(this.round) };
+      },
+    };
+  }
+
+  pendingTransactionInformation(txId) {
+    return {
+      do: async () => {
+        this.calls.pendingTransactionInformation++;
+        await sleep(this.latencyMs.pending);
+        const tx = this.transactions.get(txId);
+        if (!tx) throw new Error(`Network request error. Received status 404: transaction ${txId} not found`);
+        if (tx.poolError) return { poolError: tx.poolError };
+        if (tx.confirmRound !== null && this.round >= tx.confirmRound) {
+          return { confirmedRound: BigInt(tx.confirmRound), poolError: '' };
+        }
+        return { poolError: '' };
+      },
+    };
+  }
+
+  sendRawTransaction(signedTxns) {
+    return {
+      do: async () => {
+        this.calls.sendRawTransaction++;
+        await sleep(this.latencyMs.send);
+
+        const key = groupKey(signedTxns);
+        if (this._lost.has(key)) {
+          throw httpError(400, `transaction already in the pool: ${this._lost.get(key)}`);
+        }
+        const failure = this._sendFailures.shift();
+        if (failure?.lost) {
+          this._lost.set(key, this.addTransaction(`MOCKTX${String(++this._txCounter).padStart(46, '0')}`));
+        }
+        if (failure) throw httpError(failure.status, failure.message);
+
+        const txid = this.addTransaction(`MOCKTX${String(++this._txCounter).padStart(46, '0')}`);
+        return { txid };
+      },
+    };
+  }
+}
+
+function httpError(status, message) {
+  const error = new Error(`Network request error. Received status ${status} (${STATUS_TEXT[status] ?? 'Error'}): ${message}`);
+  error.response = { status };
+  return error;
+}
+
+export default MockAlgod;
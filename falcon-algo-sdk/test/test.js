@@ -9,7 +9,16 @@ import FalconAlgoSDK, {
   isOnCurve,
   isLsigAddressOffCurve,
   assertLsigAddressOffCurve,
+  ConfirmationTracker,
+  LogicSigBlobTemplate,
+  SubmissionPipeline,
+  isTransientAlgodError,
+  LogicSigEvaluator,
+  rawTxIDFromBytes,
+  BatchRotationError,
 } from '../dist/index.js';
+import { MockAlgod } from './mock-algod.js';
+import { MockAlgodServer, parseLatency } from './mock-algod-server.js';
 import algosdk from 'algosdk';
 import { getPublicKeyAsync, utils as edUtils } from '@noble/ed25519';
 
@@ -23,6 +32,43 @@ async function findOffCurveBytes() {
   throw new Error('Could not find off-curve random sample in 64 tries — oracle suspect');
 }
 
+// algod stub whose compile() returns a random "program" with an off-curve
+// LogicSig address, so signing paths can run without a network.
+function offCurveCompileAlgod() {
+  return {
+    compile: () => ({
+      do: async () => {
+        for (;;) {
+          const program = edUtils.randomSecretKey();
+          const hash = new algosdk.LogicSigAccount(program).address().toString();
+          if (!isOnCurve(algosdk.decodeAddress(hash).publicKey)) {
+            return { result: Buffer.from(program).toString('base64'), hash };
+          }
+        }
+      },
+    }),
+  };
+}
+
+const TEST_RECEIVER = 'LP6QRRBRDTDSP4HF7CSPWJV4AG4QWE437OYHGW7K5Y7DETKCSK5H3HCA7Q';
+
+function makeTestPayment(sender, amount = 1000) {
+  return algosdk.makePaymentTxnWithSuggestedParamsFromObject({
+    sender,
+    receiver: TEST_RECEIVER,
+    amount,
+    suggestedParams: {
+      fee: 1000,
+      minFee: 1000,
+      flatFee: true,
+      firstValid: 1000,
+      lastValid: 2000,
+      genesisID: 'testnet-v1.0',
+      genesisHash: new Uint8Array(32).fill(7),
+    },
+  });
+}
+
 let testResults = [];
 
 function test(description, testFunction) {
@@ -440,6 +486,381 @@ async function runTests() {
     }
   });
 
+  // Test 11: Shared confirmation tracker. One round-following loop must
+  // serve every pending transaction instead of one status poll per txid.
+  await test('ConfirmationTracker follows rounds once for many transactions (mock algod)', async () => {
+    const algod = new MockAlgod({ startRound: 500 });
+    const tracker = new ConfirmationTracker(algod);
+
+    const waits = [];
+    for (let i = 0; i < 100; i++) {
+      const txId = algod.addTransaction(`TX${i}`, { confirmRounds: 1 + (i % 5) });
+      waits.push(tracker.waitForConfirmation(txId, 10));
+    }
+    algod.addTransaction('REJECTED', { poolError: 'overspend' });
+    algod.addTransaction('STUCK', { confirmRounds: null });
+    const rejected = tracker.waitForConfirmation('REJECTED', 10).then(() => null, (e) => e);
+    const stuck = tracker.waitForConfirmation('STUCK', 3).then(() => null, (e) => e);
+
+    const results = await Promise.all(waits);
+    results.forEach((info, i) => {
+      if (Number(info.confirmedRound) !== 500 + 1 + (i % 5)) {
+        throw new Error(`TX${i} resolved with round ${info.confirmedRound}`);
+      }
+    });
+
+    const rejectError = await rejected;
+    if (!rejectError || !/overspend/.test(rejectError.message)) {
+      throw new Error('Pool error must reject the waiter');
+    }
+    const stuckError = await stuck;
+    if (!stuckError || !/not confirmed after 3 rounds/.test(stuckError.message)) {
+      throw new Error('Unconfirmed transaction must time out after its wait rounds');
+    }
+
+    if (algod.calls.status !== 1) {
+      throw new Error(`Expected a single status call, got ${algod.calls.status}`);
+    }
+    if (algod.calls.statusAfterBlock > 5) {
+      throw new Error(`Expected at most 5 statusAfterBlock calls, got ${algod.calls.statusAfterBlock}`);
+    }
+    if (tracker.pendingCount !== 0) {
+      throw new Error(`Tracker still holds ${tracker.pendingCount} transactions`);
+    }
+  });
+
+  // Test 12: concurrent submissions through the SDK share the tracker
+  await test('Concurrent submitTransactionGroup calls share one confirmation loop', async () => {
+    const sdk = new FalconAlgoSDK(Networks.TESTNET);
+    const algod = new MockAlgod({ confirmRounds: 2 });
+    sdk.algod = algod;
+
+    const results = await Promise.all(
+      Array.from({ length: 20 }, () => sdk.submitTransactionGroup([new Uint8Array(1)], 5)),
+    );
+
+    if (results.some((r) => Number(r.confirmedRound) !== algod.round)) {
+      throw new Error('Every group should confirm in the mock round');
+    }
+    if (algod.calls.status !== 1 || algod.calls.statusAfterBlock !== 2) {
+      throw new Error(
+        `Expected 1 status + 2 statusAfterBlock calls, got ${algod.calls.status} + ${algod.calls.statusAfterBlock}`,
+      );
+    }
+  });
+
+  // Test 13: prepared accounts must produce exactly what the per-call path
+  // (createLogicSig + signLogicSigTransactionObject) produces.
+  await test('prepareAccount signs byte-identically to signTransaction', async () => {
+    const sdk = new FalconAlgoSDK(Networks.TESTNET);
+    sdk.algod = offCurveCompileAlgod();
+    const account = await sdk.createFalconAccount({ generateEdKeys: false });
+    const prepared = await sdk.prepareAccount(account);
+
+    if (prepared.address !== account.address) {
+      throw new Error(`Prepared address ${prepared.address} != ${account.address}`);
+    }
+
+    // Own-address sender, then a rekeyed sender (adds the sgnr field)
+    for (const sender of [account.address, TEST_RECEIVER]) {
+      const txn = makeTestPayment(sender);
+      const expected = await sdk.signTransaction(txn, account, txn.txID());
+      const actual = await prepared.sign(txn);
+      if (actual.txID !== expected.txID) {
+        throw new Error(`txID mismatch: ${actual.txID} != ${expected.txID}`);
+      }
+      if (Buffer.compare(Buffer.from(actual.blob), Buffer.from(expected.blob)) !== 0) {
+        throw new Error(`Signed blob mismatch for sender ${sender}`);
+      }
+    }
+  });
+
+  // Test 14: the pre-encoded skeleton must be byte-identical to algosdk's
+  // own encoding for a full-size program and signature, rekeyed or not.
+  await test('LogicSigBlobTemplate matches signLogicSigTransactionObject', async () => {
+    const program = new Uint8Array(1800).map(() => Math.floor(Math.random() * 256));
+    const signature = new Uint8Array(1230).map(() => Math.floor(Math.random() * 256));
+    const lsigAccount = new algosdk.LogicSigAccount(program, [signature]);
+    const lsigAddress = lsigAccount.address();
+    const template = new LogicSigBlobTemplate(program, lsigAddress.publicKey);
+
+    for (const sender of [lsigAddress.toString(), TEST_RECEIVER]) {
+      const txn = makeTestPayment(sender);
+      const expected = algosdk.signLogicSigTransactionObject(txn, lsigAccount);
+      const actual = template.encode(signature, txn.toByte(), sender !== lsigAddress.toString());
+      if (Buffer.compare(Buffer.from(actual), Buffer.from(expected.blob)) !== 0) {
+        throw new Error(`Template blob differs from algosdk for sender ${sender}`);
+      }
+    }
+  });
+
+  // Test 15: pipelined submission keeps groups in flight, retries transient
+  // send errors and reports per-stage latency (mock algod with latency)
+  await test('SubmissionPipeline pipelines groups and retries transient errors (mock algod)', async () => {
+    const algod = new MockAlgod({ confirmRounds: 2, latencyMs: { send: 5, status: 20 } });
+    const pipeline = new SubmissionPipeline(algod, {
+      concurrency: 8,
+      baseDelayMs: 1,
+      txIdOf: (signed) => algod.txIdOf(signed),
+    });
+    algod.injectSendFailures(3, { status: 503 });
+    algod.injectSendFailures(1, { status: 503, lost: true });
+
+    const started = Date.now();
+    const results = await Promise.all(Array.from({ length: 40 }, (_, i) =>
+      pipeline.submit(i % 2
+        ? { signedTransactions: [new Uint8Array([i])] }
+        : { sign: async () => [new Uint8Array([i])] })));
+    const elapsed = Date.now() - started;
+
+    const stats = pipeline.stats();
+    if (stats.confirmed !== 40 || stats.failed !== 0) {
+      throw new Error(`Expected 40 confirmed groups, got ${stats.confirmed} (${stats.failed} failed)`);
+    }
+    if (stats.retries !== 4 || results.filter((r) => r.attempts > 1).length !== 4) {
+      throw new Error(`Expected 4 retried sends, got ${stats.retries}`);
+    }
+    if (new Set(results.map((r) => r.txId)).size !== 40) {
+      throw new Error('Every group should confirm under its own transaction ID');
+    }
+    if (stats.latency.confirm.count !== 40 || !(stats.latency.confirm.p50 > 0) || !(stats.latency.send.max >= 5)) {
+      throw new Error('Per-stage latency should be recorded for every group');
+    }
+    // One at a time, 40 groups would take 40 x (send + 2 rounds) = ~1800 ms
+    if (elapsed > 900) {
+      throw new Error(`Pipelined submission took ${elapsed} ms`);
+    }
+
+    // Non-transient errors fail at once; transient ones give up after maxRetries
+    algod.injectSendFailures(1, { status: 400, message: 'overspend' });
+    const overspend = await pipeline.submit({ signedTransactions: [new Uint8Array([100])] }).then(() => null, (e) => e);
+    if (!overspend || !/overspend/.test(overspend.message) || pipeline.stats().retries !== 4) {
+      throw new Error('Non-transient send errors must not be retried');
+    }
+    const limited = new SubmissionPipeline(algod, { maxRetries: 2, baseDelayMs: 1 });
+    algod.injectSendFailures(3, { status: 503 });
+    const exhausted = await limited.submit({ signedTransactions: [new Uint8Array([101])] }).then(() => null, (e) => e);
+    if (!exhausted || !/status 503/.test(exhausted.message) || limited.stats().retries !== 2) {
+      throw new Error('Transient errors must be retried maxRetries times');
+    }
+    await pipeline.drain();
+
+    if (!isTransientAlgodError({ code: 'ECONNRESET' }) || isTransientAlgodError(new Error('Received status 400: overspend'))) {
+      throw new Error('isTransientAlgodError misclassifies errors');
+    }
+    const sdk = new FalconAlgoSDK(Networks.TESTNET);
+    sdk.algod = algod;
+    if (sdk.createSubmissionPipeline().confirmations !== sdk.confirmations) {
+      throw new Error('SDK pipelines should share the SDK confirmation tracker');
+    }
+  });
+
+  // Test 16: batch rotation rekeys every account in place, in groups of at
+  // most 16, and hands back account infos for the new LogicSigs
+  await test('rotateFalconKeysBatch rekeys accounts in groups (mock algod)', async () => {
+    const sdk = new FalconAlgoSDK(Networks.TESTNET);
+    const algod = new MockAlgod();
+    algod.compile = offCurveCompileAlgod().compile;
+    sdk.algod = algod;
+    const accounts = [];
+    for (let i = 0; i < 20; i++) {
+      accounts.push(await sdk.createFalconAccount({ generateEdKeys: false }));
+    }
+
+    const progress = [];
+    const result = await sdk.rotateFalconKeysBatch(accounts, {
+      concurrency: 4,
+      submit: { concurrency: 2 },
+      onProgress: (done, total) => progress.push(`${done}/${total}`),
+    });
+
+    if (result.groups.length !== 2 || result.groups[0].txIds.length !== 16 || result.groups[1].txIds.length !== 4) {
+      throw new Error(`Expected groups of 16 and 4, got ${result.groups.map((g) => g.txIds.length)}`);
+    }
+    result.accounts.forEach((rotated, i) => {
+      if (rotated.address !== accounts[i].address || rotated.previousLogicSig !== accounts[i].logicSig) {
+        throw new Error(`Account ${i} should keep its address and remember its previous LogicSig`);
+      }
+      if (rotated.logicSig.address === accounts[i].logicSig.address ||
+          rotated.falconKeys.publicKey === accounts[i].falconKeys.publicKey) {
+        throw new Error(`Account ${i} should get new Falcon keys and a new LogicSig`);
+      }
+      const txn = algosdk.decodeSignedTransaction(result.groups[Math.floor(i / 16)].signedTransactions[i % 16]).txn;
+      if (txn.rekeyTo?.toString() !== rotated.logicSig.address) {
+        throw new Error(`Rekey transaction ${i} should point at the new LogicSig`);
+      }
+    });
+    if (result.submissions.some((s) => s.status !== 'fulfilled') || algod.calls.sendRawTransaction !== 2) {
+      throw new Error('Both rekey groups should be submitted and confirmed');
+    }
+    if (progress.length !== 20 || progress[19] !== '20/20' || !(result.rotationsPerSecond > 0)) {
+      throw new Error('Progress and throughput should be reported');
+    }
+    const evaluations = await sdk.evaluateLogicSigs(result.groups.flatMap((g) => g.signedTransactions));
+    if (evaluations.length !== 20 || evaluations.some((e) => !e.pass)) {
+      throw new Error('Rekey transactions should pass offline LogicSig evaluation');
+    }
+    const invalid = await sdk.rotateFalconKeysBatch(accounts, { groupSize: 17 }).then(() => null, (e) => e);
+    if (!invalid || !/Invalid groupSize/.test(invalid.message)) {
+      throw new Error('Groups larger than 16 transactions must be rejected');
+    }
+
+    // A keygen failure after group 0 went out must hand back group 0's new keys
+    const sent = algod.calls.sendRawTransaction;
+    let keygens = 0;
+    const failing = await sdk.rotateFalconKeysBatch(accounts.slice(0, 8), {
+      concurrency: 4,
+      groupSize: 4,
+      submit: true,
+      keygen: async () => {
+        if (++keygens <= 4) return sdk.falcon.keypair();
+        while (algod.calls.sendRawTransaction === sent) await new Promise((resolve) => setTimeout(resolve, 5));
+        throw new Error('keygen failed');
+      },
+    }).then(() => null, (e) => e);
+    if (!(failing instanceof BatchRotationError) || failing.cause?.message !== 'keygen failed') {
+      throw new Error(`A failed rotation should throw a BatchRotationError, got ${failing}`);
+    }
+    const partial = failing.result;
+    if (!partial.groups[0] || partial.groups[1] || partial.submissions[0]?.status !== 'fulfilled' ||
+        algod.calls.sendRawTransaction !== sent + 1) {
+      throw new Error('Only group 0 should be signed and submitted, and its submission reported');
+    }
+    partial.groups[0].signedTransactions.forEach((blob, i) => {
+      const txn = algosdk.decodeSignedTransaction(blob).txn;
+      if (!partial.accounts[i]?.falconKeys.secretKey || txn.rekeyTo?.toString() !== partial.accounts[i].logicSig.address) {
+        throw new Error(`The new keys of submitted account ${i} should be returned`);
+      }
+    });
+  });
+
+  // Test 17: the offline evaluator runs the assembled Falcon template
+  // (#pragma version 12; bytecblock; txn TxID; arg 0; pushbytes pk; falcon_verify)
+  await test('LogicSigEvaluator runs the Falcon template offline', async () => {
+    const sdk = new FalconAlgoSDK(Networks.TESTNET);
+    await sdk._ensureInitialized();
+    const { publicKey, secretKey } = await sdk.falcon.keypair();
+    const program = Uint8Array.from([0x0c, 0x26, 0x01, 0x01, 0x07, 0x31, 0x17, 0x2d, 0x80, 0x81, 0x0e, ...publicKey, 0x85]);
+    const rawTxId = new Uint8Array(32).fill(9);
+    const signature = await sdk.falcon.sign(rawTxId, secretKey);
+    const evaluator = sdk.logicSigEvaluator;
+
+    const passing = await evaluator.evaluateProgram(program, [signature], rawTxId);
+    if (!passing.pass || passing.cost !== 1704) {
+      throw new Error(`Valid signature should pass at cost 1704, got ${JSON.stringify(passing)}`);
+    }
+    const rejected = await evaluator.evaluateProgram(program, [signature], new Uint8Array(32));
+    if (rejected.pass || !/falcon_verify failed/.test(rejected.error)) {
+      throw new Error('Signature over another transaction ID must be rejected');
+    }
+    const missing = await evaluator.evaluateProgram(program, [], rawTxId);
+    if (missing.pass || !/Missing LogicSig argument 0/.test(missing.error)) {
+      throw new Error('A missing signature argument must be reported');
+    }
+    const shortKey = Uint8Array.from([0x0c, 0x31, 0x17, 0x2d, 0x80, 0x02, 0xaa, 0xbb, 0x85]);
+    if (!/Invalid Falcon public key length/.test((await evaluator.evaluateProgram(shortKey, [signature], rawTxId)).error)) {
+      throw new Error('A wrong-size public key must be reported');
+    }
+    const branching = Uint8Array.from([0x0c, 0x81, 0x01, 0x40, 0x00, 0x00]);
+    const unsupported = await evaluator.evaluateProgram(branching, [], rawTxId);
+    if (unsupported.pass || !unsupported.unsupported) {
+      throw new Error('Programs outside the template must be reported unsupported');
+    }
+    const v11 = await evaluator.evaluateProgram(Uint8Array.from([0x0b, ...program.subarray(1)]), [signature], rawTxId);
+    if (v11.pass || !/version 12/.test(v11.error)) {
+      throw new Error('falcon_verify must be rejected before program version 12');
+    }
+
+    const started = performance.now();
+    for (let i = 0; i < 500; i++) await evaluator.evaluateProgram(program, [signature], rawTxId);
+    console.log(`   ${(500 / ((performance.now() - started) / 1000)).toFixed(0)} evaluations/s`);
+    if (evaluator.stats().programs !== 4) {
+      throw new Error(`Each distinct program should be decoded once, got ${evaluator.stats().programs}`);
+    }
+
+    // falcon-signatures before 1.5.0 has no verifyBatch: one verify per check
+    const legacy = new LogicSigEvaluator({ verify: (...args) => sdk.falcon.verify(...args) });
+    const legacyResults = [
+      await legacy.evaluateProgram(program, [signature], rawTxId),
+      await legacy.evaluateProgram(program, [signature], new Uint8Array(32)),
+    ];
+    if (!legacyResults[0].pass || legacyResults[1].pass || legacyResults[1].error !== 'falcon_verify failed') {
+      throw new Error('Without verifyBatch, checks should fall back to verify');
+    }
+  });
+
+  // Test 18: the HTTP mock algod behind test/bench.js speaks the algod v2
+  // REST API (checked with plain fetch, independent of the algosdk client)
+  await test('MockAlgodServer serves algod endpoints with latency and faults', async () => {
+    const server = new MockAlgodServer({ startRound: 100, latency: { send: 20 } });
+    const { url } = await server.listen();
+    const call = (path, init) => fetch(`${url}${path}`, init);
+    try {
+      const publicKey = new Uint8Array(1793).fill(3);
+      const source = `#pragma version 12\nbytecblock 0x07\ntxn TxID\narg 0\npushbytes 0x${Buffer.from(publicKey).toString('hex')}\nfalcon_verify`;
+      const compiled = await (await call('/v2/teal/compile', { method: 'POST', body: source })).json();
+      const program = Uint8Array.from([0x0c, 0x26, 0x01, 0x01, 0x07, 0x31, 0x17, 0x2d, 0x80, 0x81, 0x0e, ...publicKey, 0x85]);
+      if (!Buffer.from(compiled.result, 'base64').equals(Buffer.from(program)) || !/^[A-Z2-7]{58}$/.test(compiled.hash)) {
+        throw new Error('compile must assemble the Falcon template and return its address');
+      }
+      if ((await call('/v2/teal/compile', { method: 'POST', body: '#pragma version 12\nint 1' })).status !== 400) {
+        throw new Error('Programs outside the template must be rejected');
+      }
+
+      // Two-transaction group: msgpack {fee, note} under the LogicSig skeleton
+      const txns = [1, 2].map((n) => Uint8Array.of(0x82, 0xa3, 0x66, 0x65, 0x65, 0xcd, 0x03, 0xe8, 0xa4, 0x6e, 0x6f, 0x74, 0x65, 0xc4, 0x01, n));
+      const template = new LogicSigBlobTemplate(program, new Uint8Array(32));
+      const group = Buffer.concat(txns.map((txn) => template.encode(new Uint8Array(666).fill(1), txn, false)));
+      const started = performance.now();
+      const sent = await (await call('/v2/transactions', { method: 'POST', body: group })).json();
+      if (performance.now() - started < 20) throw new Error('Send latency must be applied');
+      // Algorand transaction ID: unpadded base32 of SHA-512/256("TX" || txn)
+      const bits = Array.from(rawTxIDFromBytes(txns[0]), (b) => b.toString(2).padStart(8, '0')).join('');
+      const expectedId = bits.match(/.{1,5}/g).map((c) => 'ABCDEFGHIJKLMNOPQRSTUVWXYZ234567'[parseInt(c.padEnd(5, '0'), 2)]).join('');
+      const pending = Buffer.from(await (await call(`/v2/transactions/pending/${sent.txId}?format=msgpack`)).arrayBuffer());
+      if (sent.txId !== expectedId || !pending.includes(group.subarray(0, group.length / 2)) || pending.includes(Buffer.from('confirmed-round'))) {
+        throw new Error(`Unexpected transaction ID or pending response for ${sent.txId}`);
+      }
+      const resent = await call('/v2/transactions', { method: 'POST', body: group });
+      if (resent.status !== 400 || !/already in the pool/.test((await resent.json()).message)) {
+        throw new Error('A resent group must be reported as already in the pool');
+      }
+
+      const status = await (await call('/v2/status/wait-for-block-after/100')).json();
+      const confirmed = await (await call(`/v2/transactions/pending/${sent.txId}`)).json();
+      if (status['last-round'] !== 101 || confirmed['confirmed-round'] !== 101) {
+        throw new Error(`Expected confirmation in round 101, got ${JSON.stringify(confirmed)}`);
+      }
+
+      server.injectFailures('params', 1, { status: 429 });
+      server.injectFailures('status', 1, { reset: true });
+      if ((await call('/v2/transactions/params')).status !== 429 || (await call('/v2/transactions/params')).status !== 200) {
+        throw new Error('Injected failures must be served once, in order');
+      }
+      if (await call('/v2/status').then(() => true, () => false)) throw new Error('A reset must drop the connection');
+      const stats = server.stats();
+      if (stats.calls.send !== 2 || stats.errors.send !== 1 || stats.errors.params !== 1 || stats.errors.status !== 1) {
+        throw new Error(`Unexpected counters ${JSON.stringify(stats)}`);
+      }
+    } finally {
+      await server.close();
+    }
+
+    // Seeded random errors repeat from run to run
+    const pattern = async () => {
+      const flaky = new MockAlgodServer({ errorRate: { status: 0.5 }, latency: { status: parseLatency('uniform:0:2') }, seed: 7 });
+      const { url: flakyUrl } = await flaky.listen();
+      const codes = [];
+      for (let i = 0; i < 16; i++) codes.push((await fetch(`${flakyUrl}/v2/status`)).status);
+      await flaky.close();
+      return codes.join();
+    };
+    const first = await pattern();
+    if (first !== await pattern() || !first.includes('503') || !first.includes('200')) {
+      throw new Error(`Error injection must be random but seeded, got ${first}`);
+    }
+  });
+
   // Print test summary
   console.log('📊 Test Summary:');
   console.log('================');
@@ -5,6 +5,11 @@ declare module 'falcon-signatures' {
     keypair(): Promise<{ publicKey: Uint8Array; secretKey: Uint8Array }>;
     sign(message: Uint8Array | Buffer, secretKey: Uint8Array): Promise<Uint8Array>;
     verify(message: Uint8Array | Buffer, signature: Uint8Array, publicKey: Uint8Array): Promise<boolean>;
+    /** Since 1.5.0 */
+    verifyBatch(
+      items: { message: Uint8Array | Buffer; signature: Uint8Array; publicKey: Uint8Array }[],
+      options?: { constantTime?: boolean },
+    ): Promise<{ ok: boolean; error?: string }[]>;
     static bytesToHex(bytes: Uint8Array): string;
     static hexToBytes(hex: string): Uint8Array;
   }
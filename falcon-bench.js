@@ -0,0 +1,709 @@
+#!/usr/bin/env node
+/**
+ * Falcon Signatures - Benchmarks
+ *
+ * Usage: node falcon-bench.js [benchmark ...] [--iterations N]
+ *
+ * Benchmarks:
+ *   decode       Public-key and CT-signature decoding alone, scalar vs
+ *                vectorized, next to a full verification for scale
+ *   adversarial  Worst-case and tail verification time per adversarial input
+ *                class (--samples N, --message-size BYTES, --grind N)
+ *   startup      Binary size, instantiation and first-keygen time of a build
+ *                (--module path/to/falcon.js, default ./falcon.js)
+ *   tree         Signing latency and memory per key for each number of cached
+ *                LDL-tree levels, from none (falcon_sign_dyn) to 10
+ *                (--samples N signatures per setting)
+ *   midstate     What a secret-key midstate saves on short messages: the
+ *                absorption of the key it skips, against the SHA-256 check
+ *                binding it to the key, and signing with and without one
+ *                (--samples N signatures per setting)
+ *   cache        Scan resistance of the key cache: hot-key hit rate and
+ *                latency while cold keys stream past, LRU vs TinyLFU
+ *                admission (--samples N: N x 10 cold keys)
+ *   replay       Replay a recorded trace (--trace trace.json, see
+ *                Falcon.startTrace; default: a synthetic trace of --samples N
+ *                operations) against one instance, a pool of --threads N
+ *                workers and the pool with a memory budget (--speed X,
+ *                default 1; Infinity replays back to back)
+ *   file         signFile/verifyFile throughput next to reading the file
+ *                into a Buffer and signing that (--file-size BYTES, default
+ *                1 GiB with the streaming exports, otherwise what fits in
+ *                WebAssembly memory)
+ */
+import Falcon, { FalconKey } from './index.js';
+import { KeyCache } from './falcon-cache.js';
+import { FalconPool, keyFingerprint } from './falcon-pool.js';
+import { TraceReplayer } from './falcon-replay.js';
+import { performance } from 'perf_hooks';
+import { createHash, randomBytes } from 'crypto';
+import { closeSync, mkdtempSync, openSync, readFileSync, rmSync, statSync, writeSync } from 'fs';
+import { tmpdir } from 'os';
+import path from 'path';
+import { pathToFileURL } from 'url';
+
+// The module's debug output would dominate the timings
+const QUIET = { print: () => {}, printErr: () => {} };
+
+const N = 1024;
+const Q = 12289;
+const COMPRESSED_HEADER = 0xba;
+
+/**
+ * Time a synchronous function
+ * @param {Function} fn - Function to time
+ * @param {number} iterations - Number of calls
+ * @returns {number} Mean nanoseconds per call
+ */
+function timeSync(fn, iterations) {
+  // Warm-up so the measured loop runs optimized code
+  for (let i = 0; i < Math.min(iterations, 100); i++) fn();
+  const start = performance.now();
+  for (let i = 0; i < iterations; i++) fn();
+  return ((performance.now() - start) * 1e6) / iterations;
+}
+
+/**
+ * Time an asynchronous function
+ * @param {Function} fn - Async function to time
+ * @param {number} iterations - Number of calls
+ * @returns {Promise<number>} Mean nanoseconds per call
+ */
+async function timeAsync(fn, iterations) {
+  for (let i = 0; i < Math.min(iterations, 10); i++) await fn();
+  const start = performance.now();
+  for (let i = 0; i < iterations; i++) await fn();
+  return ((performance.now() - start) * 1e6) / iterations;
+}
+
+/**
+ * Format nanoseconds for display
+ */
+function formatNs(ns) {
+  return ns >= 1e6 ? `${(ns / 1e6).toFixed(2)} ms` : ns >= 1e3 ? `${(ns / 1e3).toFixed(2)} µs` : `${ns.toFixed(0)} ns`;
+}
+
+/**
+ * Decode phase in isolation: the inputs are copied into WebAssembly memory
+ * once, so only the unpacking and range checks are measured.
+ */
+async function benchDecode({ iterations }) {
+  const falcon = new Falcon(QUIET);
+  await falcon._ensureInitialized();
+  const module = falcon._module;
+  console.log('📊 Decode benchmark');
+
+  if (typeof module._falcon_det1024_decode_pubkey_wrapper !== 'function') {
+    console.log('  falcon.wasm does not export the decoders; rebuild it from falcon_wrapper.c');
+    return;
+  }
+
+  const { publicKey, secretKey } = await falcon.keypair();
+  const message = 'Falcon decode benchmark';
+  const signature = await falcon.sign(message, secretKey);
+  const ctSignature = await falcon.convertToConstantTime(signature);
+
+  const pkPtr = module._malloc(publicKey.length);
+  const sigPtr = module._malloc(ctSignature.length);
+  const outPtr = module._malloc(1024 * 2);
+  module.HEAPU8.set(publicKey, pkPtr);
+  module.HEAPU8.set(ctSignature, sigPtr);
+
+  try {
+    for (const [name, fn, ptr] of [
+      ['public key (14-bit)', module._falcon_det1024_decode_pubkey_wrapper, pkPtr],
+      ['CT s2 (12-bit)', module._falcon_det1024_decode_sig_ct_wrapper, sigPtr],
+    ]) {
+      if (fn(outPtr, ptr, 0) !== 0 || fn(outPtr, ptr, 1) !== 0) {
+        throw new Error(`Decoding ${name} failed`);
+      }
+      const scalar = timeSync(() => fn(outPtr, ptr, 0), iterations);
+      const vectorized = timeSync(() => fn(outPtr, ptr, 1), iterations);
+      console.log(`  ${name.padEnd(20)} scalar ${formatNs(scalar).padStart(10)}   vectorized ${formatNs(vectorized).padStart(10)}   (${(scalar / vectorized).toFixed(1)}x)`);
+    }
+
+    const verifyIterations = Math.max(1, Math.floor(iterations / 100));
+    const verify = await timeAsync(() => falcon.verifyConstantTime(message, ctSignature, publicKey), verifyIterations);
+    console.log(`  ${'full CT verify'.padEnd(20)} ${formatNs(verify).padStart(17)}`);
+  } finally {
+    module._free(pkPtr);
+    module._free(sigPtr);
+    module._free(outPtr);
+  }
+}
+
+/**
+ * Decode the s2 coefficients of a compressed signature payload (mirrors
+ * Zf(comp_decode): sign bit, 7 low bits, high bits in unary)
+ * @returns {Int16Array|null} Coefficients, or null if the encoding is invalid
+ */
+function compDecode(buf) {
+  const x = new Int16Array(N);
+  let acc = 0;
+  let accLen = 0;
+  let v = 0;
+  for (let u = 0; u < N; u++) {
+    if (v >= buf.length) return null;
+    acc = (acc << 8) | buf[v++];
+    const b = acc >>> accLen;
+    const s = b & 128;
+    let m = b & 127;
+    for (;;) {
+      if (accLen === 0) {
+        if (v >= buf.length) return null;
+        acc = (acc << 8) | buf[v++];
+        accLen = 8;
+      }
+      accLen--;
+      if ((acc >>> accLen) & 1) break;
+      m += 128;
+      if (m > 2047) return null;
+    }
+    if (s && m === 0) return null;
+    x[u] = s ? -m : m;
+  }
+  if (acc & ((1 << accLen) - 1)) return null;
+  return v === buf.length ? x : null;
+}
+
+/**
+ * Encode coefficients in the compressed format. `negativeZero` lists indices
+ * encoded as -0, which decoders must reject.
+ */
+function compEncode(x, negativeZero = new Set()) {
+  const bits = [];
+  for (let u = 0; u < x.length; u++) {
+    const m = Math.abs(x[u]);
+    bits.push(x[u] < 0 || negativeZero.has(u) ? 1 : 0);
+    for (let i = 6; i >= 0; i--) bits.push((m >> i) & 1);
+    for (let i = 0; i < m >> 7; i++) bits.push(0);
+    bits.push(1);
+  }
+  const out = new Uint8Array(Math.ceil(bits.length / 8));
+  bits.forEach((bit, i) => { out[i >> 3] |= bit << (7 - (i & 7)); });
+  return out;
+}
+
+/**
+ * Build a compressed signature from a salt version and s2 payload
+ */
+function compressedSignature(payload, saltVersion = 0) {
+  const sig = new Uint8Array(2 + payload.length);
+  sig[0] = COMPRESSED_HEADER;
+  sig[1] = saltVersion;
+  sig.set(payload, 2);
+  return sig;
+}
+
+/**
+ * Number of 16-bit samples hash_to_point_vartime draws for a message: values
+ * of 5q and above are rejected until 1024 are accepted
+ */
+function hashToPointSamples(message, saltVersion = 0) {
+  const salt = new Uint8Array(40);
+  salt[0] = saltVersion;
+  salt[1] = 10;
+  salt.set(new TextEncoder().encode('FALCON_DET'), 2);
+
+  const out = createHash('shake256', { outputLength: 4096 }).update(salt).update(message).digest();
+  let accepted = 0;
+  let samples = 0;
+  for (let i = 0; i + 1 < out.length && accepted < N; i += 2) {
+    samples++;
+    if (((out[i] << 8) | out[i + 1]) < 5 * Q) accepted++;
+  }
+  return samples;
+}
+
+/**
+ * Mean, median, p99 and maximum of a list of nanosecond timings
+ */
+function summarize(times) {
+  const sorted = [...times].sort((a, b) => a - b);
+  const pick = (p) => sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+  return {
+    mean: times.reduce((a, b) => a + b, 0) / times.length,
+    p50: pick(0.5),
+    p99: pick(0.99),
+    max: sorted[sorted.length - 1],
+  };
+}
+
+/**
+ * Adversarial verification inputs. Every class goes through the public
+ * verify()/verifyConstantTime() entry points, so copies into WebAssembly
+ * memory are part of the cost, as they are for a verification endpoint.
+ */
+async function benchAdversarial({ samples, messageSize, grind }) {
+  const falcon = new Falcon(QUIET);
+  console.log('📊 Adversarial verification benchmark');
+  const { publicKey, secretKey } = await falcon.keypair();
+
+  const message = randomBytes(32);
+  const signature = await falcon.sign(message, secretKey);
+  const s2 = compDecode(signature.subarray(2));
+  if (!s2) throw new Error('Could not decode a freshly generated signature');
+
+  // Long message: cost grows with the hashing
+  const longMessage = randomBytes(messageSize);
+  const longSignature = await falcon.sign(longMessage, secretKey);
+
+  // Message ground for the most hash_to_point_vartime rejections
+  let ground = { message, samples: hashToPointSamples(message) };
+  for (let i = 0; i < grind; i++) {
+    const candidate = randomBytes(32);
+    const count = hashToPointSamples(candidate);
+    if (count > ground.samples) ground = { message: candidate, samples: count };
+  }
+  const groundSignature = await falcon.sign(ground.message, secretKey);
+
+  // Longest encoding within the signature size limit: |s2| grows by 128 (one
+  // more unary bit) round-robin until the payload fills the limit
+  const maxPayloadBits = (falcon._SIG_COMPRESSED_MAX - 2) * 8;
+  const longS2 = Int16Array.from({ length: N }, (_, i) => (i & 1 ? -127 : 127));
+  for (let bits = 9 * N, i = 0; bits < maxPayloadBits && i < 15 * N; bits++, i++) {
+    longS2[i % N] += longS2[i % N] < 0 ? -128 : 128;
+  }
+  const longEncoding = compressedSignature(compEncode(longS2));
+
+  // Longest encoding the decoder alone would accept: every |s2| = 2047
+  const maxS2 = Int16Array.from({ length: N }, (_, i) => (i & 1 ? -2047 : 2047));
+  const maxEncoding = compressedSignature(compEncode(maxS2));
+
+  // Valid encoding, one coefficient off: rejected only by the norm check
+  const perturbed = Int16Array.from(s2);
+  perturbed[N - 1] += perturbed[N - 1] < 2047 ? 1 : -1;
+  const perturbedSignature = compressedSignature(compEncode(perturbed));
+
+  // Malformed in the last coefficient: rejected after decoding everything
+  const lastZero = Int16Array.from(s2);
+  lastZero[N - 1] = 0;
+  const lateMalformed = compressedSignature(compEncode(lastZero, new Set([N - 1])));
+
+  // Valid signature followed by 64 KiB of padding
+  const oversized = new Uint8Array(signature.length + 65536);
+  oversized.set(signature);
+
+  // CT signature with the forbidden value -2048 as its last coefficient
+  const ctSignature = await falcon.convertToConstantTime(signature);
+  const ctForbidden = Uint8Array.from(ctSignature);
+  ctForbidden[ctForbidden.length - 2] = (ctForbidden[ctForbidden.length - 2] & 0xf0) | 0x08;
+  ctForbidden[ctForbidden.length - 1] = 0x00;
+
+  const classes = [
+    ['valid', (f) => f.verify(message, signature, publicKey)],
+    [`long message (${messageSize} B)`, (f) => f.verify(longMessage, longSignature, publicKey)],
+    [`hash rejections (${ground.samples} draws)`, (f) => f.verify(ground.message, groundSignature, publicKey)],
+    [`longest encoding (${longEncoding.length} B)`, (f) => f.verify(message, longEncoding, publicKey)],
+    [`over-limit encoding (${maxEncoding.length} B)`, (f) => f.verify(message, maxEncoding, publicKey)],
+    ['near-valid s2 (norm reject)', (f) => f.verify(message, perturbedSignature, publicKey)],
+    ['malformed last coefficient', (f) => f.verify(message, lateMalformed, publicKey)],
+    [`oversized (${oversized.length} B)`, (f) => f.verify(message, oversized, publicKey)],
+    ['CT valid', (f) => f.verifyConstantTime(message, ctSignature, publicKey)],
+    ['CT forbidden last value', (f) => f.verifyConstantTime(message, ctForbidden, publicKey)],
+  ];
+
+  // A fresh instance per class, so a trap in one class cannot skew the others
+  const results = [];
+  for (const [name, verify] of classes) {
+    const instance = new Falcon(QUIET);
+    try {
+      const accepted = await verify(instance);
+      // Warm-up until the optimizing WebAssembly tier has taken over
+      for (const until = performance.now() + 250; performance.now() < until;) await verify(instance);
+      const times = [];
+      for (let i = 0; i < samples; i++) {
+        const start = process.hrtime.bigint();
+        await verify(instance);
+        times.push(Number(process.hrtime.bigint() - start));
+      }
+      results.push({ name, result: accepted ? 'accept' : 'reject', ...summarize(times) });
+    } catch (error) {
+      results.push({ name, result: 'error', error: error.message });
+    }
+  }
+
+  console.log(`  ${'input class'.padEnd(36)} ${'result'.padEnd(8)} ${'mean'.padStart(10)} ${'p50'.padStart(10)} ${'p99'.padStart(10)} ${'max'.padStart(10)}`);
+  for (const r of results) {
+    if (r.error) {
+      console.log(`  ${r.name.padEnd(36)} ${r.result.padEnd(8)} ${r.error}`);
+      continue;
+    }
+    console.log(`  ${r.name.padEnd(36)} ${r.result.padEnd(8)} ${formatNs(r.mean).padStart(10)} ${formatNs(r.p50).padStart(10)} ${formatNs(r.p99).padStart(10)} ${formatNs(r.max).padStart(10)}`);
+  }
+  const worst = results.filter((r) => !r.error).reduce((a, b) => (b.p99 > a.p99 ? b : a));
+  console.log(`  Worst p99: ${worst.name} (${formatNs(worst.p99)}, max ${formatNs(worst.max)}; ${(worst.p99 / results[0].p99).toFixed(1)}x valid)`);
+  console.log(`  Expected hash_to_point draws: ${(N * 65536 / (5 * Q)).toFixed(0)}; worst of ${grind + 1} messages: ${ground.samples}`);
+}
+
+/**
+ * Size and startup cost of a build: instantiation alone, instantiation up to
+ * the end of a first sign (with a key generated beforehand), and the first
+ * and next keygen of each instance (the first pays any RNG setup).
+ */
+async function benchStartup({ module: modulePath, samples }) {
+  const jsPath = path.resolve(modulePath);
+  const wasmPath = jsPath.replace(/\.js$/, '.wasm');
+  const { default: factory } = await import(pathToFileURL(jsPath).href);
+  console.log(`📊 Startup benchmark (${path.relative(process.cwd(), jsPath) || jsPath})`);
+
+  const { secretKey } = await new Falcon(QUIET).keypair();
+  const message = new TextEncoder().encode('Falcon startup benchmark');
+
+  const instantiate = [];
+  const firstSign = [];
+  const firstKeygen = [];
+  const nextKeygen = [];
+  for (let i = 0; i < Math.min(samples, 20); i++) {
+    let start = process.hrtime.bigint();
+    const module = await factory(QUIET);
+    instantiate.push(Number(process.hrtime.bigint() - start));
+
+    const maxSig = module._get_sig_compressed_max_size();
+    const skPtr = module._malloc(secretKey.length);
+    const msgPtr = module._malloc(message.length);
+    const sigPtr = module._malloc(maxSig);
+    const sigLenPtr = module._malloc(4);
+    module.HEAPU8.set(secretKey, skPtr);
+    module.HEAPU8.set(message, msgPtr);
+    module.setValue(sigLenPtr, maxSig, 'i32');
+    if (module._falcon_det1024_sign_compressed_wrapper(sigPtr, sigLenPtr, skPtr, msgPtr, message.length) !== 0) {
+      throw new Error('Sign failed');
+    }
+    firstSign.push(Number(process.hrtime.bigint() - start));
+
+    const pkPtr = module._malloc(module._get_pk_size());
+    for (const times of [firstKeygen, nextKeygen]) {
+      start = process.hrtime.bigint();
+      if (module._falcon_det1024_keygen_wrapper(skPtr, pkPtr) !== 0) throw new Error('Keygen failed');
+      times.push(Number(process.hrtime.bigint() - start));
+    }
+    for (const ptr of [skPtr, pkPtr, msgPtr, sigPtr, sigLenPtr]) module._free(ptr);
+  }
+
+  console.log(`  falcon.wasm size       ${statSync(wasmPath).size} bytes`);
+  console.log(`  falcon.js size         ${statSync(jsPath).size} bytes`);
+  for (const [name, times] of [
+    ['instantiate', instantiate],
+    ['instantiate→sign', firstSign],
+    ['first keygen', firstKeygen],
+    ['next keygen', nextKeygen],
+  ]) {
+    const { p50, max } = summarize(times);
+    console.log(`  ${name.padEnd(22)} p50 ${formatNs(p50).padStart(10)}   max ${formatNs(max).padStart(10)}`);
+  }
+}
+
+/**
+ * Signing with secret keys loaded with 0 to 10 cached LDL-tree levels,
+ * against a plain loaded key (the whole tree rebuilt per signature)
+ */
+async function benchTree({ samples }) {
+  const falcon = new Falcon(QUIET);
+  console.log('📊 LDL-tree caching benchmark');
+
+  const { publicKey, secretKey } = await falcon.keypair();
+  const messages = Array.from({ length: samples }, (_, i) => `Falcon tree benchmark ${i}`);
+  const settings = [null];
+  if (await falcon.supportsTreeLevels()) {
+    for (let levels = 0; levels <= 10; levels++) settings.push(levels);
+  } else {
+    console.log('  falcon.wasm does not export partial-tree signing; rebuild it from falcon_wrapper.c');
+  }
+
+  let reference = null;
+  for (const treeLevels of settings) {
+    const key = await falcon.loadKey(secretKey, 'secret', { treeLevels });
+    try {
+      // Signatures must not depend on the setting
+      const check = await falcon.sign(messages[0], key);
+      reference ??= Falcon.bytesToHex(check);
+      if (Falcon.bytesToHex(check) !== reference || !(await falcon.verify(messages[0], check, publicKey))) {
+        throw new Error(`Signature mismatch with treeLevels ${treeLevels}`);
+      }
+
+      const warmupEnd = performance.now() + 250;
+      while (performance.now() < warmupEnd) await falcon.sign(messages[0], key);
+      const times = [];
+      for (const message of messages) {
+        const start = process.hrtime.bigint();
+        await falcon.sign(message, key);
+        times.push(Number(process.hrtime.bigint() - start));
+      }
+      const { p50, p99 } = summarize(times);
+      const name = treeLevels === null ? 'dynamic' : `${treeLevels} levels`;
+      console.log(`  ${name.padEnd(10)} ${`${(key.byteLength / 1024).toFixed(1)} KB/key`.padStart(14)}   p50 ${formatNs(p50).padStart(10)}   p99 ${formatNs(p99).padStart(10)}`);
+    } finally {
+      falcon.releaseKey(key);
+    }
+  }
+}
+
+/**
+ * Secret-key midstates on short messages. The key absorption a midstate
+ * skips is measured by signing messages longer by a multiple of the key
+ * size (the message is absorbed into both SHAKE256 states, the key into
+ * one); the check binding a midstate to its key runs on every such sign.
+ */
+async function benchMidstate({ samples, iterations }) {
+  const falcon = new Falcon(QUIET);
+  console.log('📊 Secret-key midstate benchmark');
+
+  const { publicKey, secretKey } = await falcon.keypair();
+  const short = new Uint8Array(32);
+  const blocks = 64;
+  const long = new Uint8Array(short.length + blocks * secretKey.length);
+  const sample = async (message, options) => {
+    const start = process.hrtime.bigint();
+    await falcon.sign(message, secretKey, options);
+    return Number(process.hrtime.bigint() - start);
+  };
+
+  // Interleaved, so drift affects both settings alike
+  const warmupEnd = performance.now() + 250;
+  while (performance.now() < warmupEnd) await falcon.sign(short, secretKey);
+  const shortTimes = [];
+  const longTimes = [];
+  for (let i = 0; i < samples; i++) {
+    shortTimes.push(await sample(short));
+    longTimes.push(await sample(long));
+  }
+  const absorbNs = Math.max(0, (summarize(longTimes).p50 - summarize(shortTimes).p50) / (2 * blocks));
+
+  // The check alone, on a midstate that is never signed with
+  const probe = new FalconKey(falcon, 'midstate', 0, 0);
+  probe.keyDigest = new Uint8Array(createHash('sha256').update(secretKey).digest());
+  const checkNs = await timeAsync(() => falcon._checkMidstate(probe, secretKey), iterations);
+  console.log(`  key absorption skipped ${formatNs(absorbNs).padStart(10)}   binding check ${formatNs(checkNs).padStart(10)}   net ${formatNs(absorbNs - checkNs).padStart(10)} per signature`);
+
+  if (!await falcon.supportsMidstates()) {
+    console.log('  falcon.wasm does not export midstates; rebuild it from falcon_wrapper.c to time signing with one');
+    return;
+  }
+  const midstate = await falcon.loadMidstate(secretKey);
+  try {
+    const signature = await falcon.sign(short, secretKey, { midstate });
+    if (!(await falcon.verify(short, signature, publicKey)) ||
+        Falcon.bytesToHex(signature) !== Falcon.bytesToHex(await falcon.sign(short, secretKey))) {
+      throw new Error('Midstate signature mismatch');
+    }
+    const plain = [];
+    const withMidstate = [];
+    for (let i = 0; i < samples; i++) {
+      plain.push(await sample(short));
+      withMidstate.push(await sample(short, { midstate }));
+    }
+    for (const [name, times] of [['plain', plain], ['midstate', withMidstate]]) {
+      const { p50, p99 } = summarize(times);
+      console.log(`  ${name.padEnd(10)} ${`${short.length} B message`.padStart(14)}   p50 ${formatNs(p50).padStart(10)}   p99 ${formatNs(p99).padStart(10)}`);
+    }
+  } finally {
+    falcon.releaseKey(midstate);
+  }
+}
+
+/**
+ * Hot keys verified between runs of one-off cold keys (a sweep over
+ * historical signatures), through a plain LRU key cache and one with TinyLFU
+ * admission
+ */
+async function benchCache({ samples }) {
+  const falcon = new Falcon(QUIET);
+  console.log('📊 Key cache scan-resistance benchmark');
+
+  const capacity = 16;
+  const hot = [];
+  for (let i = 0; i < 8; i++) {
+    const { publicKey, secretKey } = await falcon.keypair();
+    const message = `Falcon cache benchmark ${i}`;
+    hot.push({ message, publicKey, signature: await falcon.sign(message, secretKey) });
+  }
+  // Cold keys only need to be distinct; their verifications fail
+  const cold = Array.from({ length: samples * 10 }, () => randomBytes(1793));
+  console.log(`  ${hot.length} hot keys, ${cold.length} cold keys, capacity ${capacity}, hot round every 10 cold keys`);
+
+  for (const admission of [false, true]) {
+    const cache = new KeyCache(falcon, { capacity, admission });
+    const verify = async ({ message, signature, publicKey }) =>
+      falcon.verify(message, signature, await cache.get(keyFingerprint(publicKey), publicKey, 'public'));
+    for (let round = 0; round < 3; round++) {
+      for (const item of hot) await verify(item);
+    }
+
+    let hotHits = 0;
+    let hotLookups = 0;
+    const hotTimes = [];
+    const start = performance.now();
+    for (let i = 0; i < cold.length; i++) {
+      await verify({ message: hot[0].message, signature: hot[0].signature, publicKey: cold[i] });
+      if (i % 10 !== 9) continue;
+      for (const item of hot) {
+        const hits = cache.hits;
+        const t0 = process.hrtime.bigint();
+        await verify(item);
+        hotTimes.push(Number(process.hrtime.bigint() - t0));
+        hotHits += cache.hits - hits;
+        hotLookups++;
+      }
+    }
+    const elapsed = performance.now() - start;
+    const { p50, p99 } = summarize(hotTimes);
+    const { rejections, evictions } = cache.stats();
+    cache.clear();
+    console.log(`  ${(admission ? 'TinyLFU' : 'LRU').padEnd(8)} hot hit rate ${`${((hotHits / hotLookups) * 100).toFixed(1)}%`.padStart(6)}   hot p50 ${formatNs(p50).padStart(10)}   p99 ${formatNs(p99).padStart(10)}   ${evictions} evictions, ${rejections} rejected   total ${elapsed.toFixed(0)} ms`);
+  }
+}
+
+/**
+ * Synthetic production-like trace: a few hot signers and many verified
+ * keys with skewed popularity, small and large messages
+ */
+async function recordSyntheticTrace(samples) {
+  const falcon = new Falcon(QUIET);
+  const signers = [];
+  for (let i = 0; i < 4; i++) signers.push(await falcon.keypair());
+  const records = [];
+  for (let i = 0; i < 16; i++) {
+    const { publicKey, secretKey } = await falcon.keypair();
+    const message = randomBytes(i % 4 === 0 ? 4096 : 64);
+    records.push({ message, publicKey, signature: await falcon.sign(message, secretKey) });
+  }
+
+  falcon.startTrace();
+  for (let i = 0; i < samples; i++) {
+    if (i % 4 === 0) {
+      await falcon.sign(randomBytes(128), signers[i % signers.length].secretKey);
+    } else {
+      // Key i is drawn about twice as often as key 2i
+      const record = records[Math.min(records.length - 1, Math.floor(1 / Math.random()) - 1)];
+      await falcon.verify(record.message, record.signature, record.publicKey);
+    }
+    await new Promise((resolve) => setTimeout(resolve, Math.random() * 4));
+  }
+  return falcon.stopTrace();
+}
+
+/**
+ * One trace replayed against a single instance, a pool and a pool whose
+ * workers memoize results within a memory budget
+ */
+async function benchReplay({ samples, trace: file, speed, threads }) {
+  console.log('📊 Trace replay benchmark');
+  const trace = file ? JSON.parse(readFileSync(file, 'utf8')) : await recordSyntheticTrace(samples);
+  const replayer = new TraceReplayer(trace, { falcon: new Falcon(QUIET) });
+  const { keys, ms } = await replayer.prepare();
+  const profile = replayer.profile();
+  console.log(`  ${file ?? 'synthetic trace'}: ${trace.events.length} events, ${profile.distinctKeys} keys (reuse ${(profile.keyReuseRate * 100).toFixed(0)}%), repeated inputs ${(profile.inputRepeatRate * 100).toFixed(0)}%, ${keys} keypairs synthesized in ${ms.toFixed(0)} ms, speed ${speed}x`);
+
+  const backends = [
+    ['instance', () => new Falcon(QUIET)],
+    [`pool x${threads}`, () => new FalconPool({ size: threads })],
+    [`pool x${threads} + budget`, () => new FalconPool({ size: threads, memoryBudget: 8 << 20 })],
+  ];
+  for (const [name, create] of backends) {
+    const backend = create();
+    try {
+      const report = await replayer.replay(backend, { speed });
+      const { p50, p95, p99 } = report.latency;
+      const cache = report.cache ? `key cache hit rate ${(report.cache.hitRate * 100).toFixed(1)}%` : 'no key cache';
+      console.log(`  ${name.padEnd(20)} p50 ${formatNs(p50 * 1e6).padStart(10)}   p95 ${formatNs(p95 * 1e6).padStart(10)}   p99 ${formatNs(p99 * 1e6).padStart(10)}   ${report.throughput.toFixed(0).padStart(6)} ops/s   ${cache}${report.mismatches ? `   ${report.mismatches} mismatches` : ''}`);
+    } finally {
+      await backend.close?.();
+    }
+  }
+}
+
+/**
+ * File signing throughput: signFile/verifyFile (one copy, file to
+ * WebAssembly memory) against readFile + sign (file to Buffer, Buffer to
+ * WebAssembly memory)
+ */
+async function benchFile({ fileSize }) {
+  const falcon = new Falcon(QUIET);
+  console.log('📊 File signing benchmark');
+  const streaming = await falcon.supportsStreaming();
+  // Room for the file next to the keys and signing buffers
+  const inMemoryLimit = falcon._module.HEAPU8.byteLength - (2 << 20);
+  let size = fileSize ?? (streaming ? 1 << 30 : inMemoryLimit);
+  if (!streaming && size > inMemoryLimit) {
+    console.log(`  falcon.wasm has no streaming exports; files are limited to WebAssembly memory, using ${(inMemoryLimit / 1048576).toFixed(1)} MB`);
+    size = inMemoryLimit;
+  }
+
+  const dir = mkdtempSync(path.join(tmpdir(), 'falcon-bench-'));
+  const file = path.join(dir, 'payload.bin');
+  try {
+    const fd = openSync(file, 'w');
+    const block = randomBytes(Math.min(size, 1 << 24));
+    for (let written = 0; written < size; written += block.length) {
+      writeSync(fd, block, 0, Math.min(block.length, size - written));
+    }
+    closeSync(fd);
+    const { publicKey, secretKey } = await falcon.keypair();
+    const mb = size / 1048576;
+    console.log(`  ${mb.toFixed(1)} MB file, ${streaming ? 'streaming exports' : 'whole file in WebAssembly memory'}`);
+
+    const time = async (name, fn) => {
+      const start = performance.now();
+      const result = await fn();
+      const ms = performance.now() - start;
+      console.log(`  ${name.padEnd(22)} ${`${ms.toFixed(0)} ms`.padStart(10)}   ${`${(mb / (ms / 1000)).toFixed(0)} MB/s`.padStart(10)}`);
+      return result;
+    };
+    let signature = null;
+    if (size <= inMemoryLimit / 2) {
+      // The Buffer and its copy in WebAssembly memory must both fit
+      signature = await time('readFile + sign', async () => falcon.sign(readFileSync(file), secretKey));
+    }
+    const fileSignature = await time('signFile', () => falcon.signFile(file, secretKey));
+    if (signature && Falcon.bytesToHex(signature) !== Falcon.bytesToHex(fileSignature)) {
+      throw new Error('signFile and sign disagree');
+    }
+    const ok = await time('verifyFile', () => falcon.verifyFile(file, fileSignature, publicKey));
+    if (!ok) throw new Error('verifyFile rejected the file signature');
+  } finally {
+    rmSync(dir, { recursive: true, force: true });
+  }
+}
+
+const BENCHMARKS = {
+  decode: benchDecode,
+  adversarial: benchAdversarial,
+  startup: benchStartup,
+  tree: benchTree,
+  midstate: benchMidstate,
+  cache: benchCache,
+  replay: benchReplay,
+  file: benchFile,
+};
+
+async function main() {
+  const args = process.argv.slice(2);
+  const options = { iterations: 10000, samples: 100, messageSize: 1 << 20, grind: 2048, module: './falcon.js',
+    trace: null, speed: 1, threads: 2, fileSize: null };
+  const names = [];
+
+  for (let i = 0; i < args.length; i++) {
+    if (args[i] === '--iterations') options.iterations = parseInt(args[++i], 10);
+    else if (args[i] === '--samples') options.samples = parseInt(args[++i], 10);
+    else if (args[i] === '--message-size') options.messageSize = parseInt(args[++i], 10);
+    else if (args[i] === '--grind') options.grind = parseInt(args[++i], 10);
+    else if (args[i] === '--module') options.module = args[++i];
+    else if (args[i] === '--trace') options.trace = args[++i];
+    else if (args[i] === '--speed') options.speed = Number(args[++i]);
+    else if (args[i] === '--threads') options.threads = parseInt(args[++i], 10);
+    else if (args[i] === '--file-size') options.fileSize = parseInt(args[++i], 10);
+    else names.push(args[i]);
+  }
+
+  for (const name of names.length ? names : Object.keys(BENCHMARKS)) {
+    const bench = BENCHMARKS[name];
+    if (!bench) throw new Error(`Unknown benchmark: ${name} (available: ${Object.keys(BENCHMARKS).join(', ')})`);
+    await bench(options);
+  }
+}
+
+main().catch((error) => {
+  console.error('❌ Benchmark failed:', error);
+  process.exit(1);
+});
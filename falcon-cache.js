@@ -0,0 +1,801 @@
+/**
+ * Falcon Signatures - Caches for keys and midstates held in WebAssembly
+ * memory, memoized results, and the memory budget they can share
+ */
+import { createHash } from 'crypto';
+
+// Least-recently-used entries a cache compares when offering an eviction victim
+const EVICTION_SAMPLE = 8;
+
+// Approximate JavaScript overhead of one memoized result (Map entry, digest key, record)
+const RESULT_OVERHEAD = 160;
+
+// Default midstate cache share of WebAssembly memory (1/16), and the
+// allocator's overhead per midstate
+const MIDSTATE_HEAP_SHARE = 16;
+const MALLOC_OVERHEAD = 16;
+
+/**
+ * 32-bit FNV-1a hash of a string
+ * @param {string} str - String to hash
+ * @returns {number} Unsigned 32-bit hash
+ */
+function fnv1a(str) {
+  let h = 0x811c9dc5;
+  for (let i = 0; i < str.length; i++) {
+    h ^= str.charCodeAt(i);
+    h = Math.imul(h, 0x01000193);
+  }
+  return h >>> 0;
+}
+
+/**
+ * FrequencySketch - TinyLFU access-frequency estimate
+ *
+ * A doorkeeper Bloom filter absorbs the first access of each item, so items
+ * seen once never reach the Count-Min sketch (depth 4, counters saturating at
+ * 15). After `sampleSize` recorded accesses every counter is halved and the
+ * doorkeeper is cleared, so the estimates follow recent popularity.
+ */
+export class FrequencySketch {
+  /**
+   * Create a new sketch
+   * @param {number} capacity - Number of items the owning cache holds
+   */
+  constructor(capacity) {
+    let width = 64;
+    while (width < capacity * 4) width *= 2;
+    this._mask = width - 1;
+    this._counters = new Uint8Array(width * 4);
+    this.sampleSize = Math.max(100, capacity * 10);
+    // About 16 bits per access between resets: ~1.5% false positives with two hashes
+    let bits = 1024;
+    while (bits < this.sampleSize * 16) bits *= 2;
+    this._doorkeeper = new Uint32Array(bits / 32);
+    this._doorkeeperMask = bits - 1;
+    this._additions = 0;
+    this.resets = 0;
+  }
+
+  /**
+   * Record an access
+   * @param {string} item - Item key
+   */
+  increment(item) {
+    const h1 = fnv1a(item);
+    const h2 = (Math.imul(h1, 0x9e3779b1) >>> 0) | 1;
+    if (this._doorkeeperAdd(h1, h2)) {
+      for (let row = 0; row < 4; row++) {
+        const i = row * (this._mask + 1) + ((h1 + row * h2) & this._mask);
+        if (this._counters[i] < 15) this._counters[i]++;
+      }
+    }
+    if (++this._additions >= this.sampleSize) this._reset();
+  }
+
+  /**
+   * Estimated recent access count
+   * @param {string} item - Item key
+   * @returns {number} Estimate, counting the doorkeeper as one access
+   */
+  frequency(item) {
+    const h1 = fnv1a(item);
+    const h2 = (Math.imul(h1, 0x9e3779b1) >>> 0) | 1;
+    let min = 15;
+    for (let row = 0; row < 4; row++) {
+      min = Math.min(min, this._counters[row * (this._mask + 1) + ((h1 + row * h2) & this._mask)]);
+    }
+    return min + (this._doorkeeperHas(h1, h2) ? 1 : 0);
+  }
+
+  /**
+   * Set the doorkeeper bits of an item
+   * @private
+   * @returns {boolean} True if the item was already present
+   */
+  _doorkeeperAdd(h1, h2) {
+    let present = true;
+    for (const bit of [h1 & this._doorkeeperMask, (h1 + h2) & this._doorkeeperMask]) {
+      const mask = 1 << (bit & 31);
+      if ((this._doorkeeper[bit >>> 5] & mask) === 0) {
+        present = false;
+        this._doorkeeper[bit >>> 5] |= mask;
+      }
+    }
+    return present;
+  }
+
+  /**
+   * @private
+   */
+  _doorkeeperHas(h1, h2) {
+    const a = h1 & this._doorkeeperMask;
+    const b = (h1 + h2) & this._doorkeeperMask;
+    return (this._doorkeeper[a >>> 5] & (1 << (a & 31))) !== 0 && (this._doorkeeper[b >>> 5] & (1 << (b & 31))) !== 0;
+  }
+
+  /**
+   * Age the sketch: halve every counter and clear the doorkeeper
+   * @private
+   */
+  _reset() {
+    for (let i = 0; i < this._counters.length; i++) this._counters[i] >>= 1;
+    this._doorkeeper.fill(0);
+    this._additions = Math.floor(this._additions / 2);
+    this.resets++;
+  }
+}
+
+/**
+ * MemoryBudget - One byte budget shared by several caches
+ *
+ * Member caches report the bytes they hold and offer an eviction victim:
+ * one of their least recently used entries, with the time it took to
+ * compute (load a key, verify, sign) and its size. Whenever the total is
+ * over budget, the victim that is cheapest to recompute per byte is evicted,
+ * whichever cache holds it, so a large key that loads in microseconds goes
+ * before a small signature that took milliseconds to produce.
+ *
+ * A member implements `bytes`, `victim()` returning `{ costMs, bytes }` (or
+ * null when nothing may be evicted), `evict(victim)` returning the bytes
+ * freed, and `stats()`. KeyCache, MidstateCache and ResultCache join a
+ * budget through their `budget` option.
+ */
+export class MemoryBudget {
+  /**
+   * Create a new memory budget
+   * @param {number} maxBytes - Total bytes the member caches may hold
+   */
+  constructor(maxBytes) {
+    if (!(maxBytes > 0)) throw new Error('Memory budget must be a positive number of bytes');
+    this.maxBytes = maxBytes;
+    this._members = new Map();
+    this.evictions = 0;
+    this.evictedBytes = 0;
+  }
+
+  /**
+   * Add a cache to the budget
+   * @param {string} name - Name of the cache in stats()
+   * @param {Object} member - Cache implementing the member protocol
+   */
+  register(name, member) {
+    if (this._members.has(name)) throw new Error(`A cache named ${name} is already in the budget`);
+    this._members.set(name, { member, evictions: 0, evictedBytes: 0 });
+    this.enforce();
+  }
+
+  /**
+   * Remove a cache from the budget
+   * @param {string} name - Name it was registered under
+   */
+  unregister(name) {
+    this._members.delete(name);
+  }
+
+  /**
+   * Bytes held by all member caches
+   */
+  get bytes() {
+    let total = 0;
+    for (const { member } of this._members.values()) total += member.bytes;
+    return total;
+  }
+
+  /**
+   * Evict the entries cheapest to recompute per byte until the total fits
+   * @returns {number} Bytes freed
+   */
+  enforce() {
+    let excess = this.bytes - this.maxBytes;
+    let freed = 0;
+    while (excess > 0) {
+      let best = null;
+      let bestDensity = Infinity;
+      for (const record of this._members.values()) {
+        const victim = record.member.victim();
+        if (!victim) continue;
+        const density = victim.costMs / Math.max(1, victim.bytes);
+        if (density < bestDensity) {
+          best = { record, victim };
+          bestDensity = density;
+        }
+      }
+      // Only entries that may still be in use are left
+      if (!best) break;
+
+      const bytes = best.record.member.evict(best.victim);
+      best.record.evictions++;
+      best.record.evictedBytes += bytes;
+      this.evictions++;
+      this.evictedBytes += bytes;
+      excess -= bytes;
+      freed += bytes;
+    }
+    return freed;
+  }
+
+  /**
+   * Combined statistics of the budget and every member cache
+   * @returns {Object} Budget totals and, per cache, its own stats plus budget evictions
+   */
+  stats() {
+    const caches = {};
+    for (const [name, { member, evictions, evictedBytes }] of this._members) {
+      caches[name] = { ...member.stats(), budgetEvictions: evictions, budgetEvictedBytes: evictedBytes };
+    }
+    const bytes = this.bytes;
+    return {
+      maxBytes: this.maxBytes,
+      bytes,
+      utilization: bytes / this.maxBytes,
+      evictions: this.evictions,
+      evictedBytes: this.evictedBytes,
+      caches,
+    };
+  }
+}
+
+/**
+ * Pick the cheapest entry per byte among the least recently used ones
+ * @param {Iterator<Array>} entries - [key, entry] pairs in LRU order
+ * @param {number} count - Entries that may be considered
+ * @param {Function} measure - Maps an entry to { costMs, bytes }
+ * @returns {Object|null} { key, costMs, bytes } or null
+ */
+function cheapestPerByte(entries, count, measure) {
+  let best = null;
+  for (let i = 0; i < Math.min(count, EVICTION_SAMPLE); i++) {
+    const [key, entry] = entries.next().value;
+    const { costMs, bytes } = measure(key, entry);
+    if (!best || costMs / Math.max(1, bytes) < best.costMs / Math.max(1, best.bytes)) {
+      best = { key, costMs, bytes };
+    }
+  }
+  return best;
+}
+
+/**
+ * KeyCache - LRU cache of loaded Falcon keys (see Falcon.loadKey)
+ *
+ * Entries are keyed by a key fingerprint; a hit is only reported when the
+ * cached key also matches the caller's key bytes, so fingerprint collisions
+ * can never select the wrong key. Evicted keys are released (secret keys are
+ * zeroized first), so a key returned by get() must not be used after a later
+ * get() call; process operations serially per cache.
+ *
+ * With admission (the default), a TinyLFU frequency sketch decides which
+ * missed keys are loaded: a key is loaded only once it has been seen before,
+ * and, when the cache is full, only if it is used more often than the LRU
+ * key it would evict. A rejected key is returned as its bytes, which every
+ * Falcon operation accepts, so a scan over many cold keys cannot flush the
+ * hot ones.
+ *
+ * In a MemoryBudget, each key's load time is its recompute cost. The most
+ * recently returned key is never offered for eviction, since the caller may
+ * still be using it.
+ */
+export class KeyCache {
+  /**
+   * Create a new key cache
+   * @param {Falcon} falcon - Falcon instance that owns the loaded keys
+   * @param {Object} options - Cache options
+   * @param {number} options.capacity - Maximum number of loaded keys (default: 64)
+   * @param {number} options.treeLevels - LDL-tree levels cached per secret key (default: none, see Falcon.loadKey)
+   * @param {boolean} options.admission - Filter loads through a TinyLFU sketch (default: true; false is plain LRU)
+   * @param {MemoryBudget} options.budget - Shared memory budget to join (default: none)
+   * @param {string} options.name - Name in the budget (default: 'keys')
+   */
+  constructor(falcon, { capacity = 64, treeLevels = null, admission = true, budget = null, name = 'keys' } = {}) {
+    this.falcon = falcon;
+    this.capacity = capacity;
+    this.treeLevels = treeLevels;
+    this.bytes = 0;
+    this._entries = new Map();
+    this._loadMs = new Map();
+    this._sketch = admission ? new FrequencySketch(capacity) : null;
+    this.hits = 0;
+    this.misses = 0;
+    this.evictions = 0;
+    this.rejections = 0;
+    this.budget = budget;
+    budget?.register(name, this);
+  }
+
+  /**
+   * Number of keys currently loaded
+   */
+  get size() {
+    return this._entries.size;
+  }
+
+  /**
+   * Get the loaded key for a fingerprint, loading it on a miss
+   * @param {string} fingerprint - Key fingerprint
+   * @param {Uint8Array} bytes - Key bytes
+   * @param {'secret'|'public'} type - Key type
+   * @returns {Promise<FalconKey|Uint8Array>} Loaded key, or the key bytes if admission turned it away
+   */
+  async get(fingerprint, bytes, type) {
+    const cacheKey = `${type}:${fingerprint}`;
+    const entry = this._entries.get(cacheKey);
+    this._sketch?.increment(cacheKey);
+
+    if (entry && entry.matches(bytes)) {
+      // Refresh LRU position
+      this._entries.delete(cacheKey);
+      this._entries.set(cacheKey, entry);
+      this.hits++;
+      return entry;
+    }
+
+    this.misses++;
+    if (entry) this._delete(cacheKey);
+    if (this._sketch && !this._admit(cacheKey)) {
+      this.rejections++;
+      return bytes;
+    }
+
+    const start = performance.now();
+    const key = await this.falcon.loadKey(bytes, type, { treeLevels: this.treeLevels });
+    const loadMs = performance.now() - start;
+    // A concurrent miss may have loaded the same key meanwhile
+    if (this._entries.has(cacheKey)) this._delete(cacheKey);
+    this._entries.set(cacheKey, key);
+    this._loadMs.set(cacheKey, loadMs);
+    this.bytes += key.byteLength;
+    while (this._entries.size > this.capacity) {
+      this._delete(this._entries.keys().next().value);
+      this.evictions++;
+    }
+    this.budget?.enforce();
+    return key;
+  }
+
+  /**
+   * Release every loaded key
+   */
+  clear() {
+    for (const cacheKey of Array.from(this._entries.keys())) {
+      this._delete(cacheKey);
+    }
+  }
+
+  /**
+   * Budget member: the cheapest key per byte among the least recently used,
+   * excluding the most recently returned one
+   * @returns {Object|null} { key, costMs, bytes } or null
+   */
+  victim() {
+    if (this._entries.size < 2) return null;
+    return cheapestPerByte(this._entries.entries(), this._entries.size - 1, (cacheKey, key) => ({
+      costMs: this._loadMs.get(cacheKey),
+      bytes: key.byteLength,
+    }));
+  }
+
+  /**
+   * Budget member: release a victim
+   * @param {Object} victim - Victim from victim()
+   * @returns {number} WebAssembly bytes freed
+   */
+  evict(victim) {
+    const before = this.bytes;
+    this._delete(victim.key);
+    this.evictions++;
+    return before - this.bytes;
+  }
+
+  /**
+   * Cache statistics
+   * @returns {Object} Hits, misses, evictions, admission rejections, size, WebAssembly bytes held and hit rate
+   */
+  stats() {
+    const lookups = this.hits + this.misses;
+    return {
+      size: this._entries.size,
+      capacity: this.capacity,
+      hits: this.hits,
+      misses: this.misses,
+      evictions: this.evictions,
+      rejections: this.rejections,
+      bytes: this.bytes,
+      hitRate: lookups === 0 ? 0 : this.hits / lookups,
+    };
+  }
+
+  /**
+   * TinyLFU admission: seen before, and more popular than the eviction victim
+   * @private
+   */
+  _admit(cacheKey) {
+    const frequency = this._sketch.frequency(cacheKey);
+    if (frequency < 2) return false;
+    if (this._entries.size < this.capacity) return true;
+    return frequency > this._sketch.frequency(this._entries.keys().next().value);
+  }
+
+  /**
+   * Remove and release an entry
+   * @private
+   */
+  _delete(cacheKey) {
+    const key = this._entries.get(cacheKey);
+    this._entries.delete(cacheKey);
+    this._loadMs.delete(cacheKey);
+    if (key) {
+      this.bytes -= key.byteLength;
+      this.falcon.releaseKey(key);
+    }
+  }
+}
+
+/**
+ * MidstateCache - LRU cache of secret-key midstates (see Falcon.loadMidstate)
+ *
+ * A midstate is the signing RNG state after the secret key has been absorbed:
+ * 208 bytes of WebAssembly memory, against about 35 KB for an expanded key,
+ * so thousands fit where a key cache holds a few. It serves the keys a
+ * KeyCache turns away or has evicted: signing with their bytes then skips
+ * re-absorbing the key. Entries are keyed by the caller's key fingerprint
+ * (see keyFingerprint), or else by the SHA-256 digest of the key; either
+ * way Falcon.sign checks the midstate against the key's own digest, so a
+ * colliding entry fails the signature instead of using another key. Evicted
+ * midstates are zeroized and released, so the midstate returned by get()
+ * must not be used after a later get() call.
+ *
+ * WebAssembly memory is fixed, so by default the cache holds at most 1/16 of
+ * it (about 4,700 midstates of a 16 MB instance), leaving the rest to loaded
+ * keys and signing. A midstate that cannot be allocated is not cached, and
+ * get() returns null so the caller signs without one.
+ */
+export class MidstateCache {
+  /**
+   * Create a new midstate cache
+   * @param {Falcon} falcon - Falcon instance that owns the midstates
+   * @param {Object} options - Cache options
+   * @param {number} options.capacity - Maximum number of midstates (default: 1/16 of WebAssembly memory)
+   * @param {MemoryBudget} options.budget - Shared memory budget to join (default: none)
+   * @param {string} options.name - Name in the budget (default: 'midstates')
+   */
+  constructor(falcon, { capacity = null, budget = null, name = 'midstates' } = {}) {
+    this.falcon = falcon;
+    this.capacity = capacity;
+    this.bytes = 0;
+    this._entries = new Map();
+    this._loadMs = new Map();
+    this.hits = 0;
+    this.misses = 0;
+    this.evictions = 0;
+    this.allocationFailures = 0;
+    // Whether the build has the midstate exports, once known
+    this._supported = null;
+    this.budget = budget;
+    budget?.register(name, this);
+  }
+
+  /**
+   * Number of midstates currently held
+   */
+  get size() {
+    return this._entries.size;
+  }
+
+  /**
+   * Get the midstate of a secret key, computing it on a miss
+   * @param {Uint8Array} secretKey - Secret key bytes
+   * @param {string} fingerprint - Fingerprint of the key, if the caller has one (default: hash the key)
+   * @returns {Promise<FalconKey|null>} Midstate for Falcon.sign, or null if the
+   *   cache is disabled, the build has no midstate exports or memory is exhausted
+   */
+  async get(secretKey, fingerprint = null) {
+    if ((this.capacity !== null && this.capacity <= 0) || this._supported === false) return null;
+    // Without the exports there is nothing to cache, so skip hashing the key
+    this._supported ??= await this.falcon.supportsMidstates();
+    if (!this._supported) return null;
+    // Signing hashes the key once more to check the midstate, so a routed
+    // request's fingerprint spares a second hash here
+    const digest = fingerprint ?? createHash('sha256').update(secretKey).digest('base64');
+    const entry = this._entries.get(digest);
+    if (entry) {
+      // Refresh LRU position
+      this._entries.delete(digest);
+      this._entries.set(digest, entry);
+      this.hits++;
+      return entry;
+    }
+
+    this.misses++;
+    const start = performance.now();
+    let midstate;
+    try {
+      midstate = await this.falcon.loadMidstate(secretKey);
+    } catch (error) {
+      if (!/Out of WebAssembly memory/.test(error.message)) throw error;
+      this.allocationFailures++;
+      return null;
+    }
+    if (!midstate) return null;
+    // A concurrent miss may have computed the same midstate meanwhile; keep
+    // that one, which its caller may be signing with
+    const existing = this._entries.get(digest);
+    if (existing) {
+      this.falcon.releaseKey(midstate);
+      return existing;
+    }
+    this.capacity ??= Math.floor(this.falcon.lifecycleStats().memoryBytes / MIDSTATE_HEAP_SHARE /
+      (midstate.byteLength + MALLOC_OVERHEAD));
+    this._entries.set(digest, midstate);
+    this._loadMs.set(digest, performance.now() - start);
+    this.bytes += midstate.byteLength;
+    while (this._entries.size > this.capacity) {
+      this._delete(this._entries.keys().next().value);
+      this.evictions++;
+    }
+    this.budget?.enforce();
+    return midstate;
+  }
+
+  /**
+   * Release every midstate
+   */
+  clear() {
+    for (const digest of Array.from(this._entries.keys())) {
+      this._delete(digest);
+    }
+  }
+
+  /**
+   * Budget member: the cheapest midstate per byte among the least recently
+   * used, excluding the most recently returned one
+   * @returns {Object|null} { key, costMs, bytes } or null
+   */
+  victim() {
+    if (this._entries.size < 2) return null;
+    return cheapestPerByte(this._entries.entries(), this._entries.size - 1, (digest, midstate) => ({
+      costMs: this._loadMs.get(digest),
+      bytes: midstate.byteLength,
+    }));
+  }
+
+  /**
+   * Budget member: release a victim
+   * @param {Object} victim - Victim from victim()
+   * @returns {number} WebAssembly bytes freed
+   */
+  evict(victim) {
+    const before = this.bytes;
+    this._delete(victim.key);
+    this.evictions++;
+    return before - this.bytes;
+  }
+
+  /**
+   * Cache statistics
+   * @returns {Object} Hits, misses, evictions, size, WebAssembly bytes held and hit rate
+   */
+  stats() {
+    const lookups = this.hits + this.misses;
+    return {
+      size: this._entries.size,
+      capacity: this.capacity,
+      hits: this.hits,
+      misses: this.misses,
+      evictions: this.evictions,
+      allocationFailures: this.allocationFailures,
+      bytes: this.bytes,
+      hitRate: lookups === 0 ? 0 : this.hits / lookups,
+    };
+  }
+
+  /**
+   * Remove and release an entry
+   * @private
+   */
+  _delete(digest) {
+    const midstate = this._entries.get(digest);
+    this._entries.delete(digest);
+    this._loadMs.delete(digest);
+    if (midstate) {
+      this.bytes -= midstate.byteLength;
+      this.falcon.releaseKey(midstate);
+    }
+  }
+}
+
+/**
+ * ResultCache - LRU memo of verification results and signatures
+ *
+ * Entries are keyed by a SHA-256 digest of the operation and its inputs, so
+ * a repeated verify of the same (message, signature, public key), or a
+ * repeated sign of the same message with the same secret key, is answered
+ * without running Falcon. Signing is deterministic (Falcon-1024 det), so a
+ * memoized signature is the one a fresh sign() would return. Only
+ * successful results are kept; errors are thrown to every caller.
+ *
+ * In a MemoryBudget, each entry's recompute cost is the time the operation
+ * took and its size is the signature plus a fixed per-entry overhead.
+ */
+export class ResultCache {
+  /**
+   * Create a new result cache
+   * @param {Falcon} falcon - Falcon instance that computes missing results
+   * @param {Object} options - Cache options
+   * @param {number} options.maxEntries - Maximum number of memoized results (default: 4096)
+   * @param {MemoryBudget} options.budget - Shared memory budget to join (default: none)
+   * @param {string} options.name - Name in the budget (default: 'results')
+   */
+  constructor(falcon, { maxEntries = 4096, budget = null, name = 'results' } = {}) {
+    this.falcon = falcon;
+    this.maxEntries = maxEntries;
+    this.bytes = 0;
+    this._entries = new Map();
+    this.hits = 0;
+    this.misses = 0;
+    this.evictions = 0;
+    this.budget = budget;
+    budget?.register(name, this);
+  }
+
+  /**
+   * Number of memoized results
+   */
+  get size() {
+    return this._entries.size;
+  }
+
+  /**
+   * Memoized Falcon.verify
+   * @param {Uint8Array|string} message - The message (string or Uint8Array)
+   * @param {Uint8Array|string} signature - The compressed signature (Uint8Array or hex string)
+   * @param {Uint8Array|string|FalconKey} publicKey - The public key (Uint8Array, hex string or loaded key)
+   * @returns {Promise<boolean>} True if the signature is valid
+   */
+  verify(message, signature, publicKey) {
+    return this.memo('verify', [message, signature, publicKey], () => this.falcon.verify(message, signature, publicKey));
+  }
+
+  /**
+   * Memoized Falcon.verifyConstantTime
+   * @param {Uint8Array|string} message - The message (string or Uint8Array)
+   * @param {Uint8Array|string} signature - The constant-time signature (Uint8Array or hex string)
+   * @param {Uint8Array|string|FalconKey} publicKey - The public key (Uint8Array, hex string or loaded key)
+   * @returns {Promise<boolean>} True if the signature is valid
+   */
+  verifyConstantTime(message, signature, publicKey) {
+    return this.memo('verifyCT', [message, signature, publicKey], () => this.falcon.verifyConstantTime(message, signature, publicKey));
+  }
+
+  /**
+   * Memoized Falcon.sign
+   * @param {Uint8Array|string} message - The message to sign (string or Uint8Array)
+   * @param {Uint8Array|string|FalconKey} secretKey - The secret key (Uint8Array, hex string or loaded key)
+   * @returns {Promise<Uint8Array>} The compressed signature (a copy the caller may keep)
+   */
+  async sign(message, secretKey) {
+    return (await this.memo('sign', [message, secretKey], () => this.falcon.sign(message, secretKey))).slice();
+  }
+
+  /**
+   * Forget every memoized result
+   */
+  clear() {
+    this._entries.clear();
+    this.bytes = 0;
+  }
+
+  /**
+   * Budget member: the cheapest result per byte among the least recently used
+   * @returns {Object|null} { key, costMs, bytes } or null
+   */
+  victim() {
+    if (this._entries.size === 0) return null;
+    return cheapestPerByte(this._entries.entries(), this._entries.size, (digest, entry) => entry);
+  }
+
+  /**
+   * Budget member: forget a victim
+   * @param {Object} victim - Victim from victim()
+   * @returns {number} Bytes freed
+   */
+  evict(victim) {
+    const before = this.bytes;
+    this._delete(victim.key);
+    this.evictions++;
+    return before - this.bytes;
+  }
+
+  /**
+   * Cache statistics
+   * @returns {Object} Hits, misses, evictions, size, bytes held and hit rate
+   */
+  stats() {
+    const lookups = this.hits + this.misses;
+    return {
+      size: this._entries.size,
+      capacity: this.maxEntries,
+      hits: this.hits,
+      misses: this.misses,
+      evictions: this.evictions,
+      bytes: this.bytes,
+      hitRate: lookups === 0 ? 0 : this.hits / lookups,
+    };
+  }
+
+  /**
+   * Look up a result, computing and storing it on a miss. The stored value
+   * is returned as is (not copied) to every caller.
+   * @param {string} op - Operation name, part of the key
+   * @param {Array<Uint8Array|string|FalconKey>} inputs - Operation inputs, part of the key
+   * @param {Function} compute - Produces the result on a miss
+   * @returns {Promise<*>} The memoized or computed result
+   */
+  async memo(op, inputs, compute) {
+    const digest = this._digest(op, inputs);
+    const entry = this._entries.get(digest);
+    if (entry) {
+      // Refresh LRU position
+      this._entries.delete(digest);
+      this._entries.set(digest, entry);
+      this.hits++;
+      return entry.value;
+    }
+
+    this.misses++;
+    const start = performance.now();
+    const value = await compute();
+    const costMs = performance.now() - start;
+    if (this._entries.has(digest)) this._delete(digest);
+    const bytes = RESULT_OVERHEAD + (value instanceof Uint8Array ? value.length : 0);
+    this._entries.set(digest, { value, costMs, bytes });
+    this.bytes += bytes;
+    while (this._entries.size > this.maxEntries) {
+      this._delete(this._entries.keys().next().value);
+      this.evictions++;
+    }
+    this.budget?.enforce();
+    return value;
+  }
+
+  /**
+   * SHA-256 of an operation and its inputs, each prefixed with its kind
+   * (strings are hex for keys and signatures, so they never share a digest
+   * with byte arrays) and length
+   * @private
+   */
+  _digest(op, inputs) {
+    const hash = createHash('sha256').update(op);
+    const prefix = Buffer.alloc(5);
+    for (const input of inputs) {
+      const bytes = typeof input === 'string' ? Buffer.from(input)
+        : input?.ptr !== undefined ? this._loadedKeyBytes(input)
+        : input;
+      prefix[0] = typeof input === 'string' ? 1 : 0;
+      prefix.writeUInt32BE(bytes.length, 1);
+      hash.update(prefix).update(bytes);
+    }
+    return hash.digest('latin1');
+  }
+
+  /**
+   * Bytes of a loaded key, read from WebAssembly memory
+   * @private
+   */
+  _loadedKeyBytes(key) {
+    if (key.released) throw new Error('Key has been released');
+    return key.falcon._module.HEAPU8.subarray(key.ptr, key.ptr + key.length);
+  }
+
+  /**
+   * @private
+   */
+  _delete(digest) {
+    const entry = this._entries.get(digest);
+    if (entry) {
+      this._entries.delete(digest);
+      this.bytes -= entry.bytes;
+    }
+  }
+}
+
+export default KeyCache;
@@ -2,6 +2,7 @@
 import { execSync } from "child_process";
 import fs from "fs";
 import Falcon from "./index.js";
+import { Keyring } from "./falcon-keyring.js";
 
 // File paths for keys and signatures
 const PK_FILE = "falcon_pk.bin";
@@ -10,6 +11,7 @@ const SIG_COMPRESSED_FILE = "falcon_sig_compressed.bin";
 const SIG_CT_FILE = "falcon_sig_ct.bin";
 const SIG_COMPRESSED_HEX_FILE = "falcon_sig_compressed_hex.txt";
 const SIG_CT_HEX_FILE = "falcon_sig_ct_hex.txt";
+const KEYRING_FILE = "falcon_test_keyring.bin";
 
 function run(cmd) {
   console.log(`\n> ${cmd}`);
@@ -161,6 +163,43 @@ try {
     console.warn("Warning: Signatures are not deterministic for the same message and key!");
   }
   
+  // Step 8: Bulk keygen into a keyring file
+  console.log("\n=== Step 8: Bulk keygen into a keyring ===");
+  const bulkOutput = run(`node ./falcon-cli.js keygen --count 6 --jobs 2 --out ${KEYRING_FILE}`);
+  console.log(bulkOutput);
+  if (!/Generated 6 keypairs in .* keys\/sec/.test(bulkOutput)) {
+    throw new Error("Bulk keygen did not report its throughput");
+  }
+
+  const keyring = new Keyring(KEYRING_FILE);
+  try {
+    if (keyring.count !== 6) {
+      throw new Error(`Keyring should hold 6 keypairs, found ${keyring.count}`);
+    }
+    const publicKeys = new Set();
+    for (let i = 0; i < keyring.count; i++) {
+      const { publicKey, secretKey } = keyring.get(i);
+      publicKeys.add(Falcon.bytesToHex(publicKey));
+      if (keyring.findByPublicKey(publicKey) !== i) {
+        throw new Error(`Keyring index should locate entry ${i}`);
+      }
+      const keyringSig = await falcon.sign(msg, secretKey);
+      if (!(await falcon.verify(msg, keyringSig, publicKey))) {
+        throw new Error(`Keyring entry ${i} is not a valid keypair`);
+      }
+    }
+    if (publicKeys.size !== 6) {
+      throw new Error("Keyring keypairs should be distinct");
+    }
+    if (keyring.findByPublicKey(pkFromFile) !== -1) {
+      throw new Error("Keyring should not contain an unrelated key");
+    }
+    console.log(`Keyring holds ${keyring.count} distinct, valid keypairs`);
+  } finally {
+    keyring.close();
+    fs.unlinkSync(KEYRING_FILE);
+  }
+
   console.log("\n=== All tests passed successfully! ===");
   console.log("✅ Key generation works");
   console.log("✅ Compressed signature generation works");
@@ -169,6 +208,7 @@ try {
   console.log("✅ Constant-time signature verification works");
   console.log("✅ Salt version retrieval works");
   console.log("✅ Deterministic signatures confirmed");
+  console.log("✅ Bulk keygen into a keyring works");
 } catch (e) {
   console.error("\n❌ Test failed:", e.message);
   process.exit(1);
@@ -1,8 +1,11 @@
 #!/usr/bin/env node
 import fs from "fs";
 import path from "path";
+import os from "os";
 import process from "process";
 import Falcon from "./index.js";
+import { FalconPool } from "./falcon-pool.js";
+import { KeyringWriter } from "./falcon-keyring.js";
 
 async function main() {
   const args = process.argv.slice(2);
@@ -19,7 +22,7 @@ async function main() {
   try {
     switch (cmd) {
       case "keygen":
-        await handleKeygen(falcon);
+        await handleKeygen(falcon, args);
         break;
       case "sign":
         await handleSign(falcon, args);
@@ -49,19 +52,26 @@ function printUsage() {
   console.log("");
   console.log("Usage:");
   console.log("  node falcon-cli.js keygen");
+  console.log("  node falcon-cli.js keygen --count <n> [--jobs <j>] [--out <keyring.bin>]");
   console.log("  node falcon-cli.js sign <message> <hex_sk>");
   console.log("  node falcon-cli.js verify <message> <hex_sig> <hex_pk>");
   console.log("  node falcon-cli.js convert <hex_compressed_sig>");
   console.log("");
   console.log("Options:");
   console.log("  keygen    Generate a new Falcon-1024 keypair");
+  console.log("            With --count, generate n keypairs on j worker threads into one keyring file");
   console.log("  sign      Sign a message using a secret key (produces compressed signature)");
   console.log("  verify    Verify a signature (compressed or CT) using a public key");
   console.log("  convert   Convert a compressed signature to constant-time format");
   console.log("  help      Show this help message");
 }
 
-async function handleKeygen(falcon) {
+async function handleKeygen(falcon, args) {
+  if (args.length > 1) {
+    await handleBulkKeygen(args);
+    return;
+  }
+
   console.log("🔑 Generating Falcon-1024 deterministic keypair...");
   
   // Generate keypair
@@ -94,6 +104,68 @@ async function handleKeygen(falcon) {
   console.log("Keys saved to falcon_pk.bin and falcon_sk.bin");
 }
 
+async function handleBulkKeygen(args) {
+  const options = { count: 0, jobs: os.availableParallelism?.() ?? os.cpus().length, out: "keyring.bin" };
+  for (let i = 1; i < args.length; i++) {
+    const name = args[i].replace(/^--/, "");
+    if (!(name in options) || i + 1 >= args.length) {
+      console.error(`Error: Unknown or incomplete keygen option: ${args[i]}`);
+      console.log("Usage: node falcon-cli.js keygen --count <n> [--jobs <j>] [--out <keyring.bin>]");
+      process.exit(1);
+    }
+    options[name] = name === "out" ? args[++i] : parseInt(args[++i], 10);
+  }
+  const { count, jobs, out } = options;
+  if (!(count > 0) || !(jobs > 0)) {
+    console.error("Error: --count and --jobs must be positive integers");
+    process.exit(1);
+  }
+
+  console.log(`🔑 Generating ${count} Falcon-1024 keypairs on ${jobs} workers into ${out}...`);
+
+  const pool = new FalconPool({ size: Math.min(jobs, count) });
+  const writer = new KeyringWriter(out);
+  const start = performance.now();
+  let requested = 0;
+  let done = 0;
+  let lastReport = 0;
+
+  const report = () => {
+    const seconds = (performance.now() - start) / 1000;
+    const line = `  ${done}/${count} keys (${(done / seconds).toFixed(1)} keys/sec)`;
+    if (process.stdout.isTTY) process.stdout.write(`\r${line}`);
+    else console.log(line);
+  };
+
+  // Each lane keeps one request outstanding; two lanes per worker keep the
+  // workers busy while results are written to the keyring in arrival order
+  const lane = async () => {
+    while (requested < count) {
+      requested++;
+      const { publicKey, secretKey } = await pool.keypair();
+      writer.append(publicKey, secretKey);
+      done++;
+      if (done === count || performance.now() - lastReport > 1000) {
+        lastReport = performance.now();
+        report();
+      }
+    }
+  };
+
+  try {
+    await Promise.all(Array.from({ length: Math.min(count, jobs * 2) }, lane));
+    writer.close();
+  } finally {
+    await pool.close();
+  }
+  if (process.stdout.isTTY) process.stdout.write("\n");
+
+  const seconds = (performance.now() - start) / 1000;
+  console.log("Keygen completed successfully");
+  console.log(`Generated ${count} keypairs in ${seconds.toFixed(2)} s (${(count / seconds).toFixed(1)} keys/sec)`);
+  console.log(`Keyring saved to ${out} (${fs.statSync(out).size} bytes)`);
+}
+
 async function handleSign(falcon, args) {
   if (args.length < 3) {
     console.error("Error: Missing arguments for sign command");
@@ -0,0 +1,117 @@
+#!/usr/bin/env node
+import Falcon from './index.js';
+import { FalconCluster } from './falcon-cluster.js';
+import { keyFingerprint } from './falcon-pool.js';
+import { strict as assert } from 'assert';
+
+/**
+ * Test the FalconCluster multi-process shards
+ */
+async function runTests() {
+  console.log('🧪 Testing FalconCluster implementation...');
+
+  const falcon = new Falcon();
+  const cluster = new FalconCluster({ shards: 2, threadsPerShard: 1, keyCacheSize: 16 });
+
+  try {
+    // Results must match the single-instance API
+    console.log('- Testing cluster keypair/sign/verify...');
+    const { publicKey, secretKey } = await cluster.keypair();
+    assert.equal(publicKey.length, 1793, 'Public key should be 1793 bytes');
+    assert.equal(secretKey.length, 2305, 'Secret key should be 2305 bytes');
+
+    const message = 'This is a test message for the Falcon cluster';
+    const signature = await cluster.sign(message, secretKey);
+    assert.deepEqual(signature, await falcon.sign(message, secretKey), 'Cluster signature should match direct signature');
+    assert.equal(await cluster.verify(message, signature, publicKey), true, 'Cluster should verify its signature');
+    assert.equal(await cluster.verify('tampered', signature, publicKey), false, 'Tampered message should not verify');
+
+    const ctSignature = await cluster.convertToConstantTime(signature);
+    assert.equal(await cluster.verifyConstantTime(message, ctSignature, Falcon.bytesToHex(publicKey)), true,
+      'Constant-time signature should verify with a hex public key');
+    await assert.rejects(cluster.sign(message, new Uint8Array(10)), /Invalid secret key length/);
+    console.log('  ✓ Cluster results match direct Falcon operations');
+
+    // Every key is loaded by exactly one shard
+    console.log('- Testing pk-hash routing...');
+    const keys = [];
+    for (let i = 0; i < 8; i++) {
+      const pair = await falcon.keypair();
+      keys.push({ ...pair, signature: await falcon.sign(`routed ${i}`, pair.secretKey) });
+    }
+    // Admission loads a key on its second use, so hits start in the third round
+    for (let round = 0; round < 5; round++) {
+      const results = await Promise.all(keys.map((key, i) => cluster.verify(`routed ${i}`, key.signature, key.publicKey)));
+      assert(results.every(Boolean), 'Every routed signature should verify');
+    }
+    let stats = await cluster.stats();
+    assert.equal(stats.size, 2, 'Cluster should have two shards');
+    // Plus the first public key; its secret key was used once, so admission did not load it
+    assert.equal(stats.cachedKeys, keys.length + 1, 'Each key should be cached by exactly one shard');
+    assert(stats.shards.every((shard) => shard.routed > 0), 'Every shard should receive requests');
+    assert(stats.cacheHitRate > 0.5, `Cache hit rate should be high, got ${stats.cacheHitRate}`);
+    assert(stats.rss > 0, 'Stats should report shard memory');
+    console.log(`  ✓ ${stats.cachedKeys} keys over ${stats.size} shards, hit rate ${(stats.cacheHitRate * 100).toFixed(1)}%`);
+
+    // A new shard takes over roughly its share of the key space
+    console.log('- Testing shard addition...');
+    const added = cluster.addShard();
+    assert.equal(added.op, 'add');
+    assert(added.movedFraction > 0.1 && added.movedFraction < 0.6,
+      `About a third of the keys should move, got ${added.movedFraction}`);
+    const results = await Promise.all(keys.map((key, i) => cluster.verify(`routed ${i}`, key.signature, key.publicKey)));
+    assert(results.every(Boolean), 'Signatures should verify after adding a shard');
+    console.log(`  ✓ ${(added.movedFraction * 100).toFixed(1)}% of the key space moved to shard ${added.shard}`);
+
+    // A removed shard finishes its in-flight requests first
+    console.log('- Testing shard removal while busy...');
+    stats = await cluster.stats();
+    const victim = stats.shards.reduce((a, b) => (b.routed > a.routed ? b : a)).id;
+    const inflight = keys.flatMap((key, i) =>
+      Array.from({ length: 4 }, () => cluster.verify(`routed ${i}`, key.signature, key.publicKey)));
+    const removed = await cluster.removeShard(victim);
+    assert.equal(removed.op, 'remove');
+    assert((await Promise.all(inflight)).every(Boolean), 'In-flight requests should complete during removal');
+    stats = await cluster.stats();
+    assert.equal(stats.size, 2, 'Cluster should be back to two shards');
+    assert(!stats.shards.some((shard) => shard.id === victim), 'Removed shard should be gone');
+    assert.equal(stats.rebalances, 2, 'Both rebalances should be recorded');
+    assert.equal(await cluster.verify(message, signature, publicKey), true, 'Cluster should keep working');
+    await assert.rejects(cluster.removeShard(victim), /Unknown shard/);
+    console.log(`  ✓ Shard ${victim} drained, ${(removed.movedFraction * 100).toFixed(1)}% of the key space moved`);
+
+    // A crashed shard rejects its requests instead of crashing the parent,
+    // and one that crashes again right after starting is restarted later
+    console.log('- Testing shard crashes...');
+    const owner = cluster._shards.get(cluster.ring.lookup(keyFingerprint(publicKey)));
+    const restarted = async (pid) => {
+      while (!owner.child.connected || owner.child.pid === pid) await new Promise((r) => setTimeout(r, 10));
+    };
+    let pid = owner.child.pid;
+    owner.child.kill('SIGKILL');
+    await assert.rejects(cluster.verify(message, signature, publicKey), /Shard \d+ (exited|unreachable|is not running)/);
+    await restarted(pid);
+    assert.equal(owner.respawnTimer, null, 'A first crash should restart the shard at once');
+
+    pid = owner.child.pid;
+    owner.child.kill('SIGKILL');
+    await new Promise((resolve) => owner.child.once('exit', resolve));
+    assert.notEqual(owner.respawnTimer, null, 'A shard crashing right after starting should be restarted with a delay');
+    await assert.rejects(cluster.verify(message, signature, publicKey), /is not running/);
+    await restarted(pid);
+    assert.equal(await cluster.verify(message, signature, publicKey), true, 'Restarted shard should serve requests');
+    stats = await cluster.stats();
+    assert.equal(stats.shards.find((shard) => shard.id === owner.id).restarts, 2, 'Restarts should be counted');
+    console.log('  ✓ Crashed shard restarted twice, the second time after a backoff');
+  } finally {
+    await cluster.close();
+  }
+
+  await assert.rejects(cluster.verify('closed', new Uint8Array(666), new Uint8Array(1793)), /FalconCluster closed/);
+  console.log('✅ All FalconCluster tests passed!');
+}
+
+runTests().catch((error) => {
+  console.error('❌ Test failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,394 @@
+/**
+ * Falcon Signatures - Multi-process sharding with key-affinity routing (Node.js only)
+ */
+import { fork } from 'child_process';
+import { createHash } from 'crypto';
+import { fileURLToPath } from 'url';
+import { HashRing, keyFingerprint, scheduleRespawn } from './falcon-pool.js';
+
+const SHARD_PATH = fileURLToPath(new URL('./falcon-shard.js', import.meta.url));
+
+// Fingerprints sampled to measure how much of the key space a rebalance moved
+const REBALANCE_SAMPLES = 4096;
+
+/**
+ * Convert a hex string or byte array to a Uint8Array
+ * @private
+ */
+function toBytes(value) {
+  return typeof value === 'string' ? new Uint8Array(Buffer.from(value, 'hex')) : value;
+}
+
+/**
+ * Convert a string message or byte array to a Uint8Array
+ * @private
+ */
+function messageBytes(message) {
+  return typeof message === 'string' ? new TextEncoder().encode(message) : message;
+}
+
+/**
+ * FalconCluster - Falcon operations sharded across child processes
+ *
+ * Each shard is a separate Node.js process running its own FalconPool, so
+ * the memory for loaded keys is spread over processes rather than bounded by
+ * one heap. Requests are routed by the key's fingerprint on a consistent-hash
+ * ring, so each shard caches a disjoint slice of the keys. Adding or removing
+ * a shard moves only the slice adjacent to its ring points; a removed shard
+ * finishes its in-flight requests before it exits.
+ */
+export class FalconCluster {
+  /**
+   * Create a new cluster
+   * @param {Object} options - Cluster options
+   * @param {number} options.shards - Number of shard processes (default: 2)
+   * @param {number} options.threadsPerShard - Worker threads per shard (default: 1)
+   * @param {number} options.keyCacheSize - Loaded keys kept per worker thread (default: 64)
+   * @param {number} options.treeLevels - LDL-tree levels cached per secret key (default: none, see Falcon.loadKey)
+   * @param {boolean} options.keyCacheAdmission - TinyLFU admission in front of each key cache (default: true)
+   * @param {number} options.midstateCacheSize - Secret-key midstates kept per worker thread (default: 1/16 of its WebAssembly memory)
+   * @param {number} options.memoryBudget - Bytes each worker thread may hold in keys and memoized results (default: none)
+   * @param {number} options.virtualNodes - Hash ring points per shard (default: 64)
+   * @param {number} options.respawnDelayMs - First restart delay of a shard that keeps crashing; doubles per crash (default: 100)
+   * @param {number} options.maxRespawnDelayMs - Longest restart delay (default: 10000)
+   */
+  constructor({
+    shards = 2,
+    threadsPerShard = 1,
+    keyCacheSize = 64,
+    treeLevels = null,
+    keyCacheAdmission = true,
+    midstateCacheSize = null,
+    memoryBudget = null,
+    virtualNodes = 64,
+    respawnDelayMs = 100,
+    maxRespawnDelayMs = 10000,
+  } = {}) {
+    this.shardOptions = { threads: threadsPerShard, keyCacheSize, treeLevels, keyCacheAdmission, midstateCacheSize, memoryBudget };
+    this.ring = new HashRing({ virtualNodes });
+    this.respawnDelayMs = respawnDelayMs;
+    this.maxRespawnDelayMs = maxRespawnDelayMs;
+    this.rebalances = [];
+
+    this._shards = new Map();
+    this._nextRequestId = 1;
+    this._nextShardId = 0;
+    this._closed = false;
+
+    for (let i = 0; i < Math.max(1, shards); i++) {
+      this._addShard();
+    }
+  }
+
+  /**
+   * Number of shards on the ring
+   */
+  get size() {
+    return this.ring.nodes.length;
+  }
+
+  /**
+   * Generate a Falcon keypair on the least loaded shard
+   * @returns {Promise<Object>} An object containing the public and private keys as Uint8Arrays
+   */
+  keypair() {
+    return this._submit('keypair', {}, null);
+  }
+
+  /**
+   * Sign a message on the shard owning the secret key
+   * @param {Uint8Array|string} message - The message to sign (string or Uint8Array)
+   * @param {Uint8Array|string} secretKey - The secret key (Uint8Array or hex string)
+   * @returns {Promise<Uint8Array>} The compressed signature
+   */
+  sign(message, secretKey) {
+    const sk = toBytes(secretKey);
+    return this._submit('sign', { message: messageBytes(message), secretKey: sk }, keyFingerprint(sk));
+  }
+
+  /**
+   * Verify a compressed signature on the shard owning the public key
+   * @param {Uint8Array|string} message - The message (string or Uint8Array)
+   * @param {Uint8Array|string} signature - The compressed signature (Uint8Array or hex string)
+   * @param {Uint8Array|string} publicKey - The public key (Uint8Array or hex string)
+   * @returns {Promise<boolean>} True if the signature is valid, false otherwise
+   */
+  verify(message, signature, publicKey) {
+    const pk = toBytes(publicKey);
+    return this._submit('verify', {
+      message: messageBytes(message),
+      signature: toBytes(signature),
+      publicKey: pk,
+    }, keyFingerprint(pk));
+  }
+
+  /**
+   * Verify a constant-time signature on the shard owning the public key
+   * @param {Uint8Array|string} message - The message (string or Uint8Array)
+   * @param {Uint8Array|string} signature - The constant-time signature (Uint8Array or hex string)
+   * @param {Uint8Array|string} publicKey - The public key (Uint8Array or hex string)
+   * @returns {Promise<boolean>} True if the signature is valid, false otherwise
+   */
+  verifyConstantTime(message, signature, publicKey) {
+    const pk = toBytes(publicKey);
+    return this._submit('verifyConstantTime', {
+      message: messageBytes(message),
+      signature: toBytes(signature),
+      publicKey: pk,
+    }, keyFingerprint(pk));
+  }
+
+  /**
+   * Convert a compressed signature to constant-time format on the least loaded shard
+   * @param {Uint8Array|string} compressedSignature - The compressed signature to convert
+   * @returns {Promise<Uint8Array>} The constant-time signature
+   */
+  convertToConstantTime(compressedSignature) {
+    return this._submit('convertToConstantTime', { signature: toBytes(compressedSignature) }, null);
+  }
+
+  /**
+   * Start a new shard and give it its slice of the ring
+   * @returns {Object} Rebalance record: { op, shard, movedFraction }
+   */
+  addShard() {
+    if (this._closed) throw new Error('FalconCluster closed');
+    const before = this._sampleOwners();
+    const shard = this._addShard();
+    return this._recordRebalance('add', shard.id, before);
+  }
+
+  /**
+   * Take a shard off the ring, wait for its in-flight requests, then stop it
+   * @param {number} id - Shard identifier (see stats())
+   * @returns {Promise<Object>} Rebalance record: { op, shard, movedFraction }
+   */
+  async removeShard(id) {
+    const shard = this._shards.get(id);
+    if (!shard || shard.draining) throw new Error(`Unknown shard: ${id}`);
+    if (this.size === 1) throw new Error('Cannot remove the last shard');
+
+    // New requests for its keys go to the next shard on the ring from now on
+    const before = this._sampleOwners();
+    this.ring.remove(id);
+    shard.draining = true;
+    const record = this._recordRebalance('remove', id, before);
+
+    await Promise.allSettled(Array.from(shard.pending.values(), (task) => task.settled));
+    await this._stop(shard);
+    return record;
+  }
+
+  /**
+   * Cluster metrics: per-shard routing counts, memory and key cache figures,
+   * aggregated over all shards
+   * @returns {Promise<Object>} Cluster statistics
+   */
+  async stats() {
+    const shards = await Promise.all(Array.from(this._shards.values(), async (shard) => {
+      const { pool, memory } = await this._post(shard, 'stats', {});
+      const hits = pool.workers.reduce((n, w) => n + w.cache.hits, 0);
+      const misses = pool.workers.reduce((n, w) => n + w.cache.misses, 0);
+      return {
+        id: shard.id,
+        pid: shard.child.pid,
+        draining: shard.draining,
+        restarts: shard.restarts,
+        pending: shard.pending.size,
+        routed: shard.routed,
+        completed: shard.completed,
+        cachedKeys: pool.workers.reduce((n, w) => n + w.cache.size, 0),
+        cacheHits: hits,
+        cacheMisses: misses,
+        steals: pool.steals,
+        memory,
+      };
+    }));
+
+    const hits = shards.reduce((n, s) => n + s.cacheHits, 0);
+    const misses = shards.reduce((n, s) => n + s.cacheMisses, 0);
+    return {
+      size: this.size,
+      routed: shards.reduce((n, s) => n + s.routed, 0),
+      completed: shards.reduce((n, s) => n + s.completed, 0),
+      cachedKeys: shards.reduce((n, s) => n + s.cachedKeys, 0),
+      cacheHitRate: hits + misses === 0 ? 0 : hits / (hits + misses),
+      rss: shards.reduce((n, s) => n + s.memory.rss, 0),
+      rebalances: this.rebalances.length,
+      lastRebalance: this.rebalances[this.rebalances.length - 1] ?? null,
+      shards,
+    };
+  }
+
+  /**
+   * Stop all shards; in-flight requests are rejected
+   */
+  async close() {
+    this._closed = true;
+    const error = new Error('FalconCluster closed');
+    for (const shard of this._shards.values()) {
+      for (const task of shard.pending.values()) task.reject(error);
+      shard.pending.clear();
+    }
+    await Promise.all(Array.from(this._shards.values(), (shard) => this._stop(shard)));
+  }
+
+  /**
+   * Spawn a shard and place it on the hash ring
+   * @private
+   */
+  _addShard() {
+    const shard = {
+      id: this._nextShardId++,
+      child: null,
+      pending: new Map(),
+      routed: 0,
+      completed: 0,
+      draining: false,
+      restarts: 0,
+      crashes: 0,
+      startedAt: 0,
+      respawnTimer: null,
+    };
+    this._spawn(shard);
+    this._shards.set(shard.id, shard);
+    this.ring.add(shard.id);
+    return shard;
+  }
+
+  /**
+   * Start the process of a shard; a crashed shard is restarted in place,
+   * after a growing delay if it keeps crashing soon after starting
+   * @private
+   */
+  _spawn(shard) {
+    shard.respawnTimer = null;
+    const child = fork(SHARD_PATH, [JSON.stringify(this.shardOptions)], { serialization: 'advanced' });
+    let exited = false;
+    const onExit = (error) => {
+      if (exited || shard.child !== child) return;
+      exited = true;
+      for (const task of shard.pending.values()) task.reject(error);
+      shard.pending.clear();
+      if (this._closed || shard.draining) return;
+      scheduleRespawn(shard, () => this._spawn(shard), this);
+    };
+    child.on('message', (message) => this._onMessage(shard, message));
+    child.on('exit', (code, signal) => onExit(new Error(`Shard ${shard.id} exited (${signal ?? code})`)));
+    // A process that could not be started emits no 'exit'; failed sends to
+    // a dying one are reported to their own callbacks
+    child.on('error', (error) => {
+      if (child.pid === undefined) onExit(new Error(`Shard ${shard.id} failed to start: ${error.message}`));
+    });
+    shard.child = child;
+    shard.startedAt = Date.now();
+  }
+
+  /**
+   * Disconnect a shard and wait for its process to exit
+   * @private
+   */
+  _stop(shard) {
+    this._shards.delete(shard.id);
+    clearTimeout(shard.respawnTimer);
+    const child = shard.child;
+    shard.child = null;
+    if (child.exitCode !== null || child.signalCode !== null) return Promise.resolve();
+    return new Promise((resolve) => {
+      child.once('exit', resolve);
+      if (child.connected) child.disconnect();
+      else child.kill();
+    });
+  }
+
+  /**
+   * Route a request to the shard owning the fingerprint (or the least loaded one)
+   * @private
+   */
+  _submit(op, args, fingerprint) {
+    if (this._closed) return Promise.reject(new Error('FalconCluster closed'));
+    const shard = fingerprint !== null ? this._shards.get(this.ring.lookup(fingerprint)) : this._leastLoaded();
+    shard.routed++;
+    return this._post(shard, op, args, true);
+  }
+
+  /**
+   * Shard on the ring with the fewest pending requests
+   * @private
+   */
+  _leastLoaded() {
+    let best = null;
+    for (const shard of this._shards.values()) {
+      if (!shard.draining && (!best || shard.pending.size < best.pending.size)) best = shard;
+    }
+    return best;
+  }
+
+  /**
+   * Send a request to a shard and wait for its reply
+   * @private
+   */
+  _post(shard, op, args, counted = false) {
+    const id = this._nextRequestId++;
+    let task;
+    const promise = new Promise((resolve, reject) => {
+      task = { resolve, reject, counted };
+    });
+    task.settled = promise.then(() => {}, () => {});
+    shard.pending.set(id, task);
+    const fail = (error) => {
+      if (shard.pending.get(id) !== task) return;
+      shard.pending.delete(id);
+      task.reject(error);
+    };
+    // A shard waiting to be restarted, or exiting, rejects the request
+    if (!shard.child.connected) {
+      fail(new Error(`Shard ${shard.id} is not running`));
+    } else {
+      shard.child.send({ id, op, args }, (error) => {
+        if (error) fail(new Error(`Shard ${shard.id} unreachable: ${error.message}`));
+      });
+    }
+    return promise;
+  }
+
+  /**
+   * Handle a shard reply
+   * @private
+   */
+  _onMessage(shard, { id, result, error }) {
+    const task = shard.pending.get(id);
+    if (!task) return;
+    shard.pending.delete(id);
+
+    if (task.counted) shard.completed++;
+    if (error) task.reject(new Error(error));
+    else task.resolve(result);
+  }
+
+  /**
+   * Owners of a fixed sample of fingerprints
+   * @private
+   */
+  _sampleOwners() {
+    const owners = new Array(REBALANCE_SAMPLES);
+    for (let i = 0; i < REBALANCE_SAMPLES; i++) {
+      owners[i] = this.ring.lookup(createHash('sha256').update(`sample#${i}`).digest('hex'));
+    }
+    return owners;
+  }
+
+  /**
+   * Record the share of the key space whose owner changed
+   * @private
+   */
+  _recordRebalance(op, shard, before) {
+    const after = this._sampleOwners();
+    const moved = after.filter((owner, i) => owner !== before[i]).length;
+    const record = { op, shard, movedFraction: moved / REBALANCE_SAMPLES, at: Date.now() };
+    this.rebalances.push(record);
+    return record;
+  }
+}
+
+export default FalconCluster;
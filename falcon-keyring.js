@@ -0,0 +1,188 @@
+/**
+ * Falcon Signatures - Indexed binary keyring files (Node.js)
+ *
+ * A keyring stores many keypairs in one file:
+ *
+ *   header   32 bytes   "FKRG", version, pk length, sk length, count, index offset
+ *   entries  count x (pk length + sk length), in the order they were appended
+ *   index    count x 20 bytes: first 16 bytes of SHA-256(pk) + entry number,
+ *            sorted by fingerprint
+ *
+ * Entries are fixed-size, so entry i is read with one positional read, and
+ * the index finds an entry from its public key by binary search. The header
+ * is completed when the writer closes; a keyring whose writer did not finish
+ * is rejected on open.
+ */
+import { closeSync, fstatSync, openSync, readSync, writeSync } from 'fs';
+import { createHash } from 'crypto';
+
+const MAGIC = Buffer.from('FKRG', 'latin1');
+const VERSION = 1;
+const HEADER_SIZE = 32;
+const FINGERPRINT_SIZE = 16;
+const INDEX_ENTRY_SIZE = FINGERPRINT_SIZE + 4;
+
+function fingerprint(publicKey) {
+  return createHash('sha256').update(publicKey).digest().subarray(0, FINGERPRINT_SIZE);
+}
+
+/**
+ * KeyringWriter - Streams keypairs into a new keyring file
+ */
+export class KeyringWriter {
+  /**
+   * Create (or truncate) a keyring file; it is readable by the owner only
+   * @param {string} path - Keyring file path
+   */
+  constructor(path) {
+    this.path = path;
+    this.count = 0;
+    this._fd = openSync(path, 'w', 0o600);
+    this._pkLength = 0;
+    this._skLength = 0;
+    this._fingerprints = [];
+    writeSync(this._fd, Buffer.alloc(HEADER_SIZE));
+  }
+
+  /**
+   * Append a keypair
+   * @param {Uint8Array} publicKey - Public key bytes
+   * @param {Uint8Array} secretKey - Secret key bytes
+   * @returns {number} Entry number of the keypair
+   */
+  append(publicKey, secretKey) {
+    if (this._fd === null) throw new Error('KeyringWriter closed');
+    if (this.count === 0) {
+      this._pkLength = publicKey.length;
+      this._skLength = secretKey.length;
+    } else if (publicKey.length !== this._pkLength || secretKey.length !== this._skLength) {
+      throw new Error(`Invalid keypair lengths: ${publicKey.length}/${secretKey.length}, expected ${this._pkLength}/${this._skLength}`);
+    }
+
+    writeSync(this._fd, publicKey);
+    writeSync(this._fd, secretKey);
+    this._fingerprints.push(fingerprint(publicKey));
+    return this.count++;
+  }
+
+  /**
+   * Write the index and header and close the file
+   */
+  close() {
+    if (this._fd === null) return;
+    const order = this._fingerprints.map((_, i) => i)
+      .sort((a, b) => Buffer.compare(this._fingerprints[a], this._fingerprints[b]));
+    const index = Buffer.alloc(order.length * INDEX_ENTRY_SIZE);
+    order.forEach((entry, i) => {
+      this._fingerprints[entry].copy(index, i * INDEX_ENTRY_SIZE);
+      index.writeUInt32LE(entry, i * INDEX_ENTRY_SIZE + FINGERPRINT_SIZE);
+    });
+    const indexOffset = HEADER_SIZE + this.count * (this._pkLength + this._skLength);
+    writeSync(this._fd, index, 0, index.length, indexOffset);
+
+    const header = Buffer.alloc(HEADER_SIZE);
+    MAGIC.copy(header, 0);
+    header[4] = VERSION;
+    header.writeUInt32LE(this._pkLength, 8);
+    header.writeUInt32LE(this._skLength, 12);
+    header.writeUInt32LE(this.count, 16);
+    header.writeBigUInt64LE(BigInt(indexOffset), 24);
+    writeSync(this._fd, header, 0, HEADER_SIZE, 0);
+
+    closeSync(this._fd);
+    this._fd = null;
+  }
+}
+
+/**
+ * Keyring - Random access to the keypairs of a keyring file
+ */
+export class Keyring {
+  /**
+   * Open a keyring file; only the index is loaded into memory
+   * @param {string} path - Keyring file path
+   */
+  constructor(path) {
+    this.path = path;
+    this._fd = openSync(path, 'r');
+    try {
+      const header = Buffer.alloc(HEADER_SIZE);
+      readSync(this._fd, header, 0, HEADER_SIZE, 0);
+      if (!header.subarray(0, 4).equals(MAGIC)) {
+        throw new Error(`Not a Falcon keyring: ${path}`);
+      }
+      if (header[4] !== VERSION) {
+        throw new Error(`Unsupported keyring version: ${header[4]}`);
+      }
+      this.publicKeyLength = header.readUInt32LE(8);
+      this.secretKeyLength = header.readUInt32LE(12);
+      this.count = header.readUInt32LE(16);
+      this._indexOffset = Number(header.readBigUInt64LE(24));
+
+      const expected = this._indexOffset + this.count * INDEX_ENTRY_SIZE;
+      if (this._indexOffset === 0 || fstatSync(this._fd).size !== expected) {
+        throw new Error(`Incomplete keyring: ${path}`);
+      }
+      this._index = Buffer.alloc(this.count * INDEX_ENTRY_SIZE);
+      readSync(this._fd, this._index, 0, this._index.length, this._indexOffset);
+    } catch (error) {
+      closeSync(this._fd);
+      throw error;
+    }
+  }
+
+  /**
+   * Read a keypair
+   * @param {number} entry - Entry number (0 <= entry < count)
+   * @returns {Object} An object containing the public and private keys as Uint8Arrays
+   */
+  get(entry) {
+    if (!Number.isInteger(entry) || entry < 0 || entry >= this.count) {
+      throw new Error(`Keyring entry out of range: ${entry}`);
+    }
+    const size = this.publicKeyLength + this.secretKeyLength;
+    const bytes = new Uint8Array(size);
+    readSync(this._fd, bytes, 0, size, HEADER_SIZE + entry * size);
+    return {
+      publicKey: bytes.slice(0, this.publicKeyLength),
+      secretKey: bytes.slice(this.publicKeyLength),
+    };
+  }
+
+  /**
+   * Find the entry holding a public key
+   * @param {Uint8Array} publicKey - Public key bytes
+   * @returns {number} Entry number, or -1 if the key is not in the keyring
+   */
+  findByPublicKey(publicKey) {
+    const target = fingerprint(publicKey);
+    let lo = 0;
+    let hi = this.count;
+    while (lo < hi) {
+      const mid = (lo + hi) >>> 1;
+      const offset = mid * INDEX_ENTRY_SIZE;
+      if (Buffer.compare(this._index.subarray(offset, offset + FINGERPRINT_SIZE), target) < 0) lo = mid + 1;
+      else hi = mid;
+    }
+    // Fingerprints are truncated, so confirm against the stored key
+    for (let i = lo; i < this.count; i++) {
+      const offset = i * INDEX_ENTRY_SIZE;
+      if (!this._index.subarray(offset, offset + FINGERPRINT_SIZE).equals(target)) break;
+      const entry = this._index.readUInt32LE(offset + FINGERPRINT_SIZE);
+      if (Buffer.from(this.get(entry).publicKey).equals(Buffer.from(publicKey))) return entry;
+    }
+    return -1;
+  }
+
+  /**
+   * Close the keyring file
+   */
+  close() {
+    if (this._fd !== null) {
+      closeSync(this._fd);
+      this._fd = null;
+    }
+  }
+}
+
+export default Keyring;
@@ -0,0 +1,108 @@
+#!/usr/bin/env node
+import Falcon from './index.js';
+import { VerifiedLedger } from './falcon-ledger.js';
+import { strict as assert } from 'assert';
+import { appendFileSync, existsSync, mkdtempSync, rmSync, statSync } from 'fs';
+import { tmpdir } from 'os';
+import path from 'path';
+
+/**
+ * Test the persistent verified-signature ledger
+ */
+async function runTests() {
+  console.log('🧪 Testing VerifiedLedger implementation...');
+  const dir = mkdtempSync(path.join(tmpdir(), 'falcon-ledger-'));
+  const file = path.join(dir, 'verified.ledger');
+  const falcon = new Falcon();
+
+  try {
+    const { publicKey, secretKey } = await falcon.keypair();
+    const messages = Array.from({ length: 8 }, (_, i) => `Ledger message ${i}`);
+    const signatures = [];
+    for (const message of messages) {
+      signatures.push(await falcon.sign(message, secretKey));
+    }
+
+    // Misses go to Falcon; only valid signatures are recorded
+    console.log('- Testing verification through the ledger...');
+    let ledger = await VerifiedLedger.open(file, { falcon });
+    for (let i = 0; i < messages.length; i++) {
+      assert.equal(await ledger.verify(messages[i], signatures[i], publicKey), true, 'Valid signature should verify');
+    }
+    assert.equal(await ledger.verify('tampered', signatures[0], publicKey), false, 'Tampered message should not verify');
+    assert.equal(await ledger.verify('tampered', signatures[0], publicKey), false, 'Invalid results should not be cached');
+    assert.equal(ledger.size, messages.length, 'Only valid triples should be recorded');
+    assert.equal(ledger.has(messages[0], signatures[0], publicKey), true, 'Recorded triple should be found');
+    assert.equal(ledger.has(messages[0], signatures[1], publicKey), false, 'Other signature should not be found');
+    console.log(`  ✓ ${ledger.size} verified triples recorded`);
+
+    const ctSignature = await falcon.convertToConstantTime(signatures[0]);
+    assert.equal(await ledger.verifyConstantTime(messages[0], ctSignature, publicKey), true,
+      'Constant-time signature should verify');
+    ledger.close();
+
+    // After a restart, positive hits skip Falcon entirely
+    console.log('- Testing reload after restart...');
+    const failing = { verify: async () => { throw new Error('Falcon should not be called'); } };
+    ledger = await VerifiedLedger.open(file, { falcon: failing });
+    assert.equal(ledger.size, messages.length + 1, 'Reloaded ledger should contain every triple');
+    for (let i = 0; i < messages.length; i++) {
+      assert.equal(await ledger.verify(messages[i], Falcon.bytesToHex(signatures[i]), Falcon.bytesToHex(publicKey)), true,
+        'Hex arguments should hit the same entry');
+    }
+    const stats = ledger.stats();
+    assert.equal(stats.hits, messages.length, 'Every replayed verification should be a hit');
+    console.log(`  ✓ Loaded in ${stats.loadTimeMs.toFixed(2)} ms, ${stats.hits} hits without Falcon`);
+    ledger.close();
+
+    // A torn trailing record is dropped on open
+    console.log('- Testing recovery from a torn write...');
+    appendFileSync(file, Buffer.alloc(10, 0xaa));
+    ledger = await VerifiedLedger.open(file, { falcon });
+    assert.equal(ledger.size, messages.length + 1, 'Torn record should be ignored');
+    assert.equal((statSync(file).size - 8) % 32, 0, 'File should be truncated to whole records');
+    ledger.close();
+    console.log('  ✓ Torn record dropped');
+
+    // Compaction keeps only the newest maxEntries triples
+    console.log('- Testing compaction...');
+    ledger = await VerifiedLedger.open(file, { falcon, maxEntries: 4, syncAppends: true });
+    ledger.compact();
+    assert.equal(ledger.size, 4, 'Compaction should keep maxEntries triples');
+    assert.equal(ledger.stats().fileRecords, 4, 'Compacted file should hold only kept records');
+    assert.equal(ledger.has(messages[7], signatures[7], publicKey), true, 'Newest triples should be kept');
+    assert.equal(ledger.has(messages[0], signatures[0], publicKey), false, 'Oldest triples should be dropped');
+    assert.equal(await ledger.verify(messages[0], signatures[0], publicKey), true, 'Dropped triple should re-verify');
+    assert.equal(existsSync(`${file}.compact`), false, 'The compacted file should replace the ledger');
+    ledger.close();
+    console.log('  ✓ Compaction dropped the oldest entries');
+
+    // Growth past the initial capacity keeps every entry reachable
+    console.log('- Testing index growth...');
+    ledger = await VerifiedLedger.open(path.join(dir, 'grow.ledger'), { falcon: { verify: async () => true } });
+    for (let i = 0; i < 3000; i++) {
+      await ledger.verify(`m${i}`, signatures[0], publicKey);
+    }
+    assert.equal(ledger.size, 3000, 'All entries should be recorded');
+    for (let i = 0; i < 3000; i += 97) {
+      assert.equal(ledger.has(`m${i}`, signatures[0], publicKey), true, 'Entries should survive index growth');
+    }
+    const negativesBefore = ledger.stats().bloomNegatives;
+    for (let i = 0; i < 3000; i++) ledger.has(`unseen ${i}`, signatures[0], publicKey);
+    const negatives = ledger.stats().bloomNegatives - negativesBefore;
+    assert(negatives >= 3000 * 0.97, `Bloom filter should answer nearly all negative lookups, got ${negatives} of 3000`);
+    ledger.close();
+    console.log('  ✓ Index growth keeps all entries');
+
+    await assert.rejects(ledger.verify(messages[0], signatures[0], publicKey), /VerifiedLedger closed/);
+  } finally {
+    rmSync(dir, { recursive: true, force: true });
+  }
+
+  console.log('✅ All VerifiedLedger tests passed!');
+}
+
+runTests().catch((error) => {
+  console.error('❌ Test failed:', error);
+  process.exit(1);
+});
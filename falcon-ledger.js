@@ -0,0 +1,478 @@
+/**
+ * Falcon Signatures - Persistent verified-signature ledger (Node.js)
+ *
+ * Remembers which (public key, message, signature) triples have already been
+ * verified, so replayed records skip Falcon verification, including across
+ * restarts. Each triple is stored as a 32-byte SHA-256 digest in an
+ * append-only file; an in-memory Bloom filter answers most "not seen" lookups
+ * without touching the exact index.
+ *
+ * The ledger file is trusted input: anyone who can write to it can mark
+ * signatures as valid. Keep it with the same permissions as the data it
+ * protects.
+ */
+import { closeSync, existsSync, fstatSync, fsyncSync, ftruncateSync, openSync, readFileSync, renameSync, writeSync } from 'fs';
+import { dirname } from 'path';
+import { createHash } from 'crypto';
+import Falcon, { FalconKey } from './index.js';
+
+// File layout: 8-byte header, then 32-byte digests in insertion order
+const MAGIC = Buffer.from('FVLG', 'latin1');
+const VERSION = 1;
+const HEADER_SIZE = 8;
+const DIGEST_SIZE = 32;
+
+const KIND_COMPRESSED = 0;
+const KIND_CT = 1;
+
+function header() {
+  const buf = Buffer.alloc(HEADER_SIZE);
+  MAGIC.copy(buf, 0);
+  buf[4] = VERSION;
+  return buf;
+}
+
+/**
+ * Flush a directory entry (a created or renamed file) to disk. Platforms
+ * that cannot open directories (Windows) persist renames without it.
+ */
+function syncDirectory(path) {
+  let fd;
+  try {
+    fd = openSync(dirname(path), 'r');
+  } catch {
+    return;
+  }
+  try {
+    fsyncSync(fd);
+  } catch (error) {
+    if (error.code !== 'EISDIR' && error.code !== 'EINVAL' && error.code !== 'EPERM') throw error;
+  } finally {
+    closeSync(fd);
+  }
+}
+
+function nextPowerOfTwo(n) {
+  let p = 1;
+  while (p < n) p *= 2;
+  return p;
+}
+
+/**
+ * BloomFilter - Blocked Bloom filter over SHA-256 digests
+ *
+ * All probes of a key fall in one 512-bit block, so a lookup costs a single
+ * cache miss. Digests are already uniformly distributed, so the block and
+ * the 9-bit probe positions are taken directly from digest words: three
+ * probes from each of w2, w3 and w4.
+ * @private
+ */
+class BloomFilter {
+  constructor(capacity, bitsPerEntry) {
+    const blocks = nextPowerOfTwo(Math.max(1, Math.ceil(capacity * bitsPerEntry / 512)));
+    this.blockMask = blocks - 1;
+    this.hashes = Math.min(7, Math.max(1, Math.round(bitsPerEntry * Math.LN2)));
+    this.words = new Uint32Array(blocks * 16);
+  }
+
+  add(w1, w2, w3, w4) {
+    const base = (w1 & this.blockMask) * 16;
+    let bits = w2;
+    for (let i = 0; i < this.hashes; i++) {
+      if (i === 3) bits = w3;
+      else if (i === 6) bits = w4;
+      const bit = bits & 511;
+      bits >>>= 9;
+      this.words[base + (bit >>> 5)] |= 1 << (bit & 31);
+    }
+  }
+
+  mightContain(w1, w2, w3, w4) {
+    const base = (w1 & this.blockMask) * 16;
+    let bits = w2;
+    for (let i = 0; i < this.hashes; i++) {
+      if (i === 3) bits = w3;
+      else if (i === 6) bits = w4;
+      const bit = bits & 511;
+      bits >>>= 9;
+      if ((this.words[base + (bit >>> 5)] & (1 << (bit & 31))) === 0) return false;
+    }
+    return true;
+  }
+}
+
+/**
+ * VerifiedLedger - Append-only set of verified signature digests
+ *
+ * Digests live in one contiguous buffer (the file contents minus the header)
+ * indexed by an open-addressing table, so loading is a single read plus one
+ * pass over the records. A torn trailing record from a crash is dropped on
+ * open. Compaction rewrites the file without duplicates (from concurrent
+ * misses on the same triple) and, when maxEntries is set, without the oldest
+ * entries.
+ */
+export class VerifiedLedger {
+  /**
+   * Create a ledger; use VerifiedLedger.open() to load it
+   * @param {string} path - Ledger file path
+   * @param {Object} options - Ledger options
+   * @param {Falcon} options.falcon - Falcon instance used on ledger misses (default: a new instance)
+   * @param {number} options.maxEntries - Entries kept by compaction, newest first (default: unlimited)
+   * @param {number} options.compactRatio - Compact once redundant records exceed this fraction of the file (default: 0.25)
+   * @param {number} options.bloomBitsPerEntry - Bloom filter bits per entry (default: 10, about 1-2% false positives)
+   * @param {boolean} options.syncAppends - fsync every appended record (default: false; appends are
+   *   flushed on close and compaction, and one lost in a crash is only verified again)
+   */
+  constructor(path, { falcon, maxEntries = Infinity, compactRatio = 0.25, bloomBitsPerEntry = 10, syncAppends = false } = {}) {
+    this.path = path;
+    this.falcon = falcon || new Falcon();
+    this.maxEntries = maxEntries;
+    this.compactRatio = compactRatio;
+    this.bloomBitsPerEntry = bloomBitsPerEntry;
+    this.syncAppends = syncAppends;
+    this._fd = null;
+    this._records = Buffer.alloc(0);
+    this._count = 0;
+    this._unique = 0;
+    this._fileRecords = 0;
+    this.hits = 0;
+    this.misses = 0;
+    this.bloomNegatives = 0;
+    this.compactions = 0;
+    this.loadTime = 0;
+  }
+
+  /**
+   * Open (or create) a ledger file and load it into memory
+   * @param {string} path - Ledger file path
+   * @param {Object} options - See the constructor
+   * @returns {Promise<VerifiedLedger>} Loaded ledger
+   */
+  static async open(path, options = {}) {
+    const ledger = new VerifiedLedger(path, options);
+    ledger._load();
+    return ledger;
+  }
+
+  /**
+   * Digest identifying a (format, public key, message, signature) triple
+   * @param {number} kind - 0 for compressed signatures, 1 for constant-time
+   * @param {Uint8Array} publicKey - Public key bytes
+   * @param {Uint8Array} message - Message bytes
+   * @param {Uint8Array} signature - Signature bytes
+   * @returns {Buffer} 32-byte digest
+   */
+  static digest(kind, publicKey, message, signature) {
+    // Length-prefix each field so different splits never collide
+    const lengths = Buffer.alloc(13);
+    lengths[0] = kind;
+    lengths.writeUInt32LE(publicKey.length, 1);
+    lengths.writeUInt32LE(message.length, 5);
+    lengths.writeUInt32LE(signature.length, 9);
+    return createHash('sha256')
+      .update('falcon-verified-ledger')
+      .update(lengths)
+      .update(publicKey)
+      .update(message)
+      .update(signature)
+      .digest();
+  }
+
+  /**
+   * Number of distinct verified triples
+   */
+  get size() {
+    return this._unique;
+  }
+
+  /**
+   * Verify a compressed signature, consulting the ledger first
+   * @param {Uint8Array|string} message - The message (string or Uint8Array)
+   * @param {Uint8Array|string} signature - The compressed signature (Uint8Array or hex string)
+   * @param {Uint8Array|string|FalconKey} publicKey - The public key (Uint8Array, hex string or loaded key)
+   * @returns {Promise<boolean>} True if the signature is valid, false otherwise
+   */
+  async verify(message, signature, publicKey) {
+    return this._verify(KIND_COMPRESSED, message, signature, publicKey,
+      () => this.falcon.verify(message, signature, publicKey));
+  }
+
+  /**
+   * Verify a constant-time signature, consulting the ledger first
+   * @param {Uint8Array|string} message - The message (string or Uint8Array)
+   * @param {Uint8Array|string} signature - The constant-time signature (Uint8Array or hex string)
+   * @param {Uint8Array|string|FalconKey} publicKey - The public key (Uint8Array, hex string or loaded key)
+   * @returns {Promise<boolean>} True if the signature is valid, false otherwise
+   */
+  async verifyConstantTime(message, signature, publicKey) {
+    return this._verify(KIND_CT, message, signature, publicKey,
+      () => this.falcon.verifyConstantTime(message, signature, publicKey));
+  }
+
+  /**
+   * Check whether a compressed-signature triple is in the ledger
+   * @param {Uint8Array|string} message - The message
+   * @param {Uint8Array|string} signature - The compressed signature
+   * @param {Uint8Array|string|FalconKey} publicKey - The public key
+   * @returns {boolean} True if the triple was verified before
+   */
+  has(message, signature, publicKey) {
+    return this._has(this._digestOf(KIND_COMPRESSED, message, signature, publicKey));
+  }
+
+  /**
+   * Rewrite the ledger file without duplicate or expired records
+   */
+  compact() {
+    this._ensureOpen();
+    const seen = new Set();
+    const keep = [];
+    // Walk newest to oldest so maxEntries keeps the most recent entries
+    for (let i = this._count - 1; i >= 0 && keep.length < this.maxEntries; i--) {
+      const offset = i * DIGEST_SIZE;
+      const key = this._records.toString('latin1', offset, offset + DIGEST_SIZE);
+      if (seen.has(key)) continue;
+      seen.add(key);
+      keep.push(offset);
+    }
+
+    const records = Buffer.alloc(keep.length * DIGEST_SIZE);
+    for (let i = 0; i < keep.length; i++) {
+      const offset = keep[keep.length - 1 - i];
+      this._records.copy(records, i * DIGEST_SIZE, offset, offset + DIGEST_SIZE);
+    }
+
+    // Write a complete new file and flush it before it atomically replaces
+    // the old one, so a crash leaves either ledger, never an empty one
+    const tmp = `${this.path}.compact`;
+    const fd = openSync(tmp, 'w');
+    try {
+      writeSync(fd, header());
+      writeSync(fd, records);
+      fsyncSync(fd);
+    } finally {
+      closeSync(fd);
+    }
+    fsyncSync(this._fd);
+    closeSync(this._fd);
+    renameSync(tmp, this.path);
+    syncDirectory(this.path);
+    this._fd = openSync(this.path, 'a');
+
+    this._index(records, keep.length);
+    this._fileRecords = keep.length;
+    this.compactions++;
+  }
+
+  /**
+   * Ledger statistics
+   * @returns {Object} Size, file records, hits, misses, Bloom negatives, compactions and load time
+   */
+  stats() {
+    const lookups = this.hits + this.misses;
+    return {
+      size: this._unique,
+      fileRecords: this._fileRecords,
+      hits: this.hits,
+      misses: this.misses,
+      hitRate: lookups === 0 ? 0 : this.hits / lookups,
+      bloomNegatives: this.bloomNegatives,
+      compactions: this.compactions,
+      loadTimeMs: this.loadTime,
+    };
+  }
+
+  /**
+   * Close the ledger file
+   */
+  close() {
+    if (this._fd !== null) {
+      fsyncSync(this._fd);
+      closeSync(this._fd);
+      this._fd = null;
+    }
+  }
+
+  /**
+   * Shared ledger-then-Falcon verification path
+   * @private
+   */
+  async _verify(kind, message, signature, publicKey, falconVerify) {
+    this._ensureOpen();
+    const digest = this._digestOf(kind, message, signature, publicKey);
+    if (this._has(digest)) {
+      this.hits++;
+      return true;
+    }
+
+    this.misses++;
+    const valid = await falconVerify();
+    // Only valid signatures are recorded; a concurrent miss may have added it
+    if (valid && !this._has(digest)) this._append(digest);
+    return valid;
+  }
+
+  /**
+   * Canonical bytes of the arguments, digested
+   * @private
+   */
+  _digestOf(kind, message, signature, publicKey) {
+    const msg = typeof message === 'string' ? new TextEncoder().encode(message) : message;
+    const sig = typeof signature === 'string' ? Falcon.hexToBytes(signature) : signature;
+    let pk;
+    if (publicKey instanceof FalconKey) {
+      pk = publicKey.falcon._module.HEAPU8.subarray(publicKey.ptr, publicKey.ptr + publicKey.length);
+    } else {
+      pk = typeof publicKey === 'string' ? Falcon.hexToBytes(publicKey) : publicKey;
+    }
+    return VerifiedLedger.digest(kind, pk, msg, sig);
+  }
+
+  /**
+   * Read the file and build the in-memory index
+   * @private
+   */
+  _load() {
+    const start = performance.now();
+    let records = Buffer.alloc(0);
+    let count = 0;
+
+    if (existsSync(this.path)) {
+      const data = readFileSync(this.path);
+      if (data.length > 0) {
+        if (data.length < HEADER_SIZE || !data.subarray(0, 4).equals(MAGIC)) {
+          throw new Error(`Not a verified-signature ledger: ${this.path}`);
+        }
+        if (data[4] !== VERSION) {
+          throw new Error(`Unsupported ledger version: ${data[4]}`);
+        }
+        count = Math.floor((data.length - HEADER_SIZE) / DIGEST_SIZE);
+        records = data.subarray(HEADER_SIZE, HEADER_SIZE + count * DIGEST_SIZE);
+      }
+    }
+
+    this._fd = openSync(this.path, 'a');
+    const fileSize = fstatSync(this._fd).size;
+    if (fileSize === 0) {
+      writeSync(this._fd, header());
+      fsyncSync(this._fd);
+      syncDirectory(this.path);
+    } else if (fileSize !== HEADER_SIZE + count * DIGEST_SIZE) {
+      // Drop a torn record so later appends stay aligned
+      ftruncateSync(this._fd, HEADER_SIZE + count * DIGEST_SIZE);
+    }
+
+    this._index(records, count);
+    this._fileRecords = count;
+    this.loadTime = performance.now() - start;
+
+    if (this._needsCompaction()) this.compact();
+  }
+
+  /**
+   * Rebuild the records buffer, hash table and Bloom filter
+   * @private
+   */
+  _index(records, count) {
+    const capacity = nextPowerOfTwo(Math.max(1024, count * 2));
+    this._records = Buffer.alloc(capacity * DIGEST_SIZE);
+    records.copy(this._records, 0, 0, count * DIGEST_SIZE);
+    // Word view for hashing and comparisons (a fresh allocation is aligned)
+    this._words = new Uint32Array(this._records.buffer, this._records.byteOffset, capacity * (DIGEST_SIZE / 4));
+    this._count = 0;
+    this._unique = 0;
+    this._table = new Uint32Array(capacity * 2);
+    this._tableMask = this._table.length - 1;
+    this._bloom = new BloomFilter(capacity, this.bloomBitsPerEntry);
+    for (let i = 0; i < count; i++) this._insert(i);
+    this._count = count;
+  }
+
+  /**
+   * Index the record at position i; duplicates are counted but not indexed
+   * @private
+   */
+  _insert(i) {
+    const words = this._words;
+    const base = i * 8;
+    if (this._find(words, base) !== 0) return;
+    let slot = words[base] & this._tableMask;
+    while (this._table[slot] !== 0) slot = (slot + 1) & this._tableMask;
+    this._table[slot] = i + 1;
+    this._bloom.add(words[base + 1], words[base + 2], words[base + 3], words[base + 4]);
+    this._unique++;
+  }
+
+  /**
+   * Table entry (record index + 1) holding the digest at words[base], or 0
+   * @private
+   */
+  _find(words, base) {
+    const records = this._words;
+    let slot = words[base] & this._tableMask;
+    for (;;) {
+      const entry = this._table[slot];
+      if (entry === 0) return 0;
+      const other = (entry - 1) * 8;
+      let equal = true;
+      for (let w = 0; w < 8; w++) {
+        if (records[other + w] !== words[base + w]) {
+          equal = false;
+          break;
+        }
+      }
+      if (equal) return entry;
+      slot = (slot + 1) & this._tableMask;
+    }
+  }
+
+  /**
+   * Exact membership test behind the Bloom filter
+   * @private
+   */
+  _has(digest) {
+    const words = new Uint32Array(8);
+    new Uint8Array(words.buffer).set(digest);
+    if (!this._bloom.mightContain(words[1], words[2], words[3], words[4])) {
+      this.bloomNegatives++;
+      return false;
+    }
+    return this._find(words, 0) !== 0;
+  }
+
+  /**
+   * Append a digest to the file and the index
+   * @private
+   */
+  _append(digest) {
+    writeSync(this._fd, digest);
+    if (this.syncAppends) fsyncSync(this._fd);
+    this._fileRecords++;
+
+    if ((this._count + 1) * DIGEST_SIZE > this._records.length) {
+      this._index(this._records, this._count);
+    }
+    digest.copy(this._records, this._count * DIGEST_SIZE);
+    this._insert(this._count);
+    this._count++;
+
+    if (this._needsCompaction()) this.compact();
+  }
+
+  /**
+   * @private
+   */
+  _needsCompaction() {
+    const live = Math.min(this._unique, this.maxEntries);
+    return this._fileRecords - live > Math.max(64, live * this.compactRatio);
+  }
+
+  /**
+   * @private
+   */
+  _ensureOpen() {
+    if (this._fd === null) throw new Error('VerifiedLedger closed');
+  }
+}
+
+export default VerifiedLedger;
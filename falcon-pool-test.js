@@ -0,0 +1,279 @@
+#!/usr/bin/env node
+import Falcon, { FalconKey } from './index.js';
+import { FalconPool, HashRing, keyFingerprint } from './falcon-pool.js';
+import { KeyCache, MemoryBudget, MidstateCache, ResultCache } from './falcon-cache.js';
+import { strict as assert } from 'assert';
+
+/**
+ * Test the FalconPool worker pool
+ */
+async function runTests() {
+  console.log('🧪 Testing FalconPool implementation...');
+
+  // Hash ring: stable ownership, minimal movement when a node is removed
+  console.log('- Testing hash ring routing...');
+  const ring = new HashRing({ virtualNodes: 32 });
+  [0, 1, 2, 3].forEach((node) => ring.add(node));
+  const fingerprints = Array.from({ length: 200 }, (_, i) => keyFingerprint(new Uint8Array([i, i >> 8])));
+  const owners = fingerprints.map((fp) => ring.lookup(fp));
+  assert.deepEqual(fingerprints.map((fp) => ring.lookup(fp)), owners, 'Lookups should be stable');
+  assert.equal(new Set(owners).size, 4, 'Every node should own some fingerprints');
+  ring.remove(3);
+  fingerprints.forEach((fp, i) => {
+    if (owners[i] !== 3) assert.equal(ring.lookup(fp), owners[i], 'Only keys of the removed node should move');
+    else assert.notEqual(ring.lookup(fp), 3, 'Removed node should own nothing');
+  });
+  console.log('  ✓ Ring lookups are stable and only the removed node\'s keys move');
+
+  const falcon = new Falcon();
+
+  // A scan over cold keys must not flush the keys in repeated use
+  console.log('- Testing key cache admission...');
+  const hotKeys = Array.from({ length: 4 }, (_, i) => new Uint8Array(1793).fill(i + 1));
+  const coldKeys = Array.from({ length: 200 }, (_, i) => new Uint8Array(1793).fill(0xff).fill(i & 0xff, 0, 1).fill(i >> 8, 1, 2));
+  const hotHitRate = {};
+  for (const admission of [false, true]) {
+    const cache = new KeyCache(falcon, { capacity: 8, admission });
+    const get = (key) => cache.get(keyFingerprint(key), key, 'public');
+    for (let round = 0; round < 3; round++) {
+      for (const key of hotKeys) await get(key);
+    }
+    let hotHits = 0;
+    for (let i = 0; i < coldKeys.length; i++) {
+      await get(coldKeys[i]);
+      if (i % 10 === 9) {
+        for (const key of hotKeys) {
+          const before = cache.hits;
+          await get(key);
+          hotHits += cache.hits - before;
+        }
+      }
+    }
+    hotHitRate[admission ? 'tinylfu' : 'lru'] = hotHits / (hotKeys.length * coldKeys.length / 10);
+    if (admission) {
+      assert(cache.stats().rejections >= coldKeys.length * 0.9, 'Keys seen once should not be loaded');
+    }
+    cache.clear();
+  }
+  assert.equal(hotHitRate.tinylfu, 1, 'Hot keys should survive the scan with admission');
+  assert(hotHitRate.lru < 0.5, `Plain LRU should be flushed by the scan, got ${hotHitRate.lru}`);
+  console.log(`  ✓ Hot-key hit rate during a cold scan: LRU ${(hotHitRate.lru * 100).toFixed(0)}%, TinyLFU ${(hotHitRate.tinylfu * 100).toFixed(0)}%`);
+
+  // Public keys reload in microseconds, signatures took milliseconds to produce
+  console.log('- Testing shared memory budget...');
+  const budget = new MemoryBudget(24 * 1024);
+  const budgetKeys = new KeyCache(falcon, { capacity: 64, admission: false, budget });
+  const budgetResults = new ResultCache(falcon, { budget });
+  const signer = await falcon.keypair();
+  const memoized = [];
+  for (let i = 0; i < 6; i++) {
+    memoized.push(await budgetResults.sign(`budget ${i}`, signer.secretKey));
+  }
+  for (const key of coldKeys.slice(0, 12)) {
+    await budgetKeys.get(keyFingerprint(key), key, 'public');
+  }
+  let budgetStats = budget.stats();
+  assert(budgetStats.bytes <= budget.maxBytes, `Caches should fit the budget, hold ${budgetStats.bytes} bytes`);
+  assert(budgetStats.caches.keys.budgetEvictions > 0, 'Public keys should be evicted to fit the budget');
+  assert.equal(budgetStats.caches.results.budgetEvictions, 0, 'Signatures are costlier per byte and should be kept');
+  assert.deepEqual(await budgetResults.sign('budget 0', signer.secretKey), memoized[0], 'Memoized signature should be returned');
+  assert.deepEqual(memoized[0], await falcon.sign('budget 0', signer.secretKey), 'Memoized signature should match a fresh one');
+  assert.equal(await budgetResults.verify('budget 0', memoized[0], signer.publicKey), true, 'Signature should verify');
+  assert.equal(await budgetResults.verify('budget 0', memoized[0], signer.publicKey), true, 'Memoized result should verify');
+  assert.equal(await budgetResults.verify('budget 1', memoized[0], signer.publicKey), false, 'Other message should not verify');
+  assert.equal(budgetResults.hits, 2, 'Repeated sign and verify should be memo hits');
+  console.log(`  ✓ ${budgetStats.bytes} of ${budget.maxBytes} bytes held, ${budgetStats.caches.keys.budgetEvictions} keys evicted, signatures kept`);
+
+  // Only the key last returned may be in use; everything else can go
+  budget.maxBytes = 4 * 1024;
+  budget.enforce();
+  budgetStats = budget.stats();
+  assert.equal(budgetKeys.size, 1, 'The most recently used key should stay loaded');
+  assert(budgetStats.bytes <= budget.maxBytes, 'A smaller budget should also evict signatures');
+  console.log('  ✓ Shrinking the budget evicts across caches down to the key in use');
+  budgetKeys.clear();
+
+  // Builds without the midstate exports skip the cache before hashing keys
+  console.log('- Testing midstate cache...');
+  const midstateCache = new MidstateCache(falcon, { capacity: 4 });
+  const midstates = await falcon.supportsMidstates();
+  const [first, second] = await Promise.all([midstateCache.get(signer.secretKey), midstateCache.get(signer.secretKey)]);
+  assert.equal(first, second, 'Concurrent misses should share one midstate');
+  assert.equal(await midstateCache.get(signer.secretKey), first, 'The cached midstate should be returned');
+  assert.equal(first === null, !midstates, 'Midstates should be cached only on builds that have them');
+  assert.equal(midstateCache.misses, midstates ? 2 : 0, 'Builds without midstates should not count misses');
+  assert.equal(midstateCache.size, midstates ? 1 : 0);
+  midstateCache.clear();
+  console.log(`  ✓ Midstate cache ${midstates ? 'shares concurrent misses' : 'is skipped without midstate exports'}`);
+
+  const pool = new FalconPool({ size: 2, keyCacheSize: 4, stealThreshold: 2 });
+
+  try {
+    // Results must match the single-instance API
+    console.log('- Testing pool keypair/sign/verify...');
+    const { publicKey, secretKey } = await pool.keypair();
+    assert.equal(publicKey.length, 1793, 'Public key should be 1793 bytes');
+    assert.equal(secretKey.length, 2305, 'Secret key should be 2305 bytes');
+
+    const message = 'This is a test message for the Falcon pool';
+    const signature = await pool.sign(message, secretKey);
+    assert.deepEqual(signature, await falcon.sign(message, secretKey), 'Pool signature should match direct signature');
+    assert.equal(await pool.verify(message, signature, publicKey), true, 'Pool should verify its signature');
+    assert.equal(await falcon.verify(message, signature, publicKey), true, 'Falcon should verify the pool signature');
+    assert.equal(await pool.verify('tampered', signature, publicKey), false, 'Tampered message should not verify');
+
+    const ctSignature = await pool.convertToConstantTime(signature);
+    assert.equal(await pool.verifyConstantTime(message, ctSignature, Falcon.bytesToHex(publicKey)), true,
+      'Constant-time signature should verify with a hex public key');
+    console.log('  ✓ Pool results match direct Falcon operations');
+
+    // Repeated use of one key hits the owning worker's cache
+    console.log('- Testing key affinity and cache hits...');
+    for (let i = 0; i < 5; i++) {
+      await pool.sign(`affinity ${i}`, secretKey);
+    }
+    let stats = await pool.stats();
+    const owner = stats.workers.find((w) => w.cache.hits > 0);
+    assert(owner, 'Owning worker should report cache hits');
+    assert(stats.cacheHitRate > 0.5, `Cache hit rate should be high, got ${stats.cacheHitRate}`);
+    console.log(`  ✓ Cache hit rate ${(stats.cacheHitRate * 100).toFixed(1)}%`);
+
+    // A burst on one key exceeds the threshold, so the other worker steals
+    console.log('- Testing work stealing...');
+    const burst = Array.from({ length: 16 }, (_, i) => pool.sign(`burst ${i}`, secretKey));
+    const burstSignatures = await Promise.all(burst);
+    for (let i = 0; i < burstSignatures.length; i++) {
+      assert.equal(await falcon.verify(`burst ${i}`, burstSignatures[i], publicKey), true,
+        'Every burst signature should verify');
+    }
+    stats = await pool.stats();
+    assert(stats.steals > 0, 'Idle worker should steal from the overloaded queue');
+    console.log(`  ✓ ${stats.steals} requests stolen, ${stats.completed} completed`);
+
+    // Streaming verification keeps a bounded number of batches in flight
+    console.log('- Testing streaming verification...');
+    let pulled = 0;
+    let consumed = 0;
+    let maxAhead = 0;
+    async function* produce() {
+      for (let i = 0; i < 200; i++) {
+        pulled++;
+        maxAhead = Math.max(maxAhead, pulled - consumed);
+        yield { message: i % 5 === 0 ? 'tampered' : message, signature, publicKey };
+      }
+    }
+    const lookups = (stats) => new Map(stats.workers.map((w) => [w.id, w.cache.hits + w.cache.misses]));
+    const before = lookups(await pool.stats());
+    const seen = new Set();
+    for await (const { index, ok } of pool.verifyStream(produce(), { batchSize: 8, maxInflightBatches: 3 })) {
+      assert.equal(ok, index % 5 !== 0, `Stream result ${index} should match verify()`);
+      seen.add(index);
+      consumed++;
+    }
+    assert.equal(seen.size, 200, 'Every item should yield exactly one result');
+    assert(maxAhead <= 3 * 8, `At most three batches should be in flight, got ${maxAhead} items ahead`);
+    // Batches go to the owner of their key, which takes it from its key cache
+    const after = lookups(await pool.stats());
+    const keyOwner = pool.ring.lookup(keyFingerprint(publicKey));
+    for (const [id, count] of after) {
+      assert.equal(count - before.get(id), id === keyOwner ? 25 : 0, `Worker ${id} should look up the key only if it owns it`);
+    }
+    console.log(`  ✓ ${seen.size} results, producer at most ${maxAhead} items ahead, keys from the owner's cache`);
+
+    // Mixed keys are split across their owners; malformed items still yield an error each
+    const other = await falcon.keypair();
+    const otherSignature = await falcon.sign(message, other.secretKey);
+    const mixed = Array.from({ length: 40 }, (_, i) => (i % 2 === 0
+      ? { message, signature, publicKey }
+      : { message, signature: otherSignature, publicKey: other.publicKey }));
+    mixed.push({ message, signature, publicKey: new Uint8Array(10) });
+    const mixedResults = [];
+    for await (const result of pool.verifyStream(mixed, { batchSize: 16 })) mixedResults[result.index] = result;
+    assert(mixedResults.slice(0, 40).every((r) => r.ok), 'Every mixed-key item should verify');
+    assert(!mixedResults[40].ok && /Invalid public key length/.test(mixedResults[40].error), 'A malformed key should be reported');
+    console.log('  ✓ Mixed-key batches split across key owners');
+
+    // A worker that exits without an error rejects its requests and is restarted
+    console.log('- Testing worker exits...');
+    const exiting = pool._leastLoaded();
+    const lost = pool.keypair();
+    await exiting.worker.terminate();
+    await assert.rejects(lost, /exited with code/);
+    assert.notEqual(exiting.worker, null, 'A first exit should restart the worker at once');
+    assert.equal((await pool.stats()).restarts, 1, 'Restarts should be counted');
+    assert.equal(await pool.verify(message, signature, publicKey), true, 'Pool should keep working after a restart');
+    console.log('  ✓ Exited worker rejected its request and was restarted');
+
+    // Errors in a worker reject only that request
+    console.log('- Testing error propagation...');
+    await assert.rejects(pool.sign(message, new Uint8Array(10)), /Invalid secret key length/);
+    assert.equal(await pool.verify(message, signature, publicKey), true, 'Pool should keep working after an error');
+    console.log('  ✓ Worker errors reject the request only');
+  } finally {
+    await pool.close();
+  }
+
+  await assert.rejects(pool.sign('closed', new Uint8Array(2305)), /FalconPool closed/);
+
+  // Queue wait grows the pool under load; idle samples shrink it back to min
+  console.log('- Testing autoscaling...');
+  assert.throws(() => new FalconPool({ autoscale: { min: 3, max: 2 } }), /Invalid autoscale range/);
+  const scaling = new FalconPool({
+    keyCacheSize: 4,
+    autoscale: { min: 1, max: 3, intervalMs: 50, scaleUpWaitMs: 5, upIntervals: 1, downIntervals: 3 },
+  });
+  const events = [];
+  scaling.on('scale', (event) => events.push(event));
+  try {
+    assert.equal(scaling.size, 1, 'Autoscaling pool should start at min');
+    const { publicKey, secretKey } = await falcon.keypair();
+    const deadline = Date.now() + 10000;
+    let round = 0;
+    while (!events.some((e) => e.action === 'up') && Date.now() < deadline) {
+      const signatures = await Promise.all(Array.from({ length: 32 }, (_, i) => scaling.sign(`load ${round} ${i}`, secretKey)));
+      assert.equal(await falcon.verify(`load ${round} 0`, signatures[0], publicKey), true, 'Signatures should verify while scaling');
+      round++;
+    }
+    const up = events.find((e) => e.action === 'up');
+    assert(up, 'Queue wait should trigger a scale-up');
+    assert(up.sample.waitP95 > 5 || up.sample.utilization > 0.85, 'Scale-up should report the triggering sample');
+    assert(scaling.size > 1 && scaling.size <= 3, `Pool should grow within max, got ${scaling.size}`);
+
+    while (scaling.size > 1 && Date.now() < deadline) {
+      await new Promise((resolve) => setTimeout(resolve, 50));
+    }
+    const stats = await scaling.stats();
+    assert.equal(scaling.size, 1, 'Idle pool should shrink back to min');
+    assert(events.some((e) => e.action === 'down' && e.reason === 'idle'), 'Scale-down should be emitted');
+    assert.equal(stats.autoscale.draining, 0, 'Retired workers should be terminated');
+    assert(stats.autoscale.scaleUps >= 1 && stats.autoscale.scaleDowns >= 1, 'Stats should count scaling decisions');
+    assert.equal(await scaling.verify('after scaling', await scaling.sign('after scaling', secretKey), publicKey), true,
+      'Pool should keep working after shrinking');
+    console.log(`  ✓ Grew to ${Math.max(...events.map((e) => e.size))} workers (p95 wait ${up.sample.waitP95.toFixed(1)} ms), shrank to ${scaling.size}`);
+  } finally {
+    await scaling.close();
+  }
+
+  // A worker that fails while starting (here on an invalid memory budget)
+  // is restarted with a growing delay, not in a loop
+  console.log('- Testing worker crashes at startup...');
+  const crashing = new FalconPool({ memoryBudget: -1, autoscale: { min: 1, max: 2, intervalMs: 50 } });
+  try {
+    await assert.rejects(crashing.sign('crash', new Uint8Array(2305)), /Memory budget must be a positive number/);
+    await new Promise((resolve) => setTimeout(resolve, 500));
+    const [crashed] = crashing._slots;
+    // At once, then after 100, 200 and 400 ms
+    assert(crashed.restarts >= 2 && crashed.restarts <= 4, `Restarts should back off, got ${crashed.restarts}`);
+    assert.equal(crashed.crashes, crashed.restarts, 'Crashes soon after starting should count towards the backoff');
+    console.log(`  ✓ ${crashed.restarts} restarts in 500 ms with backoff`);
+  } finally {
+    await crashing.close();
+  }
+
+  console.log('✅ All FalconPool tests passed!');
+}
+
+runTests().catch((error) => {
+  console.error('❌ Test failed:', error);
+  process.exit(1);
+});
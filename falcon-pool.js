@@ -0,0 +1,820 @@
+/**
+ * Falcon Signatures - Worker pool with key-affinity routing (Node.js only)
+ */
+import { Worker } from 'worker_threads';
+import { createHash } from 'crypto';
+import { EventEmitter } from 'events';
+import { performance } from 'perf_hooks';
+import os from 'os';
+
+const WORKER_URL = new URL('./falcon-worker.js', import.meta.url);
+
+// A worker or shard that exits sooner than this after starting is restarted
+// with an exponential backoff instead of at once
+export const RESPAWN_STABLE_MS = 5000;
+
+/**
+ * Convert a hex string or byte array to a Uint8Array
+ * @private
+ */
+function toBytes(value) {
+  return typeof value === 'string' ? new Uint8Array(Buffer.from(value, 'hex')) : value;
+}
+
+/**
+ * Convert a string message or byte array to a Uint8Array
+ * @private
+ */
+function messageBytes(message) {
+  return typeof message === 'string' ? new TextEncoder().encode(message) : message;
+}
+
+/**
+ * Value at a percentile of sorted samples
+ * @private
+ */
+function percentile(sorted, p) {
+  if (sorted.length === 0) return 0;
+  return sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+}
+
+/**
+ * Compute the fingerprint used to route and cache a key
+ * @param {Uint8Array|string} key - Secret or public key (Uint8Array or hex string)
+ * @returns {string} First 128 bits of SHA-256(key), hex encoded
+ */
+export function keyFingerprint(key) {
+  return createHash('sha256').update(toBytes(key)).digest('hex').slice(0, 32);
+}
+
+/**
+ * Count a crash of a pool worker or cluster shard and restart it: at once
+ * after a crash following a stable run, otherwise after a delay that doubles
+ * with each crash
+ * @param {Object} unit - Worker slot or shard ({ crashes, restarts, startedAt, respawnTimer })
+ * @param {Function} respawn - Restarts the unit
+ * @param {Object} options - Backoff options
+ * @param {number} options.respawnDelayMs - Delay after the second crash in a row
+ * @param {number} options.maxRespawnDelayMs - Longest delay
+ */
+export function scheduleRespawn(unit, respawn, { respawnDelayMs, maxRespawnDelayMs }) {
+  unit.crashes = Date.now() - unit.startedAt >= RESPAWN_STABLE_MS ? 1 : unit.crashes + 1;
+  unit.restarts++;
+  if (unit.crashes === 1) {
+    respawn();
+    return;
+  }
+  const delay = Math.min(maxRespawnDelayMs, respawnDelayMs * 2 ** (unit.crashes - 2));
+  unit.respawnTimer = setTimeout(respawn, delay);
+  unit.respawnTimer.unref();
+}
+
+/**
+ * HashRing - Consistent hashing of key fingerprints onto nodes
+ *
+ * Each node is placed at `virtualNodes` points on a 32-bit ring; a fingerprint
+ * maps to the first node point at or after its own position. Adding or
+ * removing a node only moves the fingerprints adjacent to its points.
+ */
+export class HashRing {
+  /**
+   * Create a new hash ring
+   * @param {Object} options - Ring options
+   * @param {number} options.virtualNodes - Points per node (default: 64)
+   */
+  constructor({ virtualNodes = 64 } = {}) {
+    this.virtualNodes = virtualNodes;
+    this._nodes = new Set();
+    this._points = [];
+  }
+
+  /**
+   * Nodes currently on the ring
+   */
+  get nodes() {
+    return Array.from(this._nodes);
+  }
+
+  /**
+   * Add a node to the ring
+   * @param {string|number} node - Node identifier
+   */
+  add(node) {
+    if (this._nodes.has(node)) return;
+    this._nodes.add(node);
+    for (let v = 0; v < this.virtualNodes; v++) {
+      const hash = createHash('sha256').update(`${node}#${v}`).digest();
+      this._points.push({ position: hash.readUInt32BE(0), node });
+    }
+    this._points.sort((a, b) => a.position - b.position);
+  }
+
+  /**
+   * Remove a node from the ring
+   * @param {string|number} node - Node identifier
+   */
+  remove(node) {
+    if (!this._nodes.delete(node)) return;
+    this._points = this._points.filter((p) => p.node !== node);
+  }
+
+  /**
+   * Find the node owning a fingerprint
+   * @param {string} fingerprint - Hex fingerprint (see keyFingerprint)
+   * @returns {string|number|undefined} Owning node, or undefined for an empty ring
+   */
+  lookup(fingerprint) {
+    if (this._points.length === 0) return undefined;
+    const position = parseInt(fingerprint.slice(0, 8), 16);
+
+    // First point at or after the position, wrapping around
+    let lo = 0;
+    let hi = this._points.length;
+    while (lo < hi) {
+      const mid = (lo + hi) >>> 1;
+      if (this._points[mid].position < position) lo = mid + 1;
+      else hi = mid;
+    }
+    return this._points[lo === this._points.length ? 0 : lo].node;
+  }
+}
+
+/**
+ * FalconPool - Falcon operations on a pool of worker threads
+ *
+ * Requests for a key are routed to the worker that owns the key's fingerprint
+ * on a consistent-hash ring, so each worker keeps only its share of keys
+ * loaded in its WebAssembly memory. When a worker's queue grows beyond
+ * `stealThreshold`, idle workers steal requests from the tail of that queue.
+ *
+ * With `autoscale`, the pool starts at `min` workers and samples queue wait
+ * and worker busy time every `intervalMs`. It adds a worker after `upIntervals`
+ * consecutive samples over the scale-up thresholds and retires one after
+ * `downIntervals` consecutive samples under the scale-down thresholds; a
+ * retired worker leaves the ring, hands its queue to the new owners and is
+ * terminated (freeing its WebAssembly memory) once its in-flight requests
+ * complete. Every decision is emitted as a `scale` event, and every sample as
+ * a `sample` event.
+ *
+ * A worker that exits, by crashing or otherwise, rejects its in-flight
+ * requests and is restarted in place, with the same backoff as a cluster
+ * shard (see scheduleRespawn); requests queued for it meanwhile wait for the
+ * restart or are stolen by idle workers.
+ */
+export class FalconPool extends EventEmitter {
+  /**
+   * Create a new worker pool
+   * @param {Object} options - Pool options
+   * @param {number} options.size - Number of workers (default: available parallelism)
+   * @param {number} options.keyCacheSize - Loaded keys kept per worker (default: 64)
+   * @param {number} options.treeLevels - LDL-tree levels cached per secret key (default: none, see Falcon.loadKey)
+   * @param {boolean} options.keyCacheAdmission - TinyLFU admission in front of each worker's key cache (default: true)
+   * @param {number} options.midstateCacheSize - Secret-key midstates kept per worker for keys outside
+   *   the key cache (default: 1/16 of the worker's WebAssembly memory, 0 disables; see MidstateCache)
+   * @param {number} options.memoryBudget - Bytes each worker may hold in loaded keys and memoized
+   *   results, evicting what is cheapest to recompute per byte (default: no budget, no result memo)
+   * @param {number} options.stealThreshold - Queue length above which idle workers steal (default: 4)
+   * @param {number} options.maxInflight - Requests posted to a worker at once (default: 2)
+   * @param {number} options.virtualNodes - Hash ring points per worker (default: 64)
+   * @param {number} options.respawnDelayMs - First restart delay of a worker that keeps crashing; doubles per crash (default: 100)
+   * @param {number} options.maxRespawnDelayMs - Longest restart delay (default: 10000)
+   * @param {Object|boolean} options.autoscale - Scale between min and max workers (default: fixed size)
+   * @param {number} options.autoscale.min - Minimum workers (default: 1)
+   * @param {number} options.autoscale.max - Maximum workers (default: size)
+   * @param {number} options.autoscale.intervalMs - Sampling interval (default: 500)
+   * @param {number} options.autoscale.scaleUpWaitMs - p95 queue wait above which to grow (default: 20)
+   * @param {number} options.autoscale.scaleUpUtilization - Busy fraction above which to grow (default: 0.85)
+   * @param {number} options.autoscale.scaleDownWaitMs - p95 queue wait below which to shrink (default: 2)
+   * @param {number} options.autoscale.scaleDownUtilization - Busy fraction below which to shrink (default: 0.25)
+   * @param {number} options.autoscale.upIntervals - Consecutive samples before growing (default: 2)
+   * @param {number} options.autoscale.downIntervals - Consecutive samples before shrinking (default: 10)
+   */
+  constructor({
+    size = os.availableParallelism?.() ?? os.cpus().length,
+    keyCacheSize = 64,
+    treeLevels = null,
+    keyCacheAdmission = true,
+    midstateCacheSize = null,
+    memoryBudget = null,
+    stealThreshold = 4,
+    maxInflight = 2,
+    virtualNodes = 64,
+    respawnDelayMs = 100,
+    maxRespawnDelayMs = 10000,
+    autoscale = null,
+  } = {}) {
+    super();
+    this.keyCacheSize = keyCacheSize;
+    this.treeLevels = treeLevels;
+    this.keyCacheAdmission = keyCacheAdmission;
+    this.midstateCacheSize = midstateCacheSize;
+    this.memoryBudget = memoryBudget;
+    this.stealThreshold = stealThreshold;
+    this.maxInflight = maxInflight;
+    this.respawnDelayMs = respawnDelayMs;
+    this.maxRespawnDelayMs = maxRespawnDelayMs;
+    this.ring = new HashRing({ virtualNodes });
+
+    this._slots = [];
+    this._pending = new Map();
+    this._nextRequestId = 1;
+    this._nextSlotId = 0;
+    this._closed = false;
+
+    this.autoscale = autoscale ? {
+      min: 1,
+      max: Math.max(1, size),
+      intervalMs: 500,
+      scaleUpWaitMs: 20,
+      scaleUpUtilization: 0.85,
+      scaleDownWaitMs: 2,
+      scaleDownUtilization: 0.25,
+      upIntervals: 2,
+      downIntervals: 10,
+      ...(autoscale === true ? {} : autoscale),
+    } : null;
+    if (this.autoscale && !(this.autoscale.min >= 1 && this.autoscale.min <= this.autoscale.max)) {
+      throw new Error(`Invalid autoscale range: ${this.autoscale.min}..${this.autoscale.max}`);
+    }
+    this._draining = new Set();
+    this._queueWaits = [];
+    this._scaling = { upStreak: 0, downStreak: 0, scaleUps: 0, scaleDowns: 0, lastSample: null };
+
+    const initial = this.autoscale ? this.autoscale.min : Math.max(1, size);
+    for (let i = 0; i < initial; i++) {
+      this._addWorker();
+    }
+
+    if (this.autoscale) {
+      this._sampledAt = performance.now();
+      this._timer = setInterval(() => this._evaluateScaling(), this.autoscale.intervalMs);
+      this._timer.unref();
+    }
+  }
+
+  /**
+   * Number of workers in the pool
+   */
+  get size() {
+    return this._slots.length;
+  }
+
+  /**
+   * Generate a Falcon keypair on the least loaded worker
+   * @returns {Promise<Object>} An object containing the public and private keys as Uint8Arrays
+   */
+  keypair() {
+    return this._submit('keypair', {}, null);
+  }
+
+  /**
+   * Sign a message on the worker owning the secret key
+   * @param {Uint8Array|string} message - The message to sign (string or Uint8Array)
+   * @param {Uint8Array|string} secretKey - The secret key (Uint8Array or hex string)
+   * @returns {Promise<Uint8Array>} The compressed signature
+   */
+  sign(message, secretKey) {
+    const sk = toBytes(secretKey);
+    const fingerprint = keyFingerprint(sk);
+    return this._submit('sign', { message: messageBytes(message), secretKey: sk, fingerprint }, fingerprint);
+  }
+
+  /**
+   * Verify a compressed signature on the worker owning the public key
+   * @param {Uint8Array|string} message - The message (string or Uint8Array)
+   * @param {Uint8Array|string} signature - The compressed signature (Uint8Array or hex string)
+   * @param {Uint8Array|string} publicKey - The public key (Uint8Array or hex string)
+   * @returns {Promise<boolean>} True if the signature is valid, false otherwise
+   */
+  verify(message, signature, publicKey) {
+    const pk = toBytes(publicKey);
+    const fingerprint = keyFingerprint(pk);
+    return this._submit('verify', {
+      message: messageBytes(message),
+      signature: toBytes(signature),
+      publicKey: pk,
+      fingerprint,
+    }, fingerprint);
+  }
+
+  /**
+   * Verify a constant-time signature on the worker owning the public key
+   * @param {Uint8Array|string} message - The message (string or Uint8Array)
+   * @param {Uint8Array|string} signature - The constant-time signature (Uint8Array or hex string)
+   * @param {Uint8Array|string} publicKey - The public key (Uint8Array or hex string)
+   * @returns {Promise<boolean>} True if the signature is valid, false otherwise
+   */
+  verifyConstantTime(message, signature, publicKey) {
+    const pk = toBytes(publicKey);
+    const fingerprint = keyFingerprint(pk);
+    return this._submit('verifyConstantTime', {
+      message: messageBytes(message),
+      signature: toBytes(signature),
+      publicKey: pk,
+      fingerprint,
+    }, fingerprint);
+  }
+
+  /**
+   * Convert a compressed signature to constant-time format on the least loaded worker
+   * @param {Uint8Array|string} compressedSignature - The compressed signature to convert
+   * @returns {Promise<Uint8Array>} The constant-time signature
+   */
+  convertToConstantTime(compressedSignature) {
+    return this._submit('convertToConstantTime', { signature: toBytes(compressedSignature) }, null);
+  }
+
+  /**
+   * Verify a stream of signatures across the workers
+   *
+   * Items are grouped into batches, and up to maxInflightBatches batches are
+   * verified at once. Each batch is split by public key across the workers
+   * owning the keys on the hash ring, which verify their share with the keys
+   * loaded from their key caches, as single verifications do. The source is
+   * pulled only while fewer batches are in flight, so memory stays bounded
+   * and a slow consumer slows the producer down. Items lost to a worker
+   * failure are yielded with `ok: false` and the error.
+   * @param {AsyncIterable<Object>|Iterable<Object>} source - Items of { message, signature, publicKey }
+   * @param {Object} options - Stream options
+   * @param {number} options.batchSize - Items per batch (default: 64)
+   * @param {number} options.maxBatchBytes - Message and signature bytes per batch (default: 1 MiB)
+   * @param {number} options.maxInflightBatches - Batches verified at once (default: size x maxInflight)
+   * @param {boolean} options.constantTime - Signatures are in constant-time format (default: false)
+   * @returns {AsyncGenerator<Object>} { index, ok, error? } per item, in batch completion order
+   */
+  async *verifyStream(source, {
+    batchSize = 64,
+    maxBatchBytes = 1 << 20,
+    maxInflightBatches = this.size * this.maxInflight,
+    constantTime = false,
+  } = {}) {
+    const inflight = new Map();
+    let nextBatch = 0;
+    let batch = [];
+    let bytes = 0;
+    let start = 0;
+
+    const submit = () => {
+      const id = nextBatch++;
+      const first = start;
+      const count = batch.length;
+
+      // One request per owning worker, in its key cache's order of keys
+      const parts = new Map();
+      batch.forEach(({ message, signature, publicKey }, index) => {
+        const pk = toBytes(publicKey);
+        const fingerprint = pk instanceof Uint8Array ? keyFingerprint(pk) : null;
+        const owner = fingerprint !== null ? this._ownerOf(fingerprint) : null;
+        let part = parts.get(owner);
+        if (!part) parts.set(owner, part = { fingerprint, indices: [], items: [] });
+        part.indices.push(index);
+        part.items.push({ message: messageBytes(message), signature: toBytes(signature), publicKey: pk, fingerprint });
+      });
+
+      const results = new Array(count);
+      inflight.set(id, Promise.all(Array.from(parts.values(), ({ fingerprint, indices, items }) =>
+        this._submit('verifyBatch', { items, constantTime }, fingerprint).then(
+          (partResults) => indices.forEach((index, i) => { results[index] = partResults[i]; }),
+          (error) => indices.forEach((index) => { results[index] = { ok: false, error: error.message }; }),
+        ))).then(() => ({ id, first, results })));
+      start += count;
+      batch = [];
+      bytes = 0;
+    };
+
+    async function* settle(limit) {
+      while (inflight.size > limit) {
+        const { id, first, results } = await Promise.race(inflight.values());
+        inflight.delete(id);
+        for (let i = 0; i < results.length; i++) yield { index: first + i, ...results[i] };
+      }
+    }
+
+    for await (const item of source) {
+      batch.push(item);
+      bytes += (item.message?.length ?? 0) + (item.signature?.length ?? 0);
+      if (batch.length >= batchSize || bytes >= maxBatchBytes) {
+        submit();
+        yield* settle(Math.max(1, maxInflightBatches) - 1);
+      }
+    }
+    if (batch.length > 0) submit();
+    yield* settle(0);
+  }
+
+  /**
+   * Pool metrics: per-worker queue depth, completions, steals, restarts, key and midstate caches and memory budget
+   * @returns {Promise<Object>} Pool statistics (workers waiting for a restart are left out of `workers`)
+   */
+  async stats() {
+    const running = this._slots.filter((slot) => slot.worker);
+    const workers = await Promise.all(running.map(async (slot) => {
+      const { cache, midstates, budget } = await this._post(slot, 'stats', {});
+      return {
+        id: slot.id,
+        queued: slot.queue.length,
+        inflight: slot.inflight,
+        completed: slot.completed,
+        steals: slot.steals,
+        restarts: slot.restarts,
+        cache,
+        midstates,
+        ...(budget && { budget }),
+      };
+    }));
+
+    const hits = workers.reduce((n, w) => n + w.cache.hits, 0);
+    const misses = workers.reduce((n, w) => n + w.cache.misses, 0);
+    return {
+      size: this._slots.length,
+      completed: workers.reduce((n, w) => n + w.completed, 0),
+      steals: workers.reduce((n, w) => n + w.steals, 0),
+      restarts: this._slots.reduce((n, slot) => n + slot.restarts, 0),
+      cacheHitRate: hits + misses === 0 ? 0 : hits / (hits + misses),
+      workers,
+      ...(this.autoscale && {
+        autoscale: {
+          min: this.autoscale.min,
+          max: this.autoscale.max,
+          draining: this._draining.size,
+          scaleUps: this._scaling.scaleUps,
+          scaleDowns: this._scaling.scaleDowns,
+          lastSample: this._scaling.lastSample,
+        },
+      }),
+    };
+  }
+
+  /**
+   * Terminate all workers; queued and in-flight requests are rejected
+   */
+  async close() {
+    this._closed = true;
+    clearInterval(this._timer);
+    const error = new Error('FalconPool closed');
+    for (const slot of this._slots) {
+      for (const task of slot.queue) task.reject(error);
+      slot.queue = [];
+    }
+    for (const [id, task] of this._pending) {
+      this._pending.delete(id);
+      task.reject(error);
+    }
+    const slots = [...this._slots, ...this._draining];
+    this._slots = [];
+    this._draining.clear();
+    for (const slot of slots) clearTimeout(slot.respawnTimer);
+    await Promise.all(slots.map((slot) => slot.worker?.terminate()));
+  }
+
+  /**
+   * Start a worker and place it on the hash ring
+   * @private
+   */
+  _addWorker() {
+    const slot = {
+      id: this._nextSlotId++,
+      worker: null,
+      queue: [],
+      inflight: 0,
+      completed: 0,
+      steals: 0,
+      busySince: 0,
+      busyMs: 0,
+      utilization: 0,
+      draining: false,
+      restarts: 0,
+      crashes: 0,
+      startedAt: 0,
+      respawnTimer: null,
+    };
+    this._spawn(slot);
+    this._slots.push(slot);
+    this.ring.add(slot.id);
+    return slot;
+  }
+
+  /**
+   * Create the worker thread of a slot; a worker that exits is replaced in
+   * place, after a growing delay if it keeps exiting soon after starting
+   * @private
+   */
+  _spawn(slot) {
+    slot.respawnTimer = null;
+    const worker = new Worker(WORKER_URL, {
+      workerData: {
+        keyCacheSize: this.keyCacheSize,
+        treeLevels: this.treeLevels,
+        admission: this.keyCacheAdmission,
+        midstateCacheSize: this.midstateCacheSize,
+        memoryBudget: this.memoryBudget,
+      },
+    });
+    worker.on('message', (message) => this._onMessage(slot, message));
+    // An uncaught error is followed by 'exit'; so is process.exit() in the
+    // worker or a terminate(), which emit no 'error'
+    let failure = null;
+    worker.on('error', (error) => {
+      failure = error;
+    });
+    worker.on('exit', (code) => {
+      if (slot.worker !== worker) return;
+      slot.worker = null;
+      const error = failure ?? new Error(`Worker ${slot.id} exited with code ${code}`);
+      for (const [id, task] of this._pending) {
+        if (task.slot === slot) {
+          this._pending.delete(id);
+          task.reject(error);
+        }
+      }
+      this._markIdle(slot);
+      if (slot.draining) {
+        this._retired(slot);
+      } else if (!this._closed) {
+        scheduleRespawn(slot, () => {
+          if (this._closed || slot.draining) return;
+          this._spawn(slot);
+          this._pump(slot);
+        }, this);
+      }
+    });
+    slot.worker = worker;
+    slot.startedAt = Date.now();
+  }
+
+  /**
+   * Queue a request on the worker owning the fingerprint (or the least loaded one)
+   * @private
+   */
+  _submit(op, args, fingerprint) {
+    if (this._closed) return Promise.reject(new Error('FalconPool closed'));
+
+    return new Promise((resolve, reject) => {
+      const slot = fingerprint !== null ? this._ownerOf(fingerprint) : this._leastLoaded();
+      slot.queue.push({ op, args, fingerprint, resolve, reject, enqueuedAt: performance.now() });
+      this._pump(slot);
+
+      // Over-threshold queue: wake idle workers so they can steal
+      if (slot.queue.length > this.stealThreshold) {
+        for (const other of this._slots) {
+          if (other !== slot && other.inflight === 0) this._pump(other);
+        }
+      }
+    });
+  }
+
+  /**
+   * Slot owning a fingerprint on the hash ring
+   * @private
+   */
+  _ownerOf(fingerprint) {
+    const id = this.ring.lookup(fingerprint);
+    return this._slots.find((slot) => slot.id === id) ?? this._leastLoaded();
+  }
+
+  /**
+   * Slot with the fewest queued and in-flight requests
+   * @private
+   */
+  _leastLoaded() {
+    // A worker waiting for a restart takes requests only if all of them are
+    const load = (slot) => (slot.worker ? slot.queue.length + slot.inflight : Infinity);
+    let best = this._slots[0];
+    for (const slot of this._slots) {
+      if (load(slot) < load(best)) best = slot;
+    }
+    return best;
+  }
+
+  /**
+   * Post queued requests to a worker, stealing when its own queue is empty
+   * @private
+   */
+  _pump(slot) {
+    if (slot.draining || !slot.worker) return;
+    while (slot.inflight < this.maxInflight) {
+      let task = slot.queue.shift();
+      if (!task) {
+        task = this._steal(slot);
+        if (!task) break;
+      }
+      this._dispatch(slot, task);
+    }
+  }
+
+  /**
+   * Take a request from the tail of the longest over-threshold queue
+   * @private
+   */
+  _steal(thief) {
+    let victim = null;
+    for (const slot of this._slots) {
+      if (slot !== thief && slot.queue.length > this.stealThreshold &&
+          (!victim || slot.queue.length > victim.queue.length)) {
+        victim = slot;
+      }
+    }
+    if (!victim) return null;
+    thief.steals++;
+    return victim.queue.pop();
+  }
+
+  /**
+   * Send a queued request to a worker
+   * @private
+   */
+  _dispatch(slot, task) {
+    const now = performance.now();
+    if (this.autoscale) this._queueWaits.push(now - task.enqueuedAt);
+    if (slot.inflight === 0) slot.busySince = now;
+    slot.inflight++;
+    this._post(slot, task.op, task.args, true).then(task.resolve, task.reject);
+  }
+
+  /**
+   * Post a request to a worker and wait for its reply
+   * @private
+   */
+  _post(slot, op, args, counted = false) {
+    if (!slot.worker) return Promise.reject(new Error(`Worker ${slot.id} is not running`));
+    return new Promise((resolve, reject) => {
+      const id = this._nextRequestId++;
+      this._pending.set(id, { resolve, reject, slot, counted });
+      slot.worker.postMessage({ id, op, args });
+    });
+  }
+
+  /**
+   * Handle a worker reply
+   * @private
+   */
+  _onMessage(slot, { id, result, error }) {
+    const task = this._pending.get(id);
+    if (!task) return;
+    this._pending.delete(id);
+
+    if (task.counted) {
+      slot.inflight--;
+      slot.completed++;
+      if (slot.inflight === 0) slot.busyMs += performance.now() - slot.busySince;
+    }
+    if (error) task.reject(new Error(error));
+    else task.resolve(result);
+
+    if (task.counted) {
+      if (!slot.draining) this._pump(slot);
+      else if (slot.inflight === 0) this._retired(slot);
+    }
+  }
+
+  /**
+   * Account the busy time of a slot whose in-flight requests were dropped
+   * @private
+   */
+  _markIdle(slot) {
+    if (slot.inflight > 0) slot.busyMs += performance.now() - slot.busySince;
+    slot.inflight = 0;
+  }
+
+  /**
+   * Sample queue wait and utilization, then grow or shrink the pool
+   * @private
+   */
+  _evaluateScaling() {
+    if (this._closed) return;
+    const now = performance.now();
+    const elapsed = Math.max(1, now - this._sampledAt);
+    this._sampledAt = now;
+
+    // Busy time over the interval, including requests still in flight
+    let busy = 0;
+    for (const slot of this._slots) {
+      if (slot.inflight > 0) {
+        slot.busyMs += now - slot.busySince;
+        slot.busySince = now;
+      }
+      slot.utilization = Math.min(1, slot.busyMs / elapsed);
+      busy += slot.busyMs;
+      slot.busyMs = 0;
+    }
+
+    // Requests still queued have waited at least this long
+    const waits = this._queueWaits;
+    this._queueWaits = [];
+    let queued = 0;
+    for (const slot of this._slots) {
+      queued += slot.queue.length;
+      for (const task of slot.queue) waits.push(now - task.enqueuedAt);
+    }
+    waits.sort((a, b) => a - b);
+
+    const sample = {
+      size: this._slots.length,
+      queued,
+      utilization: busy / (elapsed * this._slots.length),
+      waitP50: percentile(waits, 0.5),
+      waitP95: percentile(waits, 0.95),
+      waitP99: percentile(waits, 0.99),
+    };
+    this._scaling.lastSample = sample;
+    this.emit('sample', sample);
+
+    // Hysteresis: act only on consecutive samples past the same threshold
+    const options = this.autoscale;
+    const state = this._scaling;
+    const overWait = sample.waitP95 > options.scaleUpWaitMs;
+    if (overWait || sample.utilization > options.scaleUpUtilization) {
+      state.upStreak++;
+      state.downStreak = 0;
+    } else if (sample.waitP95 < options.scaleDownWaitMs && sample.utilization < options.scaleDownUtilization) {
+      state.downStreak++;
+      state.upStreak = 0;
+    } else {
+      state.upStreak = 0;
+      state.downStreak = 0;
+    }
+
+    if (state.upStreak >= options.upIntervals && this._slots.length < options.max) {
+      state.upStreak = 0;
+      state.scaleUps++;
+      const slot = this._addWorker();
+      this._rebalanceQueues();
+      this.emit('scale', {
+        action: 'up',
+        worker: slot.id,
+        size: this._slots.length,
+        reason: overWait ? 'queue-wait' : 'utilization',
+        sample,
+      });
+    } else if (state.downStreak >= options.downIntervals && this._slots.length > options.min) {
+      state.downStreak = 0;
+      state.scaleDowns++;
+      const slot = this._slots.reduce((a, b) =>
+        (b.utilization + b.queue.length + b.inflight < a.utilization + a.queue.length + a.inflight ? b : a));
+      this._retire(slot);
+      this.emit('scale', {
+        action: 'down',
+        worker: slot.id,
+        size: this._slots.length,
+        reason: 'idle',
+        sample,
+      });
+    }
+  }
+
+  /**
+   * Move queued requests whose keys now belong to another worker
+   * @private
+   */
+  _rebalanceQueues() {
+    for (const slot of this._slots) {
+      const keep = [];
+      for (const task of slot.queue) {
+        const owner = task.fingerprint !== null ? this._ownerOf(task.fingerprint) : slot;
+        if (owner === slot) keep.push(task);
+        else owner.queue.push(task);
+      }
+      slot.queue = keep;
+    }
+    for (const slot of this._slots) this._pump(slot);
+  }
+
+  /**
+   * Take a worker off the ring and terminate it once its requests complete
+   * @private
+   */
+  _retire(slot) {
+    this._slots.splice(this._slots.indexOf(slot), 1);
+    this.ring.remove(slot.id);
+    slot.draining = true;
+    this._draining.add(slot);
+
+    const queued = slot.queue;
+    slot.queue = [];
+    for (const task of queued) {
+      const owner = task.fingerprint !== null ? this._ownerOf(task.fingerprint) : this._leastLoaded();
+      owner.queue.push(task);
+      this._pump(owner);
+    }
+    if (slot.inflight === 0) this._retired(slot);
+  }
+
+  /**
+   * Terminate a drained worker, releasing its WebAssembly memory
+   * @private
+   */
+  _retired(slot) {
+    if (!this._draining.delete(slot)) return;
+    clearTimeout(slot.respawnTimer);
+    const error = new Error('FalconPool worker retired');
+    for (const [id, task] of this._pending) {
+      if (task.slot === slot) {
+        this._pending.delete(id);
+        task.reject(error);
+      }
+    }
+    slot.worker?.terminate();
+  }
+}
+
+export default FalconPool;
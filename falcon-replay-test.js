@@ -0,0 +1,114 @@
+#!/usr/bin/env node
+import Falcon from './index.js';
+import { FalconPool } from './falcon-pool.js';
+import { FalconCluster } from './falcon-cluster.js';
+import { TraceReplayer } from './falcon-replay.js';
+import { strict as assert } from 'assert';
+
+/**
+ * Test trace recording and replay
+ */
+async function runTests() {
+  console.log('🧪 Testing trace recording and replay...');
+  const falcon = new Falcon({ print: () => {}, printErr: () => {} });
+
+  const signers = [await falcon.keypair(), await falcon.keypair()];
+  const loaded = await falcon.loadKey(signers[1].publicKey, 'public');
+  const hot = 'A message signed and verified again and again';
+
+  // Operations are recorded with sizes and fingerprints, never their bytes
+  console.log('- Testing trace recording...');
+  falcon.startTrace();
+  const signature = await falcon.sign(hot, signers[0].secretKey);
+  await falcon.sign(hot, signers[0].secretKey);
+  await falcon.verify(hot, signature, signers[0].publicKey);
+  await falcon.verify(hot, signature, Falcon.bytesToHex(signers[0].publicKey));
+  await falcon.verify('tampered', signature, signers[0].publicKey);
+  const other = await falcon.sign('x'.repeat(4096), signers[1].secretKey);
+  await falcon.verify('x'.repeat(4096), other, loaded);
+  await falcon.verifyBatch([
+    { message: hot, signature, publicKey: signers[0].publicKey },
+    { message: 'x'.repeat(4096), signature: other, publicKey: signers[1].publicKey },
+  ]);
+  await falcon.convertToConstantTime(signature);
+  await assert.rejects(falcon.sign(hot, new Uint8Array(10)));
+  const trace = falcon.stopTrace();
+  falcon.releaseKey(loaded);
+
+  assert.equal(trace.version, 1);
+  assert.equal(trace.events.length, 10, 'Every operation should be recorded');
+  assert.deepEqual(trace.events.map((e) => e.op), ['sign', 'sign', 'verify', 'verify', 'verify', 'sign', 'verify', 'verifyBatch', 'convertToConstantTime', 'sign']);
+  const [sign1, sign2, verify1, verifyHex, tampered, signOther, verifyLoaded, batch] = trace.events;
+  assert.equal(sign1.input, sign2.input, 'Repeated inputs should share a hash');
+  assert.equal(sign1.messageBytes, hot.length);
+  assert.notEqual(sign1.key, signOther.key, 'Different keys should have different fingerprints');
+  assert.equal(verify1.key, verifyHex.key, 'A hex key should have the same fingerprint as its bytes');
+  assert.equal(verifyLoaded.key, batch.items[1].key, 'A loaded key should have the same fingerprint as its bytes');
+  assert.equal(verify1.input, batch.items[0].input, 'Batch items should hash like single verifications');
+  assert.equal(tampered.ok, false);
+  assert.equal(verify1.ok, true);
+  assert.equal(trace.events[9].error, true, 'Failed operations should be marked');
+  assert(trace.events.every((e, i) => e.ms >= 0 && (i === 0 || e.t >= trace.events[i - 1].t)), 'Events should be timed and in order');
+  const json = JSON.stringify(trace);
+  for (const secret of [signers[0].secretKey, signers[0].publicKey, signature]) {
+    assert(!json.includes(Falcon.bytesToHex(secret).slice(0, 16)), 'Key and signature bytes should not be recorded');
+  }
+  assert(!json.includes('tampered'), 'Messages should not be recorded');
+  assert.equal(Object.hasOwn(falcon, 'sign'), false, 'Stopping the trace should restore the operations');
+  falcon.startTrace();
+  await falcon.sign(hot, signers[0].secretKey);
+  const [again] = falcon.stopTrace().events;
+  assert.notEqual(again.key, sign1.key, 'Fingerprints should be keyed per trace');
+  assert.notEqual(again.input, sign1.input, 'Input hashes should be keyed per trace');
+  console.log(`  ✓ ${trace.events.length} operations recorded in ${json.length} bytes of JSON`);
+
+  // Synthesized inputs reproduce key reuse, sizes and outcomes
+  console.log('- Testing replay against Falcon...');
+  const replayer = new TraceReplayer(JSON.parse(json));
+  const prepared = await replayer.prepare();
+  assert.equal(prepared.skipped, 1, 'The failed operation should be skipped');
+  assert.equal(prepared.keys, 5, 'One keypair per key fingerprint, plus one for conversions');
+  const profile = replayer.profile();
+  assert.equal(profile.distinctKeys, 4, 'Two secret and two public key fingerprints');
+  assert(profile.inputRepeatRate > 0, 'Repeated inputs should be counted');
+
+  const direct = await replayer.replay(new Falcon({ print: () => {}, printErr: () => {} }), { speed: 4 });
+  assert.equal(direct.events, 9);
+  assert.equal(direct.errors, 0, 'Replayed operations should succeed');
+  assert.equal(direct.mismatches, 0, 'Verification outcomes should match the recording');
+  assert.equal(direct.ops.verify.latency.count, 4);
+  assert.equal(direct.cache, null, 'A Falcon instance has no key cache to report');
+  console.log(`  ✓ ${direct.events} operations replayed at 4x, p50 ${direct.latency.p50.toFixed(2)} ms, no mismatches`);
+
+  console.log('- Testing replay against a pool...');
+  const pool = new FalconPool({ size: 2 });
+  try {
+    const report = await replayer.replay(pool, { speed: Infinity, concurrency: 4 });
+    assert.equal(report.errors, 0, 'Replayed operations should succeed on a pool');
+    assert.equal(report.mismatches, 0, 'Pool results should match the recording');
+    assert.equal(report.ops.verifyBatch.latency.count, 1, 'The batch should be replayed through verifyStream');
+    assert(report.cache.hits + report.cache.misses > 0, 'Pool key cache activity should be reported');
+    console.log(`  ✓ ${report.throughput.toFixed(0)} ops/s, key cache hit rate ${(report.cache.hitRate * 100).toFixed(0)}%`);
+  } finally {
+    await pool.close();
+  }
+
+  // A cluster has neither verifyBatch nor verifyStream: items are verified one by one
+  console.log('- Testing replay against a cluster...');
+  const cluster = new FalconCluster({ shards: 2 });
+  try {
+    const report = await replayer.replay(cluster, { speed: Infinity, concurrency: 4 });
+    assert.equal(report.errors, 0, 'Replayed operations should succeed on a cluster');
+    assert.equal(report.mismatches, 0, 'Cluster results should match the recording');
+    console.log(`  ✓ ${report.events} operations replayed over ${cluster.size} shards, no mismatches`);
+  } finally {
+    await cluster.close();
+  }
+
+  console.log('✅ All trace replay tests passed!');
+}
+
+runTests().catch((error) => {
+  console.error('❌ Test failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,361 @@
+/**
+ * Falcon Signatures - Trace replay
+ *
+ * Replays a trace recorded with Falcon.startTrace() against any backend with
+ * the Falcon operation API: a Falcon instance, a FalconPool or a
+ * FalconCluster. The trace holds no keys or messages, so they are
+ * synthesized: one keypair per recorded key fingerprint and one message of
+ * the recorded size per recorded input hash. Key reuse, repeated inputs,
+ * message sizes and verification outcomes therefore match the original
+ * workload.
+ */
+import Falcon from './index.js';
+import { performance } from 'perf_hooks';
+
+/**
+ * Latency summary of millisecond samples
+ * @param {Array<number>} samples - Samples in milliseconds
+ * @returns {Object} { count, mean, p50, p95, p99, max }
+ */
+function summarize(samples) {
+  if (samples.length === 0) return { count: 0, mean: 0, p50: 0, p95: 0, p99: 0, max: 0 };
+  const sorted = Float64Array.from(samples).sort();
+  const at = (p) => sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+  return {
+    count: sorted.length,
+    mean: sorted.reduce((a, b) => a + b, 0) / sorted.length,
+    p50: at(0.5),
+    p95: at(0.95),
+    p99: at(0.99),
+    max: sorted[sorted.length - 1],
+  };
+}
+
+/**
+ * Deterministic message bytes for an input (xorshift32 stream)
+ * @param {number} index - Input number, also written to the first bytes
+ * @param {number} length - Message length
+ * @returns {Uint8Array} Message
+ */
+function synthesizeMessage(index, length) {
+  const message = new Uint8Array(length);
+  let x = (index + 1) * 0x9e3779b1 | 0 || 1;
+  for (let i = 0; i < length; i++) {
+    x ^= x << 13;
+    x ^= x >>> 17;
+    x ^= x << 5;
+    message[i] = x & 0xff;
+  }
+  for (let i = 0; i < Math.min(4, length); i++) message[i] = (index >>> (8 * i)) & 0xff;
+  return message;
+}
+
+/**
+ * Sum the key cache counters found anywhere in backend statistics
+ * (FalconPool workers, or the pools of FalconCluster shards)
+ * @param {*} stats - Result of backend.stats()
+ * @returns {Object} { hits, misses }
+ */
+function cacheCounters(stats) {
+  const totals = { hits: 0, misses: 0 };
+  const walk = (value, name) => {
+    if (!value || typeof value !== 'object') return;
+    if (name === 'cache' && typeof value.hits === 'number') {
+      totals.hits += value.hits;
+      totals.misses += value.misses;
+      return;
+    }
+    for (const [key, child] of Object.entries(value)) walk(child, key);
+  };
+  walk(stats, null);
+  return totals;
+}
+
+/**
+ * Run a recorded operation on a backend. A verifyBatch event goes to
+ * verifyStream on backends without verifyBatch (FalconPool), or is verified
+ * item by item (FalconCluster).
+ * @param {Object} backend - Falcon, FalconPool, FalconCluster or anything with their operations
+ * @param {string} op - Recorded operation
+ * @param {Array} args - Synthesized arguments
+ * @returns {Promise<*>} Operation result
+ */
+async function runOperation(backend, op, args) {
+  if (op !== 'verifyBatch' || typeof backend.verifyBatch === 'function') return backend[op](...args);
+  const [items, { constantTime }] = args;
+  if (typeof backend.verifyStream === 'function') {
+    const results = new Array(items.length);
+    for await (const { index, ok, error } of backend.verifyStream(items, { constantTime })) {
+      results[index] = error ? { ok, error } : { ok };
+    }
+    return results;
+  }
+  const verify = constantTime ? 'verifyConstantTime' : 'verify';
+  return Promise.all(items.map(async ({ message, signature, publicKey }) => {
+    try {
+      return { ok: await backend[verify](message, signature, publicKey) };
+    } catch (error) {
+      return { ok: false, error: error.message };
+    }
+  }));
+}
+
+/**
+ * TraceReplayer - Replays a recorded trace with synthesized inputs
+ *
+ * prepare() generates the keys, messages and signatures once (this is where
+ * most of the setup time goes: one keygen per distinct key); replay() can
+ * then be run against several backends or configurations to compare them
+ * on the same workload.
+ */
+export class TraceReplayer {
+  /**
+   * Create a new replayer
+   * @param {Object} trace - Trace from Falcon.stopTrace() (or its JSON)
+   * @param {Object} options - Replayer options
+   * @param {Falcon} options.falcon - Instance used to synthesize inputs (default: a new quiet instance)
+   */
+  constructor(trace, { falcon = null } = {}) {
+    if (trace?.version !== 1 || !Array.isArray(trace.events)) throw new Error('Not a Falcon trace (version 1)');
+    this.trace = trace;
+    this.falcon = falcon ?? new Falcon({ print: () => {}, printErr: () => {} });
+    this._prepared = null;
+  }
+
+  /**
+   * Key and input reuse in the trace (failed operations aside), which
+   * bounds what key and result caches can achieve
+   * @returns {Object} Operations, distinct keys and inputs, key reuse and input repeat rates
+   */
+  profile() {
+    const keys = new Set();
+    const inputs = new Set();
+    let keyed = 0;
+    let keyReuses = 0;
+    let repeats = 0;
+    let operations = 0;
+    for (const event of this.trace.events) {
+      if (event.error) continue;
+      for (const item of event.items ?? [event]) {
+        operations++;
+        if (item.key) {
+          keyed++;
+          if (keys.has(item.key)) keyReuses++;
+          else keys.add(item.key);
+        }
+        if (item.input) {
+          if (inputs.has(item.input)) repeats++;
+          else inputs.add(item.input);
+        }
+      }
+    }
+    return {
+      operations,
+      distinctKeys: keys.size,
+      distinctInputs: inputs.size,
+      keyReuseRate: keyed === 0 ? 0 : keyReuses / keyed,
+      inputRepeatRate: operations === 0 ? 0 : repeats / operations,
+    };
+  }
+
+  /**
+   * Synthesize the keys, messages and signatures of every event
+   * @returns {Promise<Object>} { events, keys, inputs, skipped, ms }
+   */
+  async prepare() {
+    if (this._prepared) return this._prepared;
+    const start = performance.now();
+    const keypairs = new Map();
+    const inputs = new Map();
+
+    const keypairFor = async (fingerprint) => {
+      let keypair = keypairs.get(fingerprint);
+      if (!keypair) {
+        keypair = await this.falcon.keypair();
+        keypairs.set(fingerprint, keypair);
+      }
+      return keypair;
+    };
+    const messageFor = (item) => {
+      let input = inputs.get(item.input);
+      if (!input) {
+        input = { message: synthesizeMessage(inputs.size, item.messageBytes ?? 32) };
+        inputs.set(item.input, input);
+      }
+      return input;
+    };
+    // Signature for a verification, corrupted if the recorded one failed
+    const signatureFor = async (item, constantTime) => {
+      const input = messageFor(item);
+      if (!input.signature) {
+        let signature = await this.falcon.sign(input.message, (await keypairFor(item.key)).secretKey);
+        if (constantTime) signature = await this.falcon.convertToConstantTime(signature);
+        if (item.ok === false) {
+          signature = signature.slice();
+          signature[signature.length >> 1] ^= 0x01;
+        }
+        input.signature = signature;
+      }
+      return input;
+    };
+    const verifyArgs = async (item, constantTime) => {
+      const { message, signature } = await signatureFor(item, constantTime);
+      return { message, signature, publicKey: (await keypairFor(item.key)).publicKey };
+    };
+
+    const events = [];
+    let skipped = 0;
+    for (const event of this.trace.events) {
+      // Failed operations (malformed keys or signatures) are not synthesized
+      if (event.error) {
+        skipped++;
+        continue;
+      }
+      let args;
+      let expect;
+      switch (event.op) {
+        case 'keypair':
+          args = [];
+          break;
+        case 'sign':
+          args = [messageFor(event).message, (await keypairFor(event.key)).secretKey];
+          break;
+        case 'verify':
+        case 'verifyConstantTime': {
+          const { message, signature, publicKey } = await verifyArgs(event, event.op === 'verifyConstantTime');
+          args = [message, signature, publicKey];
+          expect = event.ok;
+          break;
+        }
+        case 'verifyBatch': {
+          const items = [];
+          for (const item of event.items) items.push(await verifyArgs(item, event.constantTime));
+          args = [items, { constantTime: event.constantTime }];
+          expect = event.items.map((item) => item.ok);
+          break;
+        }
+        case 'convertToConstantTime':
+          args = [(await signatureFor({ ...event, key: 'convert', ok: true }, false)).signature];
+          break;
+        default:
+          skipped++;
+          continue;
+      }
+      events.push({ t: event.t, op: event.op, args, expect, recordedMs: event.ms });
+    }
+
+    this._prepared = { events, keys: keypairs.size, inputs: inputs.size, skipped, ms: performance.now() - start };
+    return this._prepared;
+  }
+
+  /**
+   * Replay the trace against a backend
+   *
+   * At a finite speed, operations are issued at their recorded arrival
+   * times (divided by speed) without waiting for earlier ones, and latency
+   * is measured from the scheduled time, so queueing behind a slow backend
+   * counts. At speed Infinity, operations are issued back to back with up to
+   * `concurrency` in flight.
+   * @param {Object} backend - Falcon, FalconPool, FalconCluster or anything with their operations
+   * @param {Object} options - Replay options
+   * @param {number} options.speed - Time scale: 1 is the recorded pace, 2 twice as fast (default: 1)
+   * @param {number} options.concurrency - Operations in flight at speed Infinity (default: 16)
+   * @returns {Promise<Object>} Latency per operation next to the recorded latency, schedule lag,
+   *   throughput, result mismatches, and key cache hits when the backend reports them
+   */
+  async replay(backend, { speed = 1, concurrency = 16 } = {}) {
+    if (!(speed > 0)) throw new Error('Replay speed must be positive');
+    const { events, skipped } = await this.prepare();
+    const statsBefore = typeof backend.stats === 'function' ? cacheCounters(await backend.stats()) : null;
+
+    const latency = new Map();
+    const recorded = new Map();
+    const lag = [];
+    let mismatches = 0;
+    let errors = 0;
+    const paced = Number.isFinite(speed);
+    const start = performance.now();
+
+    const run = async (event, scheduled) => {
+      lag.push(performance.now() - scheduled);
+      try {
+        const result = await runOperation(backend, event.op, event.args);
+        if (event.op === 'verifyBatch') {
+          if (result.some((r, i) => event.expect[i] !== undefined && r.ok !== event.expect[i])) mismatches++;
+        } else if (event.expect !== undefined && result !== event.expect) {
+          mismatches++;
+        }
+      } catch {
+        errors++;
+      }
+      if (!latency.has(event.op)) {
+        latency.set(event.op, []);
+        recorded.set(event.op, []);
+      }
+      latency.get(event.op).push(performance.now() - scheduled);
+      recorded.get(event.op).push(event.recordedMs);
+    };
+
+    if (paced) {
+      const origin = events.length > 0 ? events[0].t : 0;
+      const running = [];
+      for (const event of events) {
+        const scheduled = start + (event.t - origin) / speed;
+        const wait = scheduled - performance.now();
+        if (wait > 1) await new Promise((resolve) => setTimeout(resolve, wait));
+        running.push(run(event, scheduled));
+      }
+      await Promise.all(running);
+    } else {
+      let next = 0;
+      const lane = async () => {
+        while (next < events.length) {
+          const event = events[next++];
+          await run(event, performance.now());
+        }
+      };
+      await Promise.all(Array.from({ length: Math.max(1, concurrency) }, lane));
+    }
+
+    const wallMs = performance.now() - start;
+    let cache = null;
+    if (statsBefore) {
+      const after = cacheCounters(await backend.stats());
+      const hits = after.hits - statsBefore.hits;
+      const misses = after.misses - statsBefore.misses;
+      cache = { hits, misses, hitRate: hits + misses === 0 ? 0 : hits / (hits + misses) };
+    }
+
+    const ops = {};
+    for (const [op, samples] of latency) {
+      ops[op] = { latency: summarize(samples), recorded: summarize(recorded.get(op)) };
+    }
+    return {
+      events: events.length,
+      skipped,
+      speed,
+      wallMs,
+      throughput: events.length / (wallMs / 1000),
+      errors,
+      mismatches,
+      latency: summarize(Array.from(latency.values()).flat()),
+      lag: summarize(lag),
+      ops,
+      cache,
+      profile: this.profile(),
+    };
+  }
+}
+
+/**
+ * Replay a trace once against a backend
+ * @param {Object} trace - Trace from Falcon.stopTrace()
+ * @param {Object} backend - Falcon, FalconPool or FalconCluster
+ * @param {Object} options - Replay options (see TraceReplayer.replay), plus `falcon` for synthesis
+ * @returns {Promise<Object>} Replay report
+ */
+export async function replayTrace(trace, backend, { falcon, ...options } = {}) {
+  return new TraceReplayer(trace, { falcon }).replay(backend, options);
+}
+
+export default TraceReplayer;
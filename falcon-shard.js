@@ -0,0 +1,58 @@
+/**
+ * Falcon Signatures - Child process entry point for FalconCluster
+ *
+ * Each shard process runs its own FalconPool, so the keys it is routed by the
+ * cluster are cached in its worker threads only. Requests arrive over the IPC
+ * channel and are answered in completion order.
+ */
+import { FalconPool } from './falcon-pool.js';
+
+const options = JSON.parse(process.argv[2] || '{}');
+const pool = new FalconPool({
+  size: options.threads,
+  keyCacheSize: options.keyCacheSize,
+  treeLevels: options.treeLevels,
+  keyCacheAdmission: options.keyCacheAdmission,
+  midstateCacheSize: options.midstateCacheSize,
+  memoryBudget: options.memoryBudget,
+});
+
+/**
+ * Execute one cluster request
+ * @param {Object} request - { op, args }
+ * @returns {Promise<*>} Operation result
+ */
+async function execute({ op, args }) {
+  switch (op) {
+    case 'keypair':
+      return pool.keypair();
+    case 'sign':
+      return pool.sign(args.message, args.secretKey);
+    case 'verify':
+      return pool.verify(args.message, args.signature, args.publicKey);
+    case 'verifyConstantTime':
+      return pool.verifyConstantTime(args.message, args.signature, args.publicKey);
+    case 'convertToConstantTime':
+      return pool.convertToConstantTime(args.signature);
+    case 'stats': {
+      const { rss, heapUsed, external } = process.memoryUsage();
+      return { pool: await pool.stats(), memory: { rss, heapUsed, external } };
+    }
+    default:
+      throw new Error(`Unknown cluster operation: ${op}`);
+  }
+}
+
+process.on('message', async (request) => {
+  try {
+    const result = await execute(request);
+    process.send({ id: request.id, result });
+  } catch (error) {
+    process.send({ id: request.id, error: error.message });
+  }
+});
+
+// The cluster disconnects a shard once its requests have drained
+process.on('disconnect', () => {
+  pool.close().finally(() => process.exit(0));
+});
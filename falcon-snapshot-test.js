@@ -0,0 +1,71 @@
+#!/usr/bin/env node
+import Falcon from './index.js';
+import { createSnapshot } from './falcon-snapshot.js';
+import { strict as assert } from 'assert';
+import { copyFileSync, mkdtempSync, rmSync, writeFileSync } from 'fs';
+import { tmpdir } from 'os';
+import path from 'path';
+import { pathToFileURL } from 'url';
+
+const QUIET = { print: () => {}, printErr: () => {} };
+
+/**
+ * Test the pre-initialized snapshot build step
+ */
+async function runTests() {
+  console.log('🧪 Testing falcon-snapshot.js...');
+  const dir = mkdtempSync(path.join(tmpdir(), 'falcon-snapshot-'));
+
+  try {
+    console.log('- Creating snapshot...');
+    const snapshot = await createSnapshot();
+    assert(WebAssembly.validate(snapshot), 'Snapshot should be a valid WebAssembly module');
+    copyFileSync(new URL('./falcon.js', import.meta.url), path.join(dir, 'falcon.js'));
+    writeFileSync(path.join(dir, 'falcon.wasm'), snapshot);
+    console.log(`  ✓ Snapshot written (${snapshot.length} bytes)`);
+
+    console.log('- Signing with a snapshot instance...');
+    const falcon = new Falcon(QUIET);
+    const { publicKey, secretKey } = await falcon.keypair();
+    const message = new TextEncoder().encode('Snapshot test message');
+    const expected = await falcon.sign(message, secretKey);
+
+    const { default: factory } = await import(pathToFileURL(path.join(dir, 'falcon.js')).href);
+    const module = await factory(QUIET);
+    const maxSig = module._get_sig_compressed_max_size();
+    const skPtr = module._malloc(secretKey.length);
+    const pkPtr = module._malloc(publicKey.length);
+    const msgPtr = module._malloc(message.length);
+    const sigPtr = module._malloc(maxSig);
+    const sigLenPtr = module._malloc(4);
+    module.HEAPU8.set(secretKey, skPtr);
+    module.HEAPU8.set(message, msgPtr);
+    module.setValue(sigLenPtr, maxSig, 'i32');
+
+    assert.equal(module._falcon_det1024_sign_compressed_wrapper(sigPtr, sigLenPtr, skPtr, msgPtr, message.length), 0,
+      'Snapshot instance should sign');
+    const sigLen = module.getValue(sigLenPtr, 'i32');
+    const signature = module.HEAPU8.slice(sigPtr, sigPtr + sigLen);
+    assert.deepEqual(signature, expected, 'Snapshot signature should match the original module');
+    assert.equal(await falcon.verify(message, signature, publicKey), true, 'Snapshot signature should verify');
+    console.log('  ✓ Deterministic signature matches the original module');
+
+    // The RNG is set up on first use, not taken from the snapshot
+    console.log('- Generating a keypair with a snapshot instance...');
+    assert.equal(module._falcon_det1024_keygen_wrapper(skPtr, pkPtr), 0, 'Snapshot instance should generate keys');
+    const snapshotSk = module.HEAPU8.slice(skPtr, skPtr + secretKey.length);
+    const snapshotPk = module.HEAPU8.slice(pkPtr, pkPtr + publicKey.length);
+    const check = await falcon.sign(message, snapshotSk);
+    assert.equal(await falcon.verify(message, check, snapshotPk), true, 'Snapshot keypair should be usable');
+    console.log('  ✓ Keypair generated after snapshot is valid');
+  } finally {
+    rmSync(dir, { recursive: true, force: true });
+  }
+
+  console.log('✅ All snapshot tests passed!');
+}
+
+runTests().catch((error) => {
+  console.error('❌ Test failed:', error);
+  process.exit(1);
+});
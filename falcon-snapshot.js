@@ -0,0 +1,278 @@
+#!/usr/bin/env node
+/**
+ * Falcon Signatures - Pre-initialized WebAssembly snapshot (build step)
+ *
+ * Instantiates falcon.wasm, lets the Emscripten runtime run its constructors,
+ * then writes a new binary whose data section is the initialized linear
+ * memory and whose constructor function is empty, in the style of Wizer.
+ * Instances of the snapshot start in the post-initialization state.
+ *
+ * Only wasm-side state is captured. libsodium's RNG setup is left to the
+ * first keygen because it also installs JavaScript-side state
+ * (Module.getRandomValue) that a memory snapshot cannot carry; builds with
+ * --host-rng have no such setup.
+ *
+ * Usage: node falcon-snapshot.js [--module falcon.js] [--out falcon.snapshot.wasm]
+ */
+import { readFileSync, writeFileSync } from 'fs';
+import path from 'path';
+import { fileURLToPath, pathToFileURL } from 'url';
+
+const SECTION_MEMORY = 5;
+const SECTION_EXPORT = 7;
+const SECTION_CODE = 10;
+const SECTION_DATA = 11;
+const SECTION_DATA_COUNT = 12;
+const SECTION_IMPORT = 2;
+
+// Zero runs shorter than this stay inside a data segment (a segment header
+// costs about as much)
+const MIN_ZERO_GAP = 16;
+
+/**
+ * Minimal reader for the parts of the binary format the rewrite needs
+ * @private
+ */
+class Reader {
+  constructor(bytes, offset = 0) {
+    this.bytes = bytes;
+    this.offset = offset;
+  }
+
+  byte() {
+    return this.bytes[this.offset++];
+  }
+
+  u32() {
+    let result = 0;
+    let shift = 0;
+    let b;
+    do {
+      b = this.bytes[this.offset++];
+      result |= (b & 0x7f) << shift;
+      shift += 7;
+    } while (b & 0x80);
+    return result >>> 0;
+  }
+
+  name() {
+    const length = this.u32();
+    const name = Buffer.from(this.bytes.subarray(this.offset, this.offset + length)).toString('utf8');
+    this.offset += length;
+    return name;
+  }
+
+  limits() {
+    const flags = this.byte();
+    const min = this.u32();
+    const max = flags & 1 ? this.u32() : undefined;
+    return { flags, min, max };
+  }
+}
+
+function encodeU32(value) {
+  const out = [];
+  do {
+    let b = value & 0x7f;
+    value >>>= 7;
+    if (value !== 0) b |= 0x80;
+    out.push(b);
+  } while (value !== 0);
+  return out;
+}
+
+function encodeI32(value) {
+  const out = [];
+  for (;;) {
+    const b = value & 0x7f;
+    value >>= 7;
+    if ((value === 0 && (b & 0x40) === 0) || (value === -1 && (b & 0x40) !== 0)) {
+      out.push(b);
+      return out;
+    }
+    out.push(b | 0x80);
+  }
+}
+
+function section(id, payload) {
+  return Buffer.concat([Buffer.from([id, ...encodeU32(payload.length)]), payload]);
+}
+
+/**
+ * Split the binary into its sections
+ * @private
+ */
+function readSections(bytes) {
+  const magic = Buffer.from(bytes.subarray(0, 8));
+  const sections = [];
+  const reader = new Reader(bytes, 8);
+  while (reader.offset < bytes.length) {
+    const id = reader.byte();
+    const size = reader.u32();
+    sections.push({ id, payload: Buffer.from(bytes.subarray(reader.offset, reader.offset + size)) });
+    reader.offset += size;
+  }
+  return { magic, sections };
+}
+
+/**
+ * Active data segments covering the non-zero ranges of a memory image
+ * @private
+ */
+function dataSegments(memory) {
+  const segments = [];
+  let i = 0;
+  while (i < memory.length) {
+    while (i < memory.length && memory[i] === 0) i++;
+    if (i >= memory.length) break;
+    const start = i;
+    let end = i;
+    while (i < memory.length) {
+      if (memory[i] !== 0) {
+        end = ++i;
+        continue;
+      }
+      const gapStart = i;
+      while (i < memory.length && memory[i] === 0 && i - gapStart < MIN_ZERO_GAP) i++;
+      if (i - gapStart >= MIN_ZERO_GAP || i >= memory.length) break;
+    }
+    segments.push({ offset: start, bytes: memory.subarray(start, end) });
+  }
+  return segments;
+}
+
+/**
+ * Rewrite a module so that it starts with the given memory image and an
+ * empty constructor function
+ * @param {Uint8Array} wasm - Original binary
+ * @param {Uint8Array} memory - Linear memory captured after initialization
+ * @param {string} ctorsExport - Export name of the constructor function
+ * @returns {Buffer} Snapshot binary
+ */
+export function rewriteWasm(wasm, memory, ctorsExport) {
+  const { magic, sections } = readSections(wasm);
+
+  // Function index of the constructors (imports come first in the index space)
+  let importedFunctions = 0;
+  let ctorsIndex = -1;
+  for (const { id, payload } of sections) {
+    const reader = new Reader(payload);
+    if (id === SECTION_IMPORT) {
+      for (let n = reader.u32(); n > 0; n--) {
+        reader.name();
+        reader.name();
+        const kind = reader.byte();
+        if (kind === 0) {
+          reader.u32();
+          importedFunctions++;
+        } else if (kind === 1) {
+          reader.byte();
+          reader.limits();
+        } else if (kind === 2) {
+          reader.limits();
+        } else if (kind === 3) {
+          reader.byte();
+          reader.byte();
+        }
+      }
+    } else if (id === SECTION_EXPORT) {
+      for (let n = reader.u32(); n > 0; n--) {
+        const name = reader.name();
+        const kind = reader.byte();
+        const index = reader.u32();
+        if (kind === 0 && name === ctorsExport) ctorsIndex = index;
+      }
+    }
+  }
+  if (ctorsIndex < importedFunctions) {
+    throw new Error(`Constructor export "${ctorsExport}" not found`);
+  }
+
+  const segments = dataSegments(memory);
+  const pages = Math.ceil(memory.length / 65536);
+  const out = [magic];
+
+  for (const { id, payload } of sections) {
+    if (id === SECTION_MEMORY) {
+      const reader = new Reader(payload);
+      reader.u32();
+      const { flags, min, max } = reader.limits();
+      const limits = [flags, ...encodeU32(Math.max(min, pages))];
+      if (max !== undefined) limits.push(...encodeU32(max));
+      out.push(section(id, Buffer.from([1, ...limits])));
+    } else if (id === SECTION_CODE) {
+      // Replace the constructor body with an empty one (no locals, `end`)
+      const reader = new Reader(payload);
+      const count = reader.u32();
+      const bodies = [Buffer.from(encodeU32(count))];
+      for (let i = 0; i < count; i++) {
+        const start = reader.offset;
+        const size = reader.u32();
+        reader.offset += size;
+        bodies.push(i === ctorsIndex - importedFunctions
+          ? Buffer.from([2, 0x00, 0x0b])
+          : Buffer.from(payload.subarray(start, reader.offset)));
+      }
+      out.push(section(id, Buffer.concat(bodies)));
+    } else if (id === SECTION_DATA) {
+      const parts = [Buffer.from(encodeU32(segments.length))];
+      for (const { offset, bytes } of segments) {
+        parts.push(Buffer.from([0, 0x41, ...encodeI32(offset), 0x0b, ...encodeU32(bytes.length)]), Buffer.from(bytes));
+      }
+      out.push(section(id, Buffer.concat(parts)));
+    } else if (id === SECTION_DATA_COUNT) {
+      out.push(section(id, Buffer.from(encodeU32(segments.length))));
+    } else {
+      out.push(section(id, payload));
+    }
+  }
+
+  return Buffer.concat(out);
+}
+
+/**
+ * Name of the export that Emscripten's initRuntime() calls
+ * @private
+ */
+function findCtorsExport(glue) {
+  const match = glue.match(/function initRuntime\(\)\{[^}]*wasmExports\["([^"]+)"\]\(\)/);
+  return match ? match[1] : '__wasm_call_ctors';
+}
+
+/**
+ * Build a snapshot of an Emscripten Falcon build
+ * @param {Object} options - Snapshot options
+ * @param {string} options.module - Path to the Emscripten glue (default: ./falcon.js next to this file)
+ * @returns {Promise<Buffer>} Snapshot binary for the module's falcon.wasm
+ */
+export async function createSnapshot({ module = fileURLToPath(new URL('./falcon.js', import.meta.url)) } = {}) {
+  const jsPath = path.resolve(module);
+  const wasmPath = jsPath.replace(/\.js$/, '.wasm');
+  const { default: factory } = await import(pathToFileURL(jsPath).href);
+
+  const instance = await factory({ print: () => {}, printErr: () => {} });
+  const memory = instance.HEAPU8.slice();
+  return rewriteWasm(readFileSync(wasmPath), memory, findCtorsExport(readFileSync(jsPath, 'utf8')));
+}
+
+async function main() {
+  const args = process.argv.slice(2);
+  let module;
+  let out = 'falcon.snapshot.wasm';
+  for (let i = 0; i < args.length; i++) {
+    if (args[i] === '--module') module = args[++i];
+    else if (args[i] === '--out') out = args[++i];
+    else throw new Error(`Unknown option: ${args[i]}`);
+  }
+
+  const snapshot = await createSnapshot({ module });
+  writeFileSync(out, snapshot);
+  console.log(`📸 Wrote ${out} (${snapshot.length} bytes)`);
+}
+
+if (process.argv[1] && path.resolve(process.argv[1]) === fileURLToPath(import.meta.url)) {
+  main().catch((error) => {
+    console.error('❌ Snapshot failed:', error);
+    process.exit(1);
+  });
+}
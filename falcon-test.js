@@ -1,6 +1,11 @@
 #!/usr/bin/env node
 import Falcon from './index.js';
+import { MidstateCache } from './falcon-cache.js';
 import { strict as assert } from 'assert';
+import { randomBytes } from 'crypto';
+import { mkdtempSync, rmSync, writeFileSync } from 'fs';
+import { tmpdir } from 'os';
+import path from 'path';
 
 // Constants for deterministic Falcon-1024
 const EXPECTED_PK_SIZE = 1793;  // Size of public key in bytes
@@ -8,6 +13,10 @@ const EXPECTED_SK_SIZE = 2305;  // Size of secret key in bytes
 // The compressed signature size can vary, but has a maximum
 // The CT signature size is fixed
 
+// Set by build_falcon_wasm.sh: fail instead of skipping or emulating the
+// exports a fresh build must have
+const requireExports = process.env.FALCON_REQUIRE_EXPORTS === '1';
+
 /**
  * Test the Falcon class implementation
  */
@@ -97,6 +106,13 @@ async function runTests() {
   const ctInvalidResult = await falcon.verifyConstantTime(tampered, ctSignature, publicKey);
   console.log(`  ✓ Invalid CT verification result: ${ctInvalidResult ? 'Valid' : 'Invalid'}`);
   assert(ctInvalidResult === false, 'Tampered CT signature should be invalid');
+
+  // Signatures longer than the maximum are rejected without being decoded
+  const oversized = new Uint8Array(signature.length + 4096);
+  oversized.set(signature);
+  const oversizedResult = await falcon.verify(message, oversized, publicKey);
+  console.log(`  ✓ Oversized signature verification result: ${oversizedResult ? 'Valid' : 'Invalid'}`);
+  assert(oversizedResult === false, 'Oversized signature should be invalid');
   
   // Test hex conversion utilities
   console.log('- Testing hex conversion utilities...');
@@ -131,6 +147,245 @@ async function runTests() {
   assert(sig1Hex === sig2Hex, 'Signatures should be deterministic for the same message and key');
   console.log('  ✓ Deterministic signatures confirmed');
   
+  // Loaded and expanded keys must sign exactly like the raw key bytes
+  console.log('- Testing loaded keys with cached LDL-tree levels...');
+  for (const treeLevels of [null, 0, 1, 5, 10]) {
+    const loaded = await falcon.loadKey(secretKey, 'secret', { treeLevels });
+    const loadedSig = await falcon.sign(message, loaded);
+    assert(Falcon.bytesToHex(loadedSig) === sig1Hex, `Signature with treeLevels ${treeLevels} should match`);
+    falcon.releaseKey(loaded);
+  }
+  const treeSupport = await falcon.supportsTreeLevels();
+  assert(treeSupport || !requireExports, 'This build has no partial-tree exports');
+  if (treeSupport) {
+    await assert.rejects(falcon.loadKey(secretKey, 'secret', { treeLevels: 11 }), /Invalid treeLevels/);
+  }
+  console.log(`  ✓ Loaded keys sign identically${treeSupport ? '' : ' (this build has no partial-tree support)'}`);
+  
+  // Streaming verification yields every result in order, pulling items lazily
+  console.log('- Testing batch and streaming verification...');
+  const streamItems = Array.from({ length: 150 }, (_, i) => ({
+    message: i % 7 === 3 ? tampered : message,
+    signature: i % 2 ? Falcon.bytesToHex(signature) : signature,
+    publicKey: i === 42 ? new Uint8Array(10) : publicKey,
+  }));
+  let pulled = 0;
+  let maxAhead = 0;
+  let consumed = 0;
+  async function* produce() {
+    for (const item of streamItems) {
+      pulled++;
+      maxAhead = Math.max(maxAhead, pulled - consumed);
+      yield item;
+    }
+  }
+  for await (const { index, ok, error } of falcon.verifyStream(produce(), { batchSize: 16 })) {
+    assert(index === consumed, 'Stream results should arrive in source order');
+    if (index === 42) assert(!ok && /Invalid public key length/.test(error), 'Malformed item should carry its error');
+    else assert(ok === (index % 7 !== 3), `Stream result ${index} should match verify()`);
+    consumed++;
+  }
+  assert(consumed === streamItems.length, 'Every item should yield a result');
+  assert(maxAhead <= 16, `Producer should stay within one batch of the consumer, got ${maxAhead}`);
+  const ctBatch = await falcon.verifyBatch([
+    { message, signature: ctSignature, publicKey },
+    { message: tampered, signature: ctSignature, publicKey },
+    { message, signature, publicKey },
+  ], { constantTime: true });
+  assert.deepEqual(ctBatch.map((r) => r.ok), [true, false, false], 'CT batch results should match verifyConstantTime()');
+  assert(/Invalid CT signature length/.test(ctBatch[2].error), 'Compressed signature in a CT batch should be reported');
+  console.log(`  ✓ ${consumed} streamed results, producer at most ${maxAhead} items ahead`);
+
+  // Disposal zeroizes and drops the instance; the next call re-warms it
+  console.log('- Testing dispose, idle teardown and re-warm...');
+  const held = await falcon.loadKey(secretKey, 'secret');
+  const heap = falcon._module.HEAPU8;
+  const { reclaimedBytes, releasedKeys } = await falcon.dispose();
+  assert(reclaimedBytes > 0 && reclaimedBytes === heap.byteLength, 'Dispose should report the memory released');
+  assert(releasedKeys >= 1 && held.released, 'Loaded keys should be released on dispose');
+  assert(heap.every((b) => b === 0), 'WebAssembly memory should be zeroized on dispose');
+  assert.equal(falcon.lifecycleStats().state, 'disposed', 'Instance should report disposal');
+  await assert.rejects(falcon.sign(message, held), /Invalid loaded secret key/);
+  assert.deepEqual(await falcon.sign(message, secretKey), signature, 'Re-warmed instance should sign identically');
+  let lifecycle = falcon.lifecycleStats();
+  assert(lifecycle.state === 'ready' && lifecycle.rewarms === 1, 'First use after dispose should re-warm');
+
+  // A failed re-warm rejects the operation; the next one tries again
+  await falcon.dispose();
+  const instantiate = WebAssembly.instantiate;
+  const printError = console.error;
+  WebAssembly.instantiate = () => Promise.reject(new WebAssembly.LinkError('injected failure'));
+  console.error = () => {};
+  try {
+    await assert.rejects(falcon.sign(message, secretKey), /Failed to initialize Falcon module/);
+  } finally {
+    WebAssembly.instantiate = instantiate;
+    console.error = printError;
+  }
+  assert.equal(falcon.lifecycleStats().state, 'disposed', 'A failed re-warm should leave the instance disposed');
+  assert.deepEqual(await falcon.sign(message, secretKey), signature, 'The next operation should re-warm');
+
+  const idle = new Falcon({ idleTimeoutMs: 50 });
+  assert.equal(await idle.verify(message, signature, publicKey), true, 'Idle-managed instance should verify');
+  await new Promise((resolve) => setTimeout(resolve, 150));
+  assert.equal(idle.lifecycleStats().state, 'disposed', 'Idle instance should be disposed');
+  assert.equal(await idle.verify(message, signature, publicKey), true, 'Idle instance should re-warm on use');
+  lifecycle = idle.lifecycleStats();
+  assert(lifecycle.disposals === 1 && lifecycle.rewarms === 1, 'Idle teardown and re-warm should be counted');
+  await idle.dispose();
+  console.log(`  ✓ Reclaimed ${(reclaimedBytes / 1024).toFixed(0)} KB, re-warm in ${lifecycle.lastRewarmMs.toFixed(1)} ms`);
+
+  // Files are read straight into WebAssembly memory and sign like their bytes
+  console.log('- Testing file signing and verification...');
+  const dir = mkdtempSync(path.join(tmpdir(), 'falcon-file-'));
+  try {
+    const file = path.join(dir, 'payload.bin');
+    const payload = randomBytes((3 << 20) + 12345);
+    writeFileSync(file, payload);
+    const fileSignature = await falcon.signFile(file, secretKey, { chunkSize: 1 << 18 });
+    assert.deepEqual(fileSignature, await falcon.sign(payload, secretKey), 'File signature should match sign() of its bytes');
+    assert.equal(await falcon.verifyFile(file, fileSignature, publicKey), true, 'File signature should verify');
+    assert.equal(await falcon.verifyFile(file, signature, publicKey), false, 'Other signature should not verify');
+    const ctFileSignature = await falcon.convertToConstantTime(fileSignature);
+    assert.equal(await falcon.verifyFile(file, ctFileSignature, publicKey, { constantTime: true }), true,
+      'CT file signature should verify');
+    const empty = path.join(dir, 'empty.bin');
+    writeFileSync(empty, new Uint8Array(0));
+    assert.deepEqual(await falcon.signFile(empty, secretKey), await falcon.sign(new Uint8Array(0), secretKey),
+      'Empty file should sign like an empty message');
+    await assert.rejects(falcon.signFile(path.join(dir, 'missing.bin'), secretKey), /ENOENT/);
+
+    const streaming = await falcon.supportsStreaming();
+    assert(streaming || !requireExports, 'This build has no streaming exports');
+    if (!streaming) {
+      const large = path.join(dir, 'large.bin');
+      writeFileSync(large, new Uint8Array(falcon._module.HEAPU8.byteLength + 1));
+      await assert.rejects(falcon.signFile(large, secretKey), /streaming exports/);
+      assert.equal(await falcon.verify(message, signature, publicKey), true, 'Instance should stay usable');
+
+      // Emulate the streaming exports over the one-shot ones, to check the chunked reads
+      const module = falcon._module;
+      const streams = new Map();
+      let updates = 0;
+      const concat = (chunks) => {
+        const length = chunks.reduce((n, c) => n + c.length, 0);
+        const ptr = module._malloc(Math.max(1, length));
+        let offset = ptr;
+        for (const chunk of chunks) {
+          module.HEAPU8.set(chunk, offset);
+          offset += chunk.length;
+        }
+        return { ptr, length };
+      };
+      Object.assign(module, {
+        _falcon_det1024_sign_stream_init: (skPtr) => {
+          streams.set(streams.size + 1, { key: module.HEAPU8.slice(skPtr, skPtr + EXPECTED_SK_SIZE), chunks: [] });
+          return streams.size;
+        },
+        _falcon_det1024_sign_stream_update: (id, ptr, length) => {
+          updates++;
+          streams.get(id).chunks.push(module.HEAPU8.slice(ptr, ptr + length));
+        },
+        _falcon_det1024_sign_stream_finish: (id, sigPtr, sigLenPtr) => {
+          const msg = concat(streams.get(id).chunks);
+          const skPtr = module._malloc(EXPECTED_SK_SIZE);
+          module.HEAPU8.set(streams.get(id).key, skPtr);
+          const res = module._falcon_det1024_sign_compressed_wrapper(sigPtr, sigLenPtr, skPtr, msg.ptr, msg.length);
+          module._free(skPtr);
+          module._free(msg.ptr);
+          return res;
+        },
+        _falcon_det1024_sign_stream_abort: (id) => streams.delete(id),
+      });
+      try {
+        assert.deepEqual(await falcon.signFile(file, secretKey, { chunkSize: 1 << 20 }), fileSignature,
+          'Streamed file signature should match');
+        assert.equal(updates, 4, 'File should be read in chunkSize pieces');
+      } finally {
+        for (const name of Object.keys(module)) {
+          if (name.startsWith('_falcon_det1024_sign_stream_')) delete module[name];
+        }
+      }
+    }
+    console.log(`  ✓ ${(payload.length / 1048576).toFixed(1)} MB file signed and verified (${streaming ? 'streaming exports' : 'whole file in WebAssembly memory'})`);
+  } finally {
+    rmSync(dir, { recursive: true, force: true });
+  }
+
+  // Midstates skip absorbing the secret key; signatures are unchanged
+  console.log('- Testing secret-key midstates...');
+  const midstates = await falcon.supportsMidstates();
+  assert(midstates || !requireExports, 'This build has no midstate exports');
+  const wasm = falcon._module;
+  let midstateSigns = 0;
+  if (!midstates) {
+    // Emulate the midstate exports: the "midstate" copies key bytes, and
+    // signing uses the one-shot wrapper without checking it, as the real
+    // export trusts its caller
+    Object.assign(wasm, {
+      _falcon_det1024_sk_midstate_size: () => 208,
+      _falcon_det1024_sk_midstate_wrapper: (msPtr, skPtr) => {
+        if (wasm.HEAPU8[skPtr] !== 0x5a) return -3;
+        wasm.HEAPU8.copyWithin(msPtr, skPtr + 1, skPtr + 209);
+        return 0;
+      },
+      _falcon_det1024_sign_compressed_midstate_wrapper: (sigPtr, sigLenPtr, skPtr, msPtr, msgPtr, msgLen) => {
+        midstateSigns++;
+        return wasm._falcon_det1024_sign_compressed_wrapper(sigPtr, sigLenPtr, skPtr, msgPtr, msgLen);
+      },
+    });
+  }
+  try {
+    const loadedWithMidstate = await falcon.loadKey(secretKey, 'secret');
+    assert(loadedWithMidstate.midstate !== null, 'A plain loaded secret key should carry its midstate');
+    assert.equal(loadedWithMidstate.byteLength, EXPECTED_SK_SIZE + 208);
+    assert.deepEqual(await falcon.sign(message, loadedWithMidstate), signature, 'Loaded key should sign identically');
+    falcon.releaseKey(loadedWithMidstate);
+
+    const midstate = await falcon.loadMidstate(secretKey);
+    assert.equal(midstate.length, 208, 'A midstate should be 208 bytes');
+    assert.equal(midstate.byteLength, 208, 'A midstate should not hold a copy of its key');
+    assert.equal(midstate.keyDigest.length, 32, 'A midstate should be bound to the digest of its key');
+    assert.deepEqual(await falcon.sign(message, secretKey, { midstate }), signature, 'Midstate should sign identically');
+    assert.deepEqual(await falcon.sign(new Uint8Array(0), Falcon.bytesToHex(secretKey), { midstate }),
+      await falcon.sign(new Uint8Array(0), secretKey), 'Midstate should sign an empty message identically');
+    if (!midstates) assert.equal(midstateSigns, 3, 'Signing should go through the midstate wrapper');
+    await assert.rejects(falcon.loadMidstate(new Uint8Array(EXPECTED_SK_SIZE)), /Midstate computation failed/);
+    await assert.rejects(falcon.sign(message, sk2, { midstate }), /does not belong to this secret key/);
+    const loadedSk = await falcon.loadKey(secretKey, 'secret');
+    await assert.rejects(falcon.sign(message, loadedSk, { midstate }), /secret key bytes/);
+    falcon.releaseKey(loadedSk);
+    if (!midstates) assert.equal(midstateSigns, 3, 'Rejected midstates should not reach the wrapper');
+
+    // The cache sizes itself from WebAssembly memory, and a midstate it
+    // cannot allocate leaves the caller signing without one
+    const cache = new MidstateCache(falcon);
+    assert(await cache.get(secretKey), 'The cache should compute a midstate');
+    assert.equal(cache.capacity, Math.floor(falcon.lifecycleStats().memoryBytes / 16 / (208 + 16)),
+      'The default capacity should be 1/16 of WebAssembly memory');
+    cache.clear();
+    falcon._tryMalloc = () => 0;
+    try {
+      assert.equal(await cache.get(secretKey), null, 'A failed allocation should fall back to plain signing');
+    } finally {
+      delete falcon._tryMalloc;
+    }
+    assert.equal(cache.stats().allocationFailures, 1, 'Allocation failures should be counted');
+    assert.deepEqual(await falcon.sign(message, secretKey), signature, 'Signing should still work after the failure');
+
+    const { ptr } = midstate;
+    falcon.releaseKey(midstate);
+    assert(falcon._module.HEAPU8.subarray(ptr, ptr + 208).every((b) => b === 0), 'Released midstate should be zeroized');
+    await assert.rejects(falcon.sign(message, secretKey, { midstate }), /Invalid midstate/);
+  } finally {
+    if (!midstates) {
+      for (const name of Object.keys(wasm)) {
+        if (name.includes('midstate')) delete wasm[name];
+      }
+    }
+  }
+  console.log(`  ✓ Midstate signatures match (${midstates ? 'midstate exports' : 'emulated exports'})`);
+
   console.log('\n✅ All tests passed!');
 }
 
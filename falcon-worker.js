@@ -0,0 +1,108 @@
+/**
+ * Falcon Signatures - Worker thread entry point for FalconPool
+ *
+ * Each worker owns one Falcon WebAssembly instance, a KeyCache of keys
+ * loaded into its memory and a MidstateCache for the secret keys the key
+ * cache does not hold. With a memory budget, sign and verify results are
+ * also memoized, and keys, midstates and results share the budget. Requests
+ * are processed one at a time, in order.
+ */
+import { parentPort, workerData } from 'worker_threads';
+import Falcon from './index.js';
+import { KeyCache, MemoryBudget, MidstateCache, ResultCache } from './falcon-cache.js';
+
+const falcon = new Falcon();
+const budget = workerData.memoryBudget ? new MemoryBudget(workerData.memoryBudget) : null;
+const keyCache = new KeyCache(falcon, {
+  capacity: workerData.keyCacheSize,
+  treeLevels: workerData.treeLevels,
+  admission: workerData.admission,
+  budget,
+});
+const midstates = new MidstateCache(falcon, { capacity: workerData.midstateCacheSize ?? null, budget });
+const results = budget ? new ResultCache(falcon, { budget }) : null;
+
+/**
+ * Memoize a result when the worker has a memory budget
+ */
+const memo = (op, inputs, compute) => (results ? results.memo(op, inputs, compute) : compute());
+
+/**
+ * Verify a batch with each public key taken from the key cache; items are
+ * verified one key at a time, so a key stays loaded while its items use it
+ * @param {Array<Object>} items - Items of { message, signature, publicKey, fingerprint }
+ * @param {boolean} constantTime - Signatures are in constant-time format
+ * @returns {Promise<Array<Object>>} { ok, error? } per item, in order
+ */
+async function verifyBatch(items, constantTime) {
+  const groups = new Map();
+  items.forEach((item, index) => {
+    const group = groups.get(item.fingerprint);
+    if (group) group.push(index);
+    else groups.set(item.fingerprint, [index]);
+  });
+
+  const results = new Array(items.length);
+  for (const [fingerprint, indices] of groups) {
+    const { publicKey } = items[indices[0]];
+    // A malformed key is left to verifyBatch, which reports it per item
+    const pk = fingerprint !== null
+      ? await keyCache.get(fingerprint, publicKey, 'public').catch(() => publicKey)
+      : null;
+    const batch = await falcon.verifyBatch(
+      indices.map((i) => ({ ...items[i], publicKey: pk ?? items[i].publicKey })), { constantTime });
+    indices.forEach((index, i) => { results[index] = batch[i]; });
+  }
+  return results;
+}
+
+/**
+ * Execute one pool request
+ * @param {Object} request - { op, args }
+ * @returns {Promise<*>} Operation result
+ */
+async function execute({ op, args }) {
+  switch (op) {
+    case 'keypair':
+      return falcon.keypair();
+    case 'sign':
+      return memo('sign', [args.message, args.secretKey], async () => {
+        const sk = await keyCache.get(args.fingerprint, args.secretKey, 'secret');
+        // A key turned away by the key cache still skips absorbing the key
+        const midstate = sk instanceof Uint8Array ? await midstates.get(sk, args.fingerprint) : null;
+        return falcon.sign(args.message, sk, { midstate });
+      });
+    case 'verify':
+      return memo('verify', [args.message, args.signature, args.publicKey], async () => {
+        const pk = await keyCache.get(args.fingerprint, args.publicKey, 'public');
+        return falcon.verify(args.message, args.signature, pk);
+      });
+    case 'verifyConstantTime':
+      return memo('verifyCT', [args.message, args.signature, args.publicKey], async () => {
+        const pk = await keyCache.get(args.fingerprint, args.publicKey, 'public');
+        return falcon.verifyConstantTime(args.message, args.signature, pk);
+      });
+    case 'verifyBatch':
+      return verifyBatch(args.items, args.constantTime);
+    case 'convertToConstantTime':
+      return falcon.convertToConstantTime(args.signature);
+    case 'stats':
+      return { cache: keyCache.stats(), midstates: midstates.stats(), budget: budget?.stats() ?? null };
+    default:
+      throw new Error(`Unknown pool operation: ${op}`);
+  }
+}
+
+// Serialize requests so a cached key is never evicted while in use
+let queue = Promise.resolve();
+
+parentPort.on('message', (request) => {
+  queue = queue.then(async () => {
+    try {
+      const result = await execute(request);
+      parentPort.postMessage({ id: request.id, result });
+    } catch (error) {
+      parentPort.postMessage({ id: request.id, error: error.message });
+    }
+  });
+});
@@ -3,23 +3,58 @@
 #include <stdlib.h>
 #include <string.h>
 #include <emscripten/emscripten.h>
+#ifdef FALCON_HOST_RNG
+#include <sys/random.h> // ✅ host CSPRNG through getentropy()
+#else
 #include <sodium.h> // ✅ libsodium RNG
+#endif
 #include "falcon/falcon.h"
 #include "falcon/deterministic.h"
+#include "falcon/inner.h"
 
 #define SK_SIZE FALCON_DET1024_PRIVKEY_SIZE
 #define PK_SIZE FALCON_DET1024_PUBKEY_SIZE
 #define SIG_COMPRESSED_MAX_SIZE FALCON_DET1024_SIG_COMPRESSED_MAXSIZE
 #define SIG_CT_SIZE FALCON_DET1024_SIG_CT_SIZE
 
-// --- Utility: Secure RNG initialization ---
+#ifdef FALCON_HOST_RNG
+
+// --- Secure seed generation using the host CSPRNG ---
+// Emscripten implements getentropy() as an import backed by
+// crypto.getRandomValues (browsers) or crypto.randomFillSync (Node.js), so
+// there is no library state to initialize. Seeds are at most 256 bytes.
+static void secure_random_seed(uint8_t *seed, size_t seed_len)
+{
+    if (getentropy(seed, seed_len) != 0)
+    {
+        fprintf(stderr, "[falcon_wrapper] host RNG unavailable!\n");
+        abort();
+    }
+}
+
+// --- Zeroization the compiler cannot remove ---
+static void secure_zero(void *buf, size_t len)
+{
+    volatile uint8_t *p = (volatile uint8_t *)buf;
+    while (len--)
+        *p++ = 0;
+}
+
+#else
+
+// --- Utility: Secure RNG initialization (once per module) ---
+static int sodium_ready = 0;
+
 static void ensure_sodium_initialized()
 {
+    if (sodium_ready)
+        return;
     if (sodium_init() < 0)
     {
         fprintf(stderr, "[falcon_wrapper] libsodium initialization failed!\n");
         abort();
     }
+    sodium_ready = 1;
 }
 
 // --- Secure seed generation using libsodium ---
@@ -29,6 +64,814 @@ static void secure_random_seed(uint8_t *seed, size_t seed_len)
     randombytes_buf(seed, seed_len);
 }
 
+static void secure_zero(void *buf, size_t len)
+{
+    sodium_memzero(buf, len);
+}
+
+#endif
+
+// --- Two-lane SHAKE256 absorb ---
+// Signing absorbs the message into two SHAKE256 states: detrng (after
+// logn || sk) and hd (after the salt). The two states sit at different
+// offsets within their 136-byte blocks, so each lane XORs its own window of
+// the message and both Keccak-f[1600] permutations then run together. The
+// windows overlap, so each message block is read from memory once. With wasm
+// SIMD (-msimd128) or SSE2 the two states share 128-bit registers, one 64-bit
+// lane each; otherwise the two permutations are interleaved in scalar code.
+//
+// shake256_context mirrors Falcon's inner_shake256_context: 25 state words in
+// the standard Keccak representation, then the offset in the current block.
+
+#define SHAKE256_RATE 136
+
+_Static_assert(sizeof(shake256_context) == 26 * sizeof(uint64_t),
+               "unexpected shake256_context layout");
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+typedef v128_t keccak_x2;
+static inline keccak_x2 kx2_load(uint64_t a, uint64_t b) { return wasm_i64x2_make((int64_t)a, (int64_t)b); }
+static inline void kx2_store(keccak_x2 v, uint64_t *a, uint64_t *b)
+{
+    *a = (uint64_t)wasm_i64x2_extract_lane(v, 0);
+    *b = (uint64_t)wasm_i64x2_extract_lane(v, 1);
+}
+static inline keccak_x2 kx2_xor(keccak_x2 x, keccak_x2 y) { return wasm_v128_xor(x, y); }
+static inline keccak_x2 kx2_andn(keccak_x2 x, keccak_x2 y) { return wasm_v128_andnot(y, x); } // ~x & y
+static inline keccak_x2 kx2_rol(keccak_x2 v, unsigned n)
+{
+    return wasm_v128_or(wasm_i64x2_shl(v, n), wasm_u64x2_shr(v, 64 - n));
+}
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+typedef __m128i keccak_x2;
+static inline keccak_x2 kx2_load(uint64_t a, uint64_t b) { return _mm_set_epi64x((long long)b, (long long)a); }
+static inline void kx2_store(keccak_x2 v, uint64_t *a, uint64_t *b)
+{
+    uint64_t t[2];
+    _mm_storeu_si128((__m128i *)t, v);
+    *a = t[0];
+    *b = t[1];
+}
+static inline keccak_x2 kx2_xor(keccak_x2 x, keccak_x2 y) { return _mm_xor_si128(x, y); }
+static inline keccak_x2 kx2_andn(keccak_x2 x, keccak_x2 y) { return _mm_andnot_si128(x, y); } // ~x & y
+static inline keccak_x2 kx2_rol(keccak_x2 v, unsigned n)
+{
+    return _mm_or_si128(_mm_sll_epi64(v, _mm_cvtsi32_si128((int)n)),
+                        _mm_srl_epi64(v, _mm_cvtsi32_si128((int)(64 - n))));
+}
+#else
+typedef struct
+{
+    uint64_t a, b;
+} keccak_x2;
+static inline keccak_x2 kx2_load(uint64_t a, uint64_t b) { return (keccak_x2){a, b}; }
+static inline void kx2_store(keccak_x2 v, uint64_t *a, uint64_t *b)
+{
+    *a = v.a;
+    *b = v.b;
+}
+static inline keccak_x2 kx2_xor(keccak_x2 x, keccak_x2 y) { return (keccak_x2){x.a ^ y.a, x.b ^ y.b}; }
+static inline keccak_x2 kx2_andn(keccak_x2 x, keccak_x2 y) { return (keccak_x2){~x.a & y.a, ~x.b & y.b}; }
+static inline keccak_x2 kx2_rol(keccak_x2 v, unsigned n)
+{
+    return (keccak_x2){(v.a << n) | (v.a >> (64 - n)), (v.b << n) | (v.b >> (64 - n))};
+}
+#endif
+
+static const uint64_t keccak_rc[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL,
+    0x8000000080008000ULL, 0x000000000000808BULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008AULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800AULL, 0x800000008000000AULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+// Rotation of lane x + 5y (rho) and its destination lane (pi)
+static const uint8_t keccak_rho[25] = {
+    0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43,
+    25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14};
+static const uint8_t keccak_pi[25] = {
+    0, 10, 20, 5, 15, 16, 1, 11, 21, 6, 7, 17, 2,
+    12, 22, 23, 8, 18, 3, 13, 14, 24, 9, 19, 4};
+
+// Keccak-f[1600] on two states at once
+static void keccak_f1600_x2(uint64_t *a, uint64_t *b)
+{
+    keccak_x2 s[25], t[25], c[5], d;
+    int i, x, y, round;
+
+    for (i = 0; i < 25; i++)
+        s[i] = kx2_load(a[i], b[i]);
+
+    for (round = 0; round < 24; round++)
+    {
+        // theta
+        for (x = 0; x < 5; x++)
+            c[x] = kx2_xor(kx2_xor(kx2_xor(s[x], s[x + 5]), kx2_xor(s[x + 10], s[x + 15])), s[x + 20]);
+        for (x = 0; x < 5; x++)
+        {
+            d = kx2_xor(c[(x + 4) % 5], kx2_rol(c[(x + 1) % 5], 1));
+            for (y = 0; y < 25; y += 5)
+                s[x + y] = kx2_xor(s[x + y], d);
+        }
+
+        // rho and pi
+        t[0] = s[0];
+        for (i = 1; i < 25; i++)
+            t[keccak_pi[i]] = kx2_rol(s[i], keccak_rho[i]);
+
+        // chi
+        for (y = 0; y < 25; y += 5)
+            for (x = 0; x < 5; x++)
+                s[x + y] = kx2_xor(t[x + y], kx2_andn(t[(x + 1) % 5 + y], t[(x + 2) % 5 + y]));
+
+        // iota
+        s[0] = kx2_xor(s[0], kx2_load(keccak_rc[round], keccak_rc[round]));
+    }
+
+    for (i = 0; i < 25; i++)
+        kx2_store(s[i], &a[i], &b[i]);
+}
+
+// XOR bytes into a state starting at byte offset dptr of the current block
+static void shake_xor_bytes(uint64_t *st, size_t dptr, const uint8_t *in, size_t len)
+{
+    for (size_t u = 0; u < len; u++)
+    {
+        size_t v = dptr + u;
+        st[v >> 3] ^= (uint64_t)in[u] << ((v & 7) << 3);
+    }
+}
+
+// XOR one full 136-byte block into a state
+static void shake_xor_block(uint64_t *st, const uint8_t *in)
+{
+    for (int w = 0; w < SHAKE256_RATE / 8; w++, in += 8)
+    {
+        st[w] ^= (uint64_t)in[0] | ((uint64_t)in[1] << 8) | ((uint64_t)in[2] << 16) |
+                 ((uint64_t)in[3] << 24) | ((uint64_t)in[4] << 32) | ((uint64_t)in[5] << 40) |
+                 ((uint64_t)in[6] << 48) | ((uint64_t)in[7] << 56);
+    }
+}
+
+// Equivalent to shake256_inject(sc0, msg, len) followed by
+// shake256_inject(sc1, msg, len)
+static void shake256_inject_x2(shake256_context *sc0, shake256_context *sc1,
+                               const uint8_t *msg, size_t len)
+{
+    uint64_t *st0 = sc0->opaque_contents;
+    uint64_t *st1 = sc1->opaque_contents;
+    size_t off0 = SHAKE256_RATE - (size_t)st0[25];
+    size_t off1 = SHAKE256_RATE - (size_t)st1[25];
+
+    // Both partial blocks must complete before the lanes can run together
+    if (len < off0 || len < off1)
+    {
+        shake256_inject(sc0, msg, len);
+        shake256_inject(sc1, msg, len);
+        return;
+    }
+
+    shake_xor_bytes(st0, (size_t)st0[25], msg, off0);
+    shake_xor_bytes(st1, (size_t)st1[25], msg, off1);
+    keccak_f1600_x2(st0, st1);
+
+    // Each lane absorbs its own window; the windows are at most one block apart
+    while (len - off0 >= SHAKE256_RATE && len - off1 >= SHAKE256_RATE)
+    {
+        shake_xor_block(st0, msg + off0);
+        shake_xor_block(st1, msg + off1);
+        keccak_f1600_x2(st0, st1);
+        off0 += SHAKE256_RATE;
+        off1 += SHAKE256_RATE;
+    }
+    st0[25] = 0;
+    st1[25] = 0;
+
+    // Remaining bytes (less than two blocks per lane)
+    shake256_inject(sc0, msg + off0, len - off0);
+    shake256_inject(sc1, msg + off1, len - off1);
+}
+
+// --- Fixed-width decoders ---
+// Falcon-1024 public keys pack h as 1024 values mod q on 14 bits each, and CT
+// signatures pack s2 as 1024 signed values on 12 bits, most significant bit
+// first. These decoders match Zf(modq_decode) and Zf(trim_i16_decode) for
+// those two fixed layouts, including their range checks, and unpack 8
+// coefficients per 128-bit shuffle with wasm SIMD (16 per 256-bit shuffle with
+// AVX2). Inputs are whole groups, so there are never leftover bits to check.
+
+#define FALCON_Q 12289
+#define FALCON_N 1024
+#define PK_COEFF_BYTES (FALCON_N * 14 / 8)
+#define CT_S2_BYTES (FALCON_N * 12 / 8)
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// 4 coefficients per 7 bytes; returns -1 if a value is not below q
+static int modq14_decode_scalar(uint16_t *x, const uint8_t *in, size_t count)
+{
+    for (size_t u = 0; u < count; u += 4, in += 7)
+    {
+        uint32_t hi = ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+        uint32_t lo = ((uint32_t)in[4] << 16) | ((uint32_t)in[5] << 8) | in[6];
+        uint16_t w0 = (uint16_t)(hi >> 18);
+        uint16_t w1 = (uint16_t)((hi >> 4) & 0x3FFF);
+        uint16_t w2 = (uint16_t)(((hi << 10) | (lo >> 14)) & 0x3FFF);
+        uint16_t w3 = (uint16_t)(lo & 0x3FFF);
+        if (w0 >= FALCON_Q || w1 >= FALCON_Q || w2 >= FALCON_Q || w3 >= FALCON_Q)
+            return -1;
+        x[u] = w0;
+        x[u + 1] = w1;
+        x[u + 2] = w2;
+        x[u + 3] = w3;
+    }
+    return 0;
+}
+
+// 2 coefficients per 3 bytes; returns -1 on the forbidden value -2048
+static int trim12_decode_scalar(int16_t *x, const uint8_t *in, size_t count)
+{
+    for (size_t u = 0; u < count; u += 2, in += 3)
+    {
+        int16_t w0 = (int16_t)(uint16_t)((in[0] << 8) | in[1]) >> 4;
+        int16_t w1 = (int16_t)(uint16_t)((in[1] << 12) | (in[2] << 4)) >> 4;
+        if (w0 == -2048 || w1 == -2048)
+            return -1;
+        x[u] = w0;
+        x[u + 1] = w1;
+    }
+    return 0;
+}
+
+// Coefficient k of a 14-byte group starts at bit 14k: the shuffles gather its
+// three bytes big-endian into a 32-bit lane, the multiply aligns it to bit 23
+// and the shift moves it down to bit 13.
+#define MODQ14_SHUF_LO 2, 1, 0, -1, 3, 2, 1, -1, 5, 4, 3, -1, 7, 6, 5, -1
+#define MODQ14_SHUF_HI 9, 8, 7, -1, 10, 9, 8, -1, 12, 11, 10, -1, -1, 13, 12, -1
+#define MODQ14_MUL 1, 64, 16, 4
+
+// Coefficient k of a 12-byte group: two bytes big-endian in a 16-bit lane,
+// the multiply moves the 12 bits to the top and the arithmetic shift
+// sign-extends them.
+#define TRIM12_SHUF 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+#define TRIM12_MUL 1, 16, 1, 16, 1, 16, 1, 16
+
+#if defined(__wasm_simd128__)
+
+static int modq14_decode_vec(uint16_t *x, const uint8_t *in, size_t count, size_t *done)
+{
+    const v128_t mul = wasm_i32x4_const(MODQ14_MUL);
+    const v128_t mask = wasm_i32x4_splat(0x3FFF);
+    const v128_t qmax = wasm_i16x8_splat(FALCON_Q - 1);
+    v128_t bad = wasm_i16x8_splat(0);
+    size_t len = count * 14 / 8;
+    size_t u = 0;
+
+    // Full 16-byte loads only; the last groups are left to the scalar decoder
+    for (; u * 14 / 8 + 16 <= len; u += 8, in += 14)
+    {
+        v128_t v = wasm_v128_load(in);
+        v128_t a = wasm_i8x16_swizzle(v, wasm_i8x16_const(MODQ14_SHUF_LO));
+        v128_t b = wasm_i8x16_swizzle(v, wasm_i8x16_const(MODQ14_SHUF_HI));
+        a = wasm_v128_and(wasm_u32x4_shr(wasm_i32x4_mul(a, mul), 10), mask);
+        b = wasm_v128_and(wasm_u32x4_shr(wasm_i32x4_mul(b, mul), 10), mask);
+        v128_t w = wasm_u16x8_narrow_i32x4(a, b);
+        bad = wasm_v128_or(bad, wasm_i16x8_gt(w, qmax));
+        wasm_v128_store(x + u, w);
+    }
+    *done = u;
+    return wasm_v128_any_true(bad) ? -1 : 0;
+}
+
+static int trim12_decode_vec(int16_t *x, const uint8_t *in, size_t count, size_t *done)
+{
+    const v128_t mul = wasm_i16x8_const(TRIM12_MUL);
+    const v128_t forbidden = wasm_i16x8_splat(-2048);
+    v128_t bad = wasm_i16x8_splat(0);
+    size_t len = count * 12 / 8;
+    size_t u = 0;
+
+    for (; u * 12 / 8 + 16 <= len; u += 8, in += 12)
+    {
+        v128_t v = wasm_i8x16_swizzle(wasm_v128_load(in), wasm_i8x16_const(TRIM12_SHUF));
+        v128_t w = wasm_i16x8_shr(wasm_i16x8_mul(v, mul), 4);
+        bad = wasm_v128_or(bad, wasm_i16x8_eq(w, forbidden));
+        wasm_v128_store(x + u, w);
+    }
+    *done = u;
+    return wasm_v128_any_true(bad) ? -1 : 0;
+}
+
+#elif defined(__AVX2__)
+
+// Two groups per iteration, one per 128-bit lane
+static inline __m256i load_groups(const uint8_t *in, size_t stride)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)in)),
+                                   _mm_loadu_si128((const __m128i *)(in + stride)), 1);
+}
+
+static int modq14_decode_vec(uint16_t *x, const uint8_t *in, size_t count, size_t *done)
+{
+    const __m256i shuf_lo = _mm256_setr_epi8(MODQ14_SHUF_LO, MODQ14_SHUF_LO);
+    const __m256i shuf_hi = _mm256_setr_epi8(MODQ14_SHUF_HI, MODQ14_SHUF_HI);
+    const __m256i mul = _mm256_setr_epi32(MODQ14_MUL, MODQ14_MUL);
+    const __m256i mask = _mm256_set1_epi32(0x3FFF);
+    const __m256i qmax = _mm256_set1_epi16(FALCON_Q - 1);
+    __m256i bad = _mm256_setzero_si256();
+    size_t len = count * 14 / 8;
+    size_t u = 0;
+
+    for (; u * 14 / 8 + 30 <= len; u += 16, in += 28)
+    {
+        __m256i v = load_groups(in, 14);
+        __m256i a = _mm256_shuffle_epi8(v, shuf_lo);
+        __m256i b = _mm256_shuffle_epi8(v, shuf_hi);
+        a = _mm256_and_si256(_mm256_srli_epi32(_mm256_mullo_epi32(a, mul), 10), mask);
+        b = _mm256_and_si256(_mm256_srli_epi32(_mm256_mullo_epi32(b, mul), 10), mask);
+        // In-lane pack keeps each group's 8 coefficients together and in order
+        __m256i w = _mm256_packus_epi32(a, b);
+        bad = _mm256_or_si256(bad, _mm256_cmpgt_epi16(w, qmax));
+        _mm256_storeu_si256((__m256i *)(x + u), w);
+    }
+    *done = u;
+    return _mm256_testz_si256(bad, bad) ? 0 : -1;
+}
+
+static int trim12_decode_vec(int16_t *x, const uint8_t *in, size_t count, size_t *done)
+{
+    const __m256i shuf = _mm256_setr_epi8(TRIM12_SHUF, TRIM12_SHUF);
+    const __m256i mul = _mm256_setr_epi16(TRIM12_MUL, TRIM12_MUL);
+    const __m256i forbidden = _mm256_set1_epi16(-2048);
+    __m256i bad = _mm256_setzero_si256();
+    size_t len = count * 12 / 8;
+    size_t u = 0;
+
+    for (; u * 12 / 8 + 28 <= len; u += 16, in += 24)
+    {
+        __m256i v = _mm256_shuffle_epi8(load_groups(in, 12), shuf);
+        __m256i w = _mm256_srai_epi16(_mm256_mullo_epi16(v, mul), 4);
+        bad = _mm256_or_si256(bad, _mm256_cmpeq_epi16(w, forbidden));
+        _mm256_storeu_si256((__m256i *)(x + u), w);
+    }
+    *done = u;
+    return _mm256_testz_si256(bad, bad) ? 0 : -1;
+}
+
+#else
+
+static int modq14_decode_vec(uint16_t *x, const uint8_t *in, size_t count, size_t *done)
+{
+    (void)x;
+    (void)in;
+    (void)count;
+    *done = 0;
+    return 0;
+}
+
+static int trim12_decode_vec(int16_t *x, const uint8_t *in, size_t count, size_t *done)
+{
+    (void)x;
+    (void)in;
+    (void)count;
+    *done = 0;
+    return 0;
+}
+
+#endif
+
+// Decode the 1024 coefficients of a public key (after its header byte)
+static int modq_decode_1024(uint16_t *h, const uint8_t *in, int vectorized)
+{
+    size_t done = 0;
+    if (vectorized && modq14_decode_vec(h, in, FALCON_N, &done) != 0)
+        return FALCON_ERR_FORMAT;
+    if (modq14_decode_scalar(h + done, in + done * 14 / 8, FALCON_N - done) != 0)
+        return FALCON_ERR_FORMAT;
+    return 0;
+}
+
+// Decode s2 from the 1536 payload bytes of a CT signature
+static int trim12_decode_1024(int16_t *s2, const uint8_t *in, int vectorized)
+{
+    size_t done = 0;
+    if (vectorized && trim12_decode_vec(s2, in, FALCON_N, &done) != 0)
+        return FALCON_ERR_FORMAT;
+    if (trim12_decode_scalar(s2 + done, in + done * 12 / 8, FALCON_N - done) != 0)
+        return FALCON_ERR_FORMAT;
+    return 0;
+}
+
+// Verification scratch (FALCON_TMPSIZE_VERIFY bytes), laid out as in
+// falcon_verify(): h, hashed message, s2, then 2n bytes for verify_raw
+static int16_t *verify_tmp_s2(uint8_t *tmp)
+{
+    return (int16_t *)tmp + 2 * FALCON_N;
+}
+
+// Verify a decoded s2 (stored at verify_tmp_s2(tmp)) against the public key,
+// with hd holding salt || message, flipped
+static int det1024_verify_s2_hashed(inner_shake256_context *hd, const uint8_t *pk, int ct, uint8_t *tmp)
+{
+    uint16_t *h = (uint16_t *)tmp;
+    uint16_t *hm = h + FALCON_N;
+    const int16_t *s2 = verify_tmp_s2(tmp);
+    uint8_t *atmp = tmp + 6 * FALCON_N;
+
+    if (pk[0] != FALCON_DET1024_LOGN || modq_decode_1024(h, pk + 1, 1) != 0)
+        return FALCON_ERR_FORMAT;
+    Zf(to_ntt_monty)(h, FALCON_DET1024_LOGN);
+
+    if (ct)
+        Zf(hash_to_point_ct)(hd, hm, FALCON_DET1024_LOGN, atmp);
+    else
+        Zf(hash_to_point_vartime)(hd, hm, FALCON_DET1024_LOGN);
+
+    return Zf(verify_raw)(hm, s2, h, FALCON_DET1024_LOGN, atmp) ? 0 : FALCON_ERR_BADSIG;
+}
+
+// Verify a decoded s2 (stored at verify_tmp_s2(tmp)) against the public key;
+// same steps as falcon_verify() after its signature decoding
+static int det1024_verify_s2(const uint8_t *salt, const uint8_t *pk,
+                             const uint8_t *msg, size_t msg_len, int ct, uint8_t *tmp)
+{
+    inner_shake256_context hd;
+
+    inner_shake256_init(&hd);
+    inner_shake256_inject(&hd, salt, 40);
+    inner_shake256_inject(&hd, msg, msg_len);
+    inner_shake256_flip(&hd);
+    return det1024_verify_s2_hashed(&hd, pk, ct, tmp);
+}
+
+// --- Partial LDL-tree expanded keys ---
+// Middle ground between falcon_sign_dyn (nothing cached) and a fully
+// expanded key: the basis B = [[g, -f], [G, -F]] in FFT form, the l10
+// polynomials of the top `levels` levels of the ffLDL tree, and the Gram
+// matrices of the subtrees below them. Signing walks the cached levels and
+// runs the dynamic sampler from the boundary down. Every value is computed
+// with the same operations, in the same order, as ffSampling_fft_dyntree()
+// in sign.c, so signatures are identical to falcon_sign_dyn().
+//
+// levels = 0 caches the basis only (the Gram matrix is rebuilt per
+// signature); levels = logn caches the whole tree except the leaf
+// normalization.
+
+typedef int (*partial_samplerZ)(void *ctx, fpr mu, fpr isigma);
+
+typedef struct
+{
+    uint8_t sk[SK_SIZE]; // encoded key, absorbed by the deterministic RNG
+    uint8_t levels;
+} partial_key_header;
+
+// fpr data starts at an 8-byte aligned offset after the header
+#define PARTIAL_KEY_FPR_OFFSET ((sizeof(partial_key_header) + 7) & ~(size_t)7)
+
+static size_t partial_boundary_len(unsigned levels)
+{
+    if (levels == 0)
+        return 0;
+    // g00 and g01 per boundary node; size-1 nodes only need g00
+    return levels < FALCON_DET1024_LOGN ? 2 * FALCON_N : FALCON_N;
+}
+
+static size_t partial_key_size(unsigned levels)
+{
+    return PARTIAL_KEY_FPR_OFFSET
+        + (4 * FALCON_N + levels * FALCON_N + partial_boundary_len(levels)) * sizeof(fpr);
+}
+
+static fpr *partial_key_fpr(uint8_t *ek)
+{
+    return (fpr *)(ek + PARTIAL_KEY_FPR_OFFSET);
+}
+
+static void smallints_to_fpr(fpr *r, const int8_t *t, unsigned logn)
+{
+    size_t n = (size_t)1 << logn;
+    for (size_t u = 0; u < n; u++)
+        r[u] = fpr_of(t[u]);
+}
+
+// Gram matrix of the basis, as computed in do_sign_dyn()
+static void partial_gram(fpr *g00, fpr *g01, fpr *g11, const fpr *basis, fpr *w)
+{
+    const unsigned logn = FALCON_DET1024_LOGN;
+    const size_t n = FALCON_N;
+    const fpr *b00 = basis, *b01 = b00 + n, *b10 = b01 + n, *b11 = b10 + n;
+
+    memcpy(w, b01, n * sizeof *w);
+    Zf(poly_mulselfadj_fft)(w, logn);
+    memcpy(g00, b00, n * sizeof *g00);
+    Zf(poly_mulselfadj_fft)(g00, logn);
+    Zf(poly_add)(g00, w, logn);
+
+    memcpy(w, b00, n * sizeof *w);
+    Zf(poly_muladj_fft)(w, b10, logn);
+    memcpy(g01, b01, n * sizeof *g01);
+    Zf(poly_muladj_fft)(g01, b11, logn);
+    Zf(poly_add)(g01, w, logn);
+
+    memcpy(g11, b10, n * sizeof *g11);
+    Zf(poly_mulselfadj_fft)(g11, logn);
+    memcpy(w, b11, n * sizeof *w);
+    Zf(poly_mulselfadj_fft)(w, logn);
+    Zf(poly_add)(g11, w, logn);
+}
+
+// LDL decomposition of the top levels (the first half of
+// ffSampling_fft_dyntree() at each node, without the sampling). Node j at
+// depth d stores l10 at top[d*n + j*m]; its children are 2j (d00 side) and
+// 2j + 1 (d11 side).
+static void partial_tree_build(fpr *top, fpr *boundary, fpr *g00, fpr *g01, fpr *g11,
+                               unsigned depth, size_t node, unsigned levels, fpr *tmp)
+{
+    const unsigned logm = FALCON_DET1024_LOGN - depth;
+    const size_t m = (size_t)1 << logm;
+    const size_t hm = m >> 1;
+
+    if (depth == levels)
+    {
+        if (m == 1)
+        {
+            boundary[node] = g00[0];
+        }
+        else
+        {
+            memcpy(boundary + node * 2 * m, g00, m * sizeof *g00);
+            memcpy(boundary + node * 2 * m + m, g01, m * sizeof *g01);
+        }
+        return;
+    }
+
+    Zf(poly_LDL_fft)(g00, g01, g11, logm);
+    Zf(poly_split_fft)(tmp, tmp + hm, g00, logm);
+    memcpy(g00, tmp, m * sizeof *tmp);
+    Zf(poly_split_fft)(tmp, tmp + hm, g11, logm);
+    memcpy(g11, tmp, m * sizeof *tmp);
+    memcpy(top + depth * FALCON_N + node * m, g01, m * sizeof *g01);
+    memcpy(g01, g00, hm * sizeof *g00);
+    memcpy(g01 + hm, g11, hm * sizeof *g00);
+
+    partial_tree_build(top, boundary, g00, g00 + hm, g01, depth + 1, 2 * node, levels, tmp);
+    partial_tree_build(top, boundary, g11, g11 + hm, g01 + hm, depth + 1, 2 * node + 1, levels, tmp);
+}
+
+// Copy of ffSampling_fft_dyntree() from sign.c (static there)
+static void ffsampling_dyntree(partial_samplerZ samp, void *samp_ctx, fpr *t0, fpr *t1,
+                               fpr *g00, fpr *g01, fpr *g11, unsigned orig_logn, unsigned logn, fpr *tmp)
+{
+    size_t n, hn;
+    fpr *z0, *z1;
+
+    if (logn == 0)
+    {
+        fpr leaf = fpr_mul(fpr_sqrt(g00[0]), fpr_inv_sigma[orig_logn]);
+        t0[0] = fpr_of(samp(samp_ctx, t0[0], leaf));
+        t1[0] = fpr_of(samp(samp_ctx, t1[0], leaf));
+        return;
+    }
+
+    n = (size_t)1 << logn;
+    hn = n >> 1;
+
+    Zf(poly_LDL_fft)(g00, g01, g11, logn);
+
+    Zf(poly_split_fft)(tmp, tmp + hn, g00, logn);
+    memcpy(g00, tmp, n * sizeof *tmp);
+    Zf(poly_split_fft)(tmp, tmp + hn, g11, logn);
+    memcpy(g11, tmp, n * sizeof *tmp);
+    memcpy(tmp, g01, n * sizeof *g01);
+    memcpy(g01, g00, hn * sizeof *g00);
+    memcpy(g01 + hn, g11, hn * sizeof *g00);
+
+    z1 = tmp + n;
+    Zf(poly_split_fft)(z1, z1 + hn, t1, logn);
+    ffsampling_dyntree(samp, samp_ctx, z1, z1 + hn, g11, g11 + hn, g01 + hn, orig_logn, logn - 1, z1 + n);
+    Zf(poly_merge_fft)(tmp + (n << 1), z1, z1 + hn, logn);
+
+    memcpy(z1, t1, n * sizeof *t1);
+    Zf(poly_sub)(z1, tmp + (n << 1), logn);
+    memcpy(t1, tmp + (n << 1), n * sizeof *tmp);
+    Zf(poly_mul_fft)(tmp, z1, logn);
+    Zf(poly_add)(t0, tmp, logn);
+
+    z0 = tmp;
+    Zf(poly_split_fft)(z0, z0 + hn, t0, logn);
+    ffsampling_dyntree(samp, samp_ctx, z0, z0 + hn, g00, g00 + hn, g01, orig_logn, logn - 1, z0 + n);
+    Zf(poly_merge_fft)(t0, z0, z0 + hn, logn);
+}
+
+typedef struct
+{
+    partial_samplerZ samp;
+    void *samp_ctx;
+    const fpr *top;
+    const fpr *boundary;
+    unsigned levels;
+} partial_sampler;
+
+// ffSampling over the cached levels; the same steps as
+// ffSampling_fft_dyntree() with l10 and the child Gram matrices read from
+// the key. Needs 3.5 * 2^logn fpr of tmp beyond what the boundary uses.
+static void ffsampling_partial(const partial_sampler *ps, fpr *t0, fpr *t1,
+                               unsigned depth, size_t node, fpr *tmp)
+{
+    const unsigned logm = FALCON_DET1024_LOGN - depth;
+    const size_t m = (size_t)1 << logm;
+    const size_t hm = m >> 1;
+    fpr *z0, *z1;
+
+    if (depth == ps->levels)
+    {
+        fpr *g00 = tmp, *g01 = g00 + m, *g11 = g01 + m;
+        if (m == 1)
+        {
+            g00[0] = ps->boundary[node];
+        }
+        else
+        {
+            memcpy(g00, ps->boundary + node * 2 * m, m * sizeof *g00);
+            memcpy(g01, ps->boundary + node * 2 * m + m, m * sizeof *g01);
+            memcpy(g11, g00, m * sizeof *g00);
+        }
+        ffsampling_dyntree(ps->samp, ps->samp_ctx, t0, t1, g00, g01, g11,
+                           FALCON_DET1024_LOGN, logm, g11 + m);
+        return;
+    }
+
+    memcpy(tmp, ps->top + depth * FALCON_N + node * m, m * sizeof *tmp);
+
+    z1 = tmp + m;
+    Zf(poly_split_fft)(z1, z1 + hm, t1, logm);
+    ffsampling_partial(ps, z1, z1 + hm, depth + 1, 2 * node + 1, z1 + m);
+    Zf(poly_merge_fft)(tmp + (m << 1), z1, z1 + hm, logm);
+
+    memcpy(z1, t1, m * sizeof *t1);
+    Zf(poly_sub)(z1, tmp + (m << 1), logm);
+    memcpy(t1, tmp + (m << 1), m * sizeof *tmp);
+    Zf(poly_mul_fft)(tmp, z1, logm);
+    Zf(poly_add)(t0, tmp, logm);
+
+    z0 = tmp;
+    Zf(poly_split_fft)(z0, z0 + hm, t0, logm);
+    ffsampling_partial(ps, z0, z0 + hm, depth + 1, 2 * node, z0 + m);
+    Zf(poly_merge_fft)(t0, z0, z0 + hm, logm);
+}
+
+// Scratch for partial-key signing, in fpr: t0, t1, then 8n for the Gram
+// matrix and sampler (levels = 0 is the largest case: 3n + 4n)
+#define PARTIAL_SIGN_TMP_FPR (10 * FALCON_N)
+
+// do_sign_dyn() with the basis, top levels and boundary Gram matrices taken
+// from the key; returns 1 and writes s2 if the signature is short enough
+static int do_sign_partial(partial_samplerZ samp, void *samp_ctx, int16_t *s2,
+                           uint8_t *ek, const uint16_t *hm, fpr *tmp)
+{
+    const partial_key_header *hdr = (const partial_key_header *)ek;
+    const unsigned logn = FALCON_DET1024_LOGN;
+    const size_t n = FALCON_N;
+    const fpr *basis = partial_key_fpr(ek);
+    const fpr *b00 = basis, *b01 = b00 + n, *b10 = b01 + n, *b11 = b10 + n;
+    fpr *t0 = tmp, *t1 = t0 + n, *work = t1 + n;
+    fpr *tx, *ty;
+    int16_t *s1tmp, *s2tmp;
+    uint32_t sqn, ng;
+    fpr ni;
+
+    // Target vector [hm, 0] through the basis, normalized by q
+    for (size_t u = 0; u < n; u++)
+        t0[u] = fpr_of(hm[u]);
+    Zf(FFT)(t0, logn);
+    ni = fpr_inverse_of_q;
+    memcpy(t1, t0, n * sizeof *t0);
+    Zf(poly_mul_fft)(t1, b01, logn);
+    Zf(poly_mulconst)(t1, fpr_neg(ni), logn);
+    Zf(poly_mul_fft)(t0, b11, logn);
+    Zf(poly_mulconst)(t0, ni, logn);
+
+    if (hdr->levels == 0)
+    {
+        fpr *g00 = work, *g01 = g00 + n, *g11 = g01 + n;
+        partial_gram(g00, g01, g11, basis, g11 + n);
+        ffsampling_dyntree(samp, samp_ctx, t0, t1, g00, g01, g11, logn, logn, g11 + n);
+    }
+    else
+    {
+        partial_sampler ps = {
+            samp, samp_ctx,
+            basis + 4 * n,
+            basis + 4 * n + hdr->levels * n,
+            hdr->levels,
+        };
+        ffsampling_partial(&ps, t0, t1, 0, 0, work);
+    }
+
+    // Lattice point for the sampled vector
+    tx = work;
+    ty = tx + n;
+    memcpy(tx, t0, n * sizeof *t0);
+    memcpy(ty, t1, n * sizeof *t1);
+    Zf(poly_mul_fft)(tx, b00, logn);
+    Zf(poly_mul_fft)(ty, b10, logn);
+    Zf(poly_add)(tx, ty, logn);
+    memcpy(ty, t0, n * sizeof *t0);
+    Zf(poly_mul_fft)(ty, b01, logn);
+
+    memcpy(t0, tx, n * sizeof *tx);
+    Zf(poly_mul_fft)(t1, b11, logn);
+    Zf(poly_add)(t1, ty, logn);
+    Zf(iFFT)(t0, logn);
+    Zf(iFFT)(t1, logn);
+
+    s1tmp = (int16_t *)tx;
+    sqn = 0;
+    ng = 0;
+    for (size_t u = 0; u < n; u++)
+    {
+        int32_t z = (int32_t)hm[u] - (int32_t)fpr_rint(t0[u]);
+        sqn += (uint32_t)(z * z);
+        ng |= sqn;
+        s1tmp[u] = (int16_t)z;
+    }
+    sqn |= -(ng >> 31);
+
+    s2tmp = (int16_t *)ty;
+    for (size_t u = 0; u < n; u++)
+        s2tmp[u] = (int16_t)-fpr_rint(t1[u]);
+    if (Zf(is_short_half)(sqn, s2tmp, logn))
+    {
+        memcpy(s2, s2tmp, n * sizeof *s2);
+        return 1;
+    }
+    return 0;
+}
+
+// Decode the private key and fill a partial expanded key
+static int partial_key_expand(uint8_t *ek, const uint8_t *sk, unsigned levels, uint8_t *tmp)
+{
+    const unsigned logn = FALCON_DET1024_LOGN;
+    const size_t n = FALCON_N;
+    partial_key_header *hdr = (partial_key_header *)ek;
+    fpr *basis = partial_key_fpr(ek);
+    fpr *b00 = basis, *b01 = b00 + n, *b10 = b01 + n, *b11 = b10 + n;
+    int8_t *f = (int8_t *)tmp, *g = f + n, *F = g + n, *G = F + n;
+    uint8_t *atmp = tmp + 4 * n;
+    size_t u, v;
+
+    if (falcon_get_logn(sk, SK_SIZE) != (int)logn)
+        return FALCON_ERR_FORMAT;
+    u = 1;
+    v = Zf(trim_i8_decode)(f, logn, Zf(max_fg_bits)[logn], sk + u, SK_SIZE - u);
+    if (v == 0)
+        return FALCON_ERR_FORMAT;
+    u += v;
+    v = Zf(trim_i8_decode)(g, logn, Zf(max_fg_bits)[logn], sk + u, SK_SIZE - u);
+    if (v == 0)
+        return FALCON_ERR_FORMAT;
+    u += v;
+    v = Zf(trim_i8_decode)(F, logn, Zf(max_FG_bits)[logn], sk + u, SK_SIZE - u);
+    if (v == 0)
+        return FALCON_ERR_FORMAT;
+    u += v;
+    if (u != SK_SIZE || !Zf(complete_private)(G, f, g, F, logn, atmp))
+        return FALCON_ERR_FORMAT;
+
+    memcpy(hdr->sk, sk, SK_SIZE);
+    hdr->levels = (uint8_t)levels;
+
+    // Basis as in do_sign_dyn()
+    smallints_to_fpr(b01, f, logn);
+    smallints_to_fpr(b00, g, logn);
+    smallints_to_fpr(b11, F, logn);
+    smallints_to_fpr(b10, G, logn);
+    Zf(FFT)(b01, logn);
+    Zf(FFT)(b00, logn);
+    Zf(FFT)(b11, logn);
+    Zf(FFT)(b10, logn);
+    Zf(poly_neg)(b01, logn);
+    Zf(poly_neg)(b11, logn);
+    secure_zero(tmp, 4 * n);
+
+    if (levels > 0)
+    {
+        fpr *gram = (fpr *)tmp;
+        fpr *g00 = gram, *g01 = g00 + n, *g11 = g01 + n;
+        partial_gram(g00, g01, g11, basis, g11 + n);
+        partial_tree_build(basis + 4 * n, basis + 4 * n + levels * n,
+                           g00, g01, g11, 0, 0, levels, g11 + n);
+    }
+    return 0;
+}
+
 // --- Public API Exports ---
 EMSCRIPTEN_KEEPALIVE int get_sk_size() { return SK_SIZE; }
 EMSCRIPTEN_KEEPALIVE int get_pk_size() { return PK_SIZE; }
@@ -56,42 +899,27 @@ int falcon_det1024_keygen_wrapper(uint8_t *sk, uint8_t *pk)
     }
 
     // Zeroize seed after use
-    sodium_memzero(seed, sizeof(seed));
+    secure_zero(seed, sizeof(seed));
     return r;
 }
 
-// --- Signature Wrapper (unchanged core Falcon logic) ---
-EMSCRIPTEN_KEEPALIVE
-int falcon_det1024_sign_compressed_wrapper(uint8_t *sig, size_t *sig_len,
-                                           const uint8_t *sk, const uint8_t *msg, size_t msg_len)
+// Sign with a deterministic RNG that has absorbed logn || sk: salt the
+// hash-to-point state, absorb the message into both states in a single pass
+// and finish the dynamic signature. Shared by the one-shot and midstate
+// wrappers so their signatures are identical.
+static int det1024_sign_dyn(shake256_context *detrng, uint8_t *sig, size_t *sig_len,
+                            const uint8_t *sk, const uint8_t *msg, size_t msg_len)
 {
     int r;
-
-    printf("[falcon_wrapper] falcon_det1024_sign_compressed_wrapper called\n");
-
-    if (!sig || !sig_len || !sk || (!msg && msg_len > 0))
-    {
-        fprintf(stderr, "[falcon_wrapper] Invalid input parameters\n");
-        return -1;
-    }
-
-    if (*sig_len < SIG_COMPRESSED_MAX_SIZE)
-    {
-        fprintf(stderr, "[falcon_wrapper] Signature buffer too small\n");
-        return -2;
-    }
-
-    shake256_context *detrng = malloc(sizeof(shake256_context));
     shake256_context *hd = malloc(sizeof(shake256_context));
     size_t tmpsd_size = FALCON_TMPSIZE_SIGNDYN(FALCON_DET1024_LOGN);
     uint8_t *tmpsd = malloc(tmpsd_size);
     uint8_t *salt = malloc(40);
     uint8_t *saltedsig = malloc(FALCON_SIG_COMPRESSED_MAXSIZE(FALCON_DET1024_LOGN));
 
-    if (!detrng || !hd || !tmpsd || !salt || !saltedsig)
+    if (!hd || !tmpsd || !salt || !saltedsig)
     {
         fprintf(stderr, "[falcon_wrapper] malloc failed\n");
-        free(detrng);
         free(hd);
         free(tmpsd);
         free(salt);
@@ -99,26 +927,6 @@ int falcon_det1024_sign_compressed_wrapper(uint8_t *sig, size_t *sig_len,
         return -100;
     }
 
-    if (falcon_get_logn(sk, SK_SIZE) != FALCON_DET1024_LOGN)
-    {
-        fprintf(stderr, "[falcon_wrapper] Invalid private key format\n");
-        free(detrng);
-        free(hd);
-        free(tmpsd);
-        free(salt);
-        free(saltedsig);
-        return FALCON_ERR_FORMAT;
-    }
-
-    uint8_t logn[1] = {FALCON_DET1024_LOGN};
-
-    // Deterministic SHAKE256 RNG state
-    shake256_init(detrng);
-    shake256_inject(detrng, logn, 1);
-    shake256_inject(detrng, sk, SK_SIZE);
-    shake256_inject(detrng, msg, msg_len);
-    shake256_flip(detrng);
-
     // Salt preparation
     salt[0] = FALCON_DET1024_CURRENT_SALT_VERSION;
     salt[1] = FALCON_DET1024_LOGN;
@@ -127,7 +935,10 @@ int falcon_det1024_sign_compressed_wrapper(uint8_t *sig, size_t *sig_len,
 
     shake256_init(hd);
     shake256_inject(hd, salt, 40);
-    shake256_inject(hd, msg, msg_len);
+
+    // Message absorbed into both states in a single pass
+    shake256_inject_x2(detrng, hd, msg, msg_len);
+    shake256_flip(detrng);
 
     size_t sigcomp_len = SIG_COMPRESSED_MAX_SIZE;
     r = falcon_sign_dyn_finish(
@@ -145,16 +956,71 @@ int falcon_det1024_sign_compressed_wrapper(uint8_t *sig, size_t *sig_len,
         sig[1] = FALCON_DET1024_CURRENT_SALT_VERSION;
         memcpy(sig + 2, saltedsig + 41, sigcomp_len - 41);
         *sig_len = sigcomp_len - 40 + 1;
-        printf("[falcon_wrapper] Signature generated successfully (%zu bytes)\n", *sig_len);
     }
 
-    free(detrng);
     free(hd);
     free(tmpsd);
     free(salt);
     free(saltedsig);
     return r;
 }
+
+// Deterministic SHAKE256 RNG state after logn || sk
+static void det1024_sk_midstate(shake256_context *detrng, const uint8_t *sk)
+{
+    uint8_t logn[1] = {FALCON_DET1024_LOGN};
+    shake256_init(detrng);
+    shake256_inject(detrng, logn, 1);
+    shake256_inject(detrng, sk, SK_SIZE);
+}
+
+// --- Signature Wrapper (unchanged core Falcon logic) ---
+EMSCRIPTEN_KEEPALIVE
+int falcon_det1024_sign_compressed_wrapper(uint8_t *sig, size_t *sig_len,
+                                           const uint8_t *sk, const uint8_t *msg, size_t msg_len)
+{
+    int r;
+
+    printf("[falcon_wrapper] falcon_det1024_sign_compressed_wrapper called\n");
+
+    if (!sig || !sig_len || !sk || (!msg && msg_len > 0))
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid input parameters\n");
+        return -1;
+    }
+
+    if (*sig_len < SIG_COMPRESSED_MAX_SIZE)
+    {
+        fprintf(stderr, "[falcon_wrapper] Signature buffer too small\n");
+        return -2;
+    }
+
+    if (falcon_get_logn(sk, SK_SIZE) != FALCON_DET1024_LOGN)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid private key format\n");
+        return FALCON_ERR_FORMAT;
+    }
+
+    shake256_context *detrng = malloc(sizeof(shake256_context));
+    if (!detrng)
+    {
+        fprintf(stderr, "[falcon_wrapper] malloc failed\n");
+        return -100;
+    }
+
+    // Deterministic SHAKE256 RNG state
+    det1024_sk_midstate(detrng, sk);
+
+    r = det1024_sign_dyn(detrng, sig, sig_len, sk, msg, msg_len);
+    if (r == 0)
+    {
+        printf("[falcon_wrapper] Signature generated successfully (%zu bytes)\n", *sig_len);
+    }
+
+    free(detrng);
+    return r;
+}
+
 EMSCRIPTEN_KEEPALIVE
 int falcon_det1024_convert_compressed_to_ct_wrapper(uint8_t *sig_ct,
                                                     const uint8_t *sig_compressed, size_t sig_compressed_len)
@@ -205,8 +1071,8 @@ int falcon_det1024_verify_compressed_wrapper(const uint8_t *sig, size_t sig_len,
         return -1;
     }
 
-    // Check if signature has the correct header byte
-    if (sig_len < 2 || (sig[0] != FALCON_DET1024_SIG_COMPRESSED_HEADER))
+    // Check the signature length and header byte
+    if (sig_len < 2 || sig_len > SIG_COMPRESSED_MAX_SIZE || (sig[0] != FALCON_DET1024_SIG_COMPRESSED_HEADER))
     {
         fprintf(stderr, "[falcon_wrapper] Invalid signature format\n");
         return FALCON_ERR_BADSIG;
@@ -216,29 +1082,16 @@ int falcon_det1024_verify_compressed_wrapper(const uint8_t *sig, size_t sig_len,
     uint8_t *tmpvv = malloc(FALCON_TMPSIZE_VERIFY(FALCON_DET1024_LOGN));
     if (!tmpvv)
     {
-        fprintf(stderr, "[falcon_wrapper] malloc failed for tmpvv\n");
-        return -100;
-    }
-
-    // Allocate and prepare the salted signature
-    uint8_t *salted_sig = malloc(FALCON_SIG_COMPRESSED_MAXSIZE(FALCON_DET1024_LOGN));
-    if (!salted_sig)
-    {
-        fprintf(stderr, "[falcon_wrapper] malloc failed for salted_sig\n");
-        free(tmpvv);
+        fprintf(stderr, "[falcon_wrapper] malloc failed for tmpvv\n");
         return -100;
     }
 
-    // Convert the deterministic signature to salted format
-    salted_sig[0] = sig[0] & ~0x80; // Reset MSB to 0
-
     // Allocate and prepare the salt
     uint8_t *salt = malloc(40);
     if (!salt)
     {
         fprintf(stderr, "[falcon_wrapper] malloc failed for salt\n");
         free(tmpvv);
-        free(salted_sig);
         return -100;
     }
 
@@ -248,22 +1101,20 @@ int falcon_det1024_verify_compressed_wrapper(const uint8_t *sig, size_t sig_len,
     memcpy(salt + 2, "FALCON_DET", 10);
     memset(salt + 12, 0, 28); // Fill the rest with zeros
 
-    // Copy salt to the salted signature
-    memcpy(salted_sig + 1, salt, 40);
-
-    // Copy the rest of the signature
-    memcpy(salted_sig + 41, sig + 2, sig_len - 2);
-
-    // The salted signature is 40-1 bytes longer
-    size_t salted_sig_len = sig_len + 40 - 1;
-
-    r = falcon_verify(salted_sig, salted_sig_len, FALCON_SIG_COMPRESSED,
-                      pk, PK_SIZE, msg, msg_len,
-                      tmpvv, FALCON_TMPSIZE_VERIFY(FALCON_DET1024_LOGN));
+    // Decode s2; the compressed encoding must use every remaining byte
+    int16_t *s2 = verify_tmp_s2(tmpvv);
+    size_t s2_len = Zf(comp_decode)(s2, FALCON_DET1024_LOGN, sig + 2, sig_len - 2);
+    if (s2_len == 0 || s2_len != sig_len - 2)
+    {
+        r = FALCON_ERR_FORMAT;
+    }
+    else
+    {
+        r = det1024_verify_s2(salt, pk, msg, msg_len, 0, tmpvv);
+    }
 
     // Free allocated memory
     free(tmpvv);
-    free(salted_sig);
     free(salt);
 
     if (r != 0)
@@ -312,25 +1163,12 @@ int falcon_det1024_verify_ct_wrapper(const uint8_t *sig,
         return -100;
     }
 
-    // Allocate and prepare the salted signature
-    uint8_t *salted_sig = malloc(FALCON_SIG_CT_SIZE(FALCON_DET1024_LOGN));
-    if (!salted_sig)
-    {
-        fprintf(stderr, "[falcon_wrapper] malloc failed for salted_sig\n");
-        free(tmpvv);
-        return -100;
-    }
-
-    // Convert the deterministic signature to salted format
-    salted_sig[0] = sig[0] & ~0x80; // Reset MSB to 0
-
     // Allocate and prepare the salt
     uint8_t *salt = malloc(40);
     if (!salt)
     {
         fprintf(stderr, "[falcon_wrapper] malloc failed for salt\n");
         free(tmpvv);
-        free(salted_sig);
         return -100;
     }
 
@@ -340,19 +1178,18 @@ int falcon_det1024_verify_ct_wrapper(const uint8_t *sig,
     memcpy(salt + 2, "FALCON_DET", 10);
     memset(salt + 12, 0, 28); // Fill the rest with zeros
 
-    // Copy salt to the salted signature
-    memcpy(salted_sig + 1, salt, 40);
-
-    // Copy the rest of the signature
-    memcpy(salted_sig + 41, sig + 2, SIG_CT_SIZE - 2);
-
-    r = falcon_verify(salted_sig, FALCON_SIG_CT_SIZE(FALCON_DET1024_LOGN), FALCON_SIG_CT,
-                      pk, PK_SIZE, msg, msg_len,
-                      tmpvv, FALCON_TMPSIZE_VERIFY(FALCON_DET1024_LOGN));
+    // Decode the fixed-width s2 that follows the header and salt version
+    if (trim12_decode_1024(verify_tmp_s2(tmpvv), sig + 2, 1) != 0)
+    {
+        r = FALCON_ERR_FORMAT;
+    }
+    else
+    {
+        r = det1024_verify_s2(salt, pk, msg, msg_len, 1, tmpvv);
+    }
 
     // Free allocated memory
     free(tmpvv);
-    free(salted_sig);
     free(salt);
 
     if (r != 0)
@@ -377,3 +1214,432 @@ int falcon_det1024_get_salt_version_wrapper(const uint8_t *sig)
 
     return falcon_det1024_get_salt_version(sig);
 }
+
+// --- Decoder exports (benchmarks and tests) ---
+// Decode a public key into h (1024 uint16 values); vectorized = 0 forces the
+// scalar decoder. Returns 0 or FALCON_ERR_FORMAT.
+EMSCRIPTEN_KEEPALIVE
+int falcon_det1024_decode_pubkey_wrapper(uint16_t *h, const uint8_t *pk, int vectorized)
+{
+    if (!h || !pk)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid input parameters\n");
+        return -1;
+    }
+    if (pk[0] != FALCON_DET1024_LOGN)
+        return FALCON_ERR_FORMAT;
+    return modq_decode_1024(h, pk + 1, vectorized);
+}
+
+// Decode s2 of a CT signature (1024 int16 values); vectorized = 0 forces the
+// scalar decoder. Returns 0 or FALCON_ERR_FORMAT.
+EMSCRIPTEN_KEEPALIVE
+int falcon_det1024_decode_sig_ct_wrapper(int16_t *s2, const uint8_t *sig, int vectorized)
+{
+    if (!s2 || !sig)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid input parameters\n");
+        return -1;
+    }
+    if (sig[0] != FALCON_DET1024_SIG_CT_HEADER)
+        return FALCON_ERR_FORMAT;
+    return trim12_decode_1024(s2, sig + 2, vectorized);
+}
+
+// --- Secret-key midstate exports ---
+// Before the message, the deterministic RNG absorbs logn || sk: 2306 bytes,
+// 17 Keccak permutations, which dominate hashing for short messages. A
+// midstate is that SHAKE256 state, computed once per key and copied for
+// each signature. It reproduces the key's signing randomness, so it is as
+// secret as the key and must be zeroized like it.
+
+// Size of a midstate in bytes
+EMSCRIPTEN_KEEPALIVE
+size_t falcon_det1024_sk_midstate_size()
+{
+    return sizeof(shake256_context);
+}
+
+// Compute the midstate of a private key into ms
+// (falcon_det1024_sk_midstate_size() bytes)
+EMSCRIPTEN_KEEPALIVE
+int falcon_det1024_sk_midstate_wrapper(uint8_t *ms, const uint8_t *sk)
+{
+    if (!ms || !sk)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid input parameters\n");
+        return -1;
+    }
+
+    if (falcon_get_logn(sk, SK_SIZE) != FALCON_DET1024_LOGN)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid private key format\n");
+        return FALCON_ERR_FORMAT;
+    }
+
+    shake256_context detrng;
+    det1024_sk_midstate(&detrng, sk);
+    memcpy(ms, &detrng, sizeof(shake256_context));
+    secure_zero(&detrng, sizeof(shake256_context));
+    return 0;
+}
+
+// Same output as falcon_det1024_sign_compressed_wrapper(), starting from the
+// midstate ms of sk; ms is copied, never modified
+EMSCRIPTEN_KEEPALIVE
+int falcon_det1024_sign_compressed_midstate_wrapper(uint8_t *sig, size_t *sig_len, const uint8_t *sk,
+                                                    const uint8_t *ms, const uint8_t *msg, size_t msg_len)
+{
+    if (!sig || !sig_len || !sk || !ms || (!msg && msg_len > 0))
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid input parameters\n");
+        return -1;
+    }
+
+    if (*sig_len < SIG_COMPRESSED_MAX_SIZE)
+    {
+        fprintf(stderr, "[falcon_wrapper] Signature buffer too small\n");
+        return -2;
+    }
+
+    if (falcon_get_logn(sk, SK_SIZE) != FALCON_DET1024_LOGN)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid private key format\n");
+        return FALCON_ERR_FORMAT;
+    }
+
+    shake256_context detrng;
+    memcpy(&detrng, ms, sizeof(shake256_context));
+    int r = det1024_sign_dyn(&detrng, sig, sig_len, sk, msg, msg_len);
+    secure_zero(&detrng, sizeof(shake256_context));
+    return r;
+}
+
+// --- Partial LDL-tree signing exports ---
+// Size of a partial expanded key caching `levels` tree levels (0 to 10), or
+// 0 if levels is out of range
+EMSCRIPTEN_KEEPALIVE
+size_t falcon_det1024_partial_key_size(unsigned levels)
+{
+    return levels <= FALCON_DET1024_LOGN ? partial_key_size(levels) : 0;
+}
+
+// Expand a private key into ek (falcon_det1024_partial_key_size(levels) bytes)
+EMSCRIPTEN_KEEPALIVE
+int falcon_det1024_expand_partial_wrapper(uint8_t *ek, const uint8_t *sk, unsigned levels)
+{
+    if (!ek || !sk || levels > FALCON_DET1024_LOGN)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid input parameters\n");
+        return -1;
+    }
+
+    uint8_t *tmp = malloc(PARTIAL_SIGN_TMP_FPR * sizeof(fpr));
+    if (!tmp)
+    {
+        fprintf(stderr, "[falcon_wrapper] malloc failed\n");
+        return -100;
+    }
+
+    int r = partial_key_expand(ek, sk, levels, tmp);
+    if (r != 0)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid private key format\n");
+    }
+    secure_zero(tmp, PARTIAL_SIGN_TMP_FPR * sizeof(fpr));
+    free(tmp);
+    return r;
+}
+
+// Same output as falcon_det1024_sign_compressed_wrapper() for the key ek
+// was expanded from
+EMSCRIPTEN_KEEPALIVE
+int falcon_det1024_sign_compressed_partial_wrapper(uint8_t *sig, size_t *sig_len,
+                                                   uint8_t *ek, const uint8_t *msg, size_t msg_len)
+{
+    const partial_key_header *hdr = (const partial_key_header *)ek;
+    shake256_context detrng;
+    shake256_context hd;
+    uint8_t salt[40];
+
+    if (!sig || !sig_len || !ek || (!msg && msg_len > 0) || hdr->levels > FALCON_DET1024_LOGN)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid input parameters\n");
+        return -1;
+    }
+
+    if (*sig_len < SIG_COMPRESSED_MAX_SIZE)
+    {
+        fprintf(stderr, "[falcon_wrapper] Signature buffer too small\n");
+        return -2;
+    }
+
+    uint16_t *hm = malloc(FALCON_N * sizeof(uint16_t));
+    int16_t *sv = malloc(FALCON_N * sizeof(int16_t));
+    fpr *tmp = malloc(PARTIAL_SIGN_TMP_FPR * sizeof(fpr));
+    if (!hm || !sv || !tmp)
+    {
+        fprintf(stderr, "[falcon_wrapper] malloc failed\n");
+        free(hm);
+        free(sv);
+        free(tmp);
+        return -100;
+    }
+
+    // Same RNG and hash states as the dynamic signer
+    det1024_sk_midstate(&detrng, hdr->sk);
+
+    salt[0] = FALCON_DET1024_CURRENT_SALT_VERSION;
+    salt[1] = FALCON_DET1024_LOGN;
+    memcpy(salt + 2, "FALCON_DET", 10);
+    memset(salt + 12, 0, 28);
+
+    shake256_init(&hd);
+    shake256_inject(&hd, salt, 40);
+
+    shake256_inject_x2(&detrng, &hd, msg, msg_len);
+    shake256_flip(&detrng);
+    shake256_flip(&hd);
+    Zf(hash_to_point_vartime)((inner_shake256_context *)&hd, hm, FALCON_DET1024_LOGN);
+
+    // falcon_sign_dyn_finish() loop: sign (Zf(sign_dyn)(), a fresh sampler
+    // per attempt) until the signature fits the dynamic signer's encoding
+    // bound; an oversized one is resampled from the continuing detrng stream
+    size_t v;
+    for (;;)
+    {
+        for (;;)
+        {
+            sampler_context spc;
+            spc.sigma_min = fpr_sigma_min[FALCON_DET1024_LOGN];
+            Zf(prng_init)(&spc.p, (inner_shake256_context *)&detrng);
+            if (do_sign_partial(Zf(sampler), &spc, sv, ek, hm, tmp))
+                break;
+        }
+        v = Zf(comp_encode)(sig + 2, SIG_COMPRESSED_MAX_SIZE - 41, sv, FALCON_DET1024_LOGN);
+        if (v != 0)
+            break;
+    }
+
+    sig[0] = (0x30 + FALCON_DET1024_LOGN) | 0x80;
+    sig[1] = FALCON_DET1024_CURRENT_SALT_VERSION;
+    *sig_len = v + 2;
+
+    secure_zero(tmp, PARTIAL_SIGN_TMP_FPR * sizeof(fpr));
+    free(hm);
+    free(sv);
+    free(tmp);
+    return 0;
+}
+
+// --- Streaming exports ---
+// Sign or verify a message fed in chunks (e.g. a file read piece by piece
+// into one reused buffer), so the whole message never has to be in memory.
+// Chunks are absorbed into the same SHAKE256 states as the one-shot
+// wrappers, so signatures and results are identical to them for the
+// concatenated message. init returns a stream (NULL on invalid input or
+// allocation failure); finish, or abort, frees it.
+
+typedef struct
+{
+    shake256_context detrng; // deterministic RNG: logn || sk || message
+    shake256_context hd;     // hash-to-point input: salt || message
+    uint8_t salt[40];
+    uint8_t sk[SK_SIZE];
+} det1024_sign_stream;
+
+typedef struct
+{
+    inner_shake256_context hd; // hash-to-point input: salt || message
+    uint8_t sig[SIG_COMPRESSED_MAX_SIZE > SIG_CT_SIZE ? SIG_COMPRESSED_MAX_SIZE : SIG_CT_SIZE];
+    size_t sig_len;
+    uint8_t pk[PK_SIZE];
+    int ct;
+} det1024_verify_stream;
+
+EMSCRIPTEN_KEEPALIVE
+det1024_sign_stream *falcon_det1024_sign_stream_init(const uint8_t *sk)
+{
+    if (!sk || falcon_get_logn(sk, SK_SIZE) != FALCON_DET1024_LOGN)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid private key format\n");
+        return NULL;
+    }
+
+    det1024_sign_stream *st = malloc(sizeof(det1024_sign_stream));
+    if (!st)
+    {
+        fprintf(stderr, "[falcon_wrapper] malloc failed\n");
+        return NULL;
+    }
+
+    memcpy(st->sk, sk, SK_SIZE);
+    det1024_sk_midstate(&st->detrng, sk);
+
+    st->salt[0] = FALCON_DET1024_CURRENT_SALT_VERSION;
+    st->salt[1] = FALCON_DET1024_LOGN;
+    memcpy(st->salt + 2, "FALCON_DET", 10);
+    memset(st->salt + 12, 0, 28);
+    shake256_init(&st->hd);
+    shake256_inject(&st->hd, st->salt, 40);
+    return st;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void falcon_det1024_sign_stream_update(det1024_sign_stream *st, const uint8_t *chunk, size_t len)
+{
+    if (st && (chunk || len == 0))
+        shake256_inject_x2(&st->detrng, &st->hd, chunk, len);
+}
+
+// Zeroize and free a sign stream without signing
+EMSCRIPTEN_KEEPALIVE
+void falcon_det1024_sign_stream_abort(det1024_sign_stream *st)
+{
+    if (st)
+    {
+        secure_zero(st, sizeof(det1024_sign_stream));
+        free(st);
+    }
+}
+
+// Same output as falcon_det1024_sign_compressed_wrapper(); frees the stream
+EMSCRIPTEN_KEEPALIVE
+int falcon_det1024_sign_stream_finish(det1024_sign_stream *st, uint8_t *sig, size_t *sig_len)
+{
+    if (!st || !sig || !sig_len || *sig_len < SIG_COMPRESSED_MAX_SIZE)
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid input parameters\n");
+        falcon_det1024_sign_stream_abort(st);
+        return -1;
+    }
+
+    size_t tmpsd_size = FALCON_TMPSIZE_SIGNDYN(FALCON_DET1024_LOGN);
+    uint8_t *tmpsd = malloc(tmpsd_size);
+    uint8_t *saltedsig = malloc(FALCON_SIG_COMPRESSED_MAXSIZE(FALCON_DET1024_LOGN));
+    if (!tmpsd || !saltedsig)
+    {
+        fprintf(stderr, "[falcon_wrapper] malloc failed\n");
+        free(tmpsd);
+        free(saltedsig);
+        falcon_det1024_sign_stream_abort(st);
+        return -100;
+    }
+
+    shake256_flip(&st->detrng);
+    size_t sigcomp_len = SIG_COMPRESSED_MAX_SIZE;
+    int r = falcon_sign_dyn_finish(
+        &st->detrng, saltedsig, &sigcomp_len,
+        FALCON_SIG_COMPRESSED, st->sk, SK_SIZE,
+        &st->hd, st->salt, tmpsd, tmpsd_size);
+
+    if (r != 0)
+    {
+        fprintf(stderr, "[falcon_wrapper] sign_dyn_finish failed: %d\n", r);
+    }
+    else
+    {
+        sig[0] = saltedsig[0] | 0x80;
+        sig[1] = FALCON_DET1024_CURRENT_SALT_VERSION;
+        memcpy(sig + 2, saltedsig + 41, sigcomp_len - 41);
+        *sig_len = sigcomp_len - 40 + 1;
+    }
+
+    secure_zero(tmpsd, tmpsd_size);
+    free(tmpsd);
+    free(saltedsig);
+    falcon_det1024_sign_stream_abort(st);
+    return r;
+}
+
+// ct = 0 for a compressed signature, 1 for a CT signature (sig_len ignored)
+EMSCRIPTEN_KEEPALIVE
+det1024_verify_stream *falcon_det1024_verify_stream_init(const uint8_t *sig, size_t sig_len,
+                                                         const uint8_t *pk, int ct)
+{
+    if (ct)
+        sig_len = SIG_CT_SIZE;
+    if (!sig || !pk || sig_len < 2 || sig_len > (ct ? SIG_CT_SIZE : SIG_COMPRESSED_MAX_SIZE))
+    {
+        fprintf(stderr, "[falcon_wrapper] Invalid input parameters\n");
+        return NULL;
+    }
+
+    det1024_verify_stream *st = malloc(sizeof(det1024_verify_stream));
+    if (!st)
+    {
+        fprintf(stderr, "[falcon_wrapper] malloc failed\n");
+        return NULL;
+    }
+
+    memcpy(st->sig, sig, sig_len);
+    st->sig_len = sig_len;
+    memcpy(st->pk, pk, PK_SIZE);
+    st->ct = ct;
+
+    uint8_t salt[40];
+    salt[0] = sig[1]; // Salt version
+    salt[1] = FALCON_DET1024_LOGN;
+    memcpy(salt + 2, "FALCON_DET", 10);
+    memset(salt + 12, 0, 28);
+    inner_shake256_init(&st->hd);
+    inner_shake256_inject(&st->hd, salt, 40);
+    return st;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void falcon_det1024_verify_stream_update(det1024_verify_stream *st, const uint8_t *chunk, size_t len)
+{
+    if (st && (chunk || len == 0))
+        inner_shake256_inject(&st->hd, chunk, len);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void falcon_det1024_verify_stream_abort(det1024_verify_stream *st)
+{
+    free(st);
+}
+
+// Same result as the verify wrapper for the stream's format; frees the stream
+EMSCRIPTEN_KEEPALIVE
+int falcon_det1024_verify_stream_finish(det1024_verify_stream *st)
+{
+    if (!st)
+        return -1;
+
+    uint8_t *tmpvv = malloc(FALCON_TMPSIZE_VERIFY(FALCON_DET1024_LOGN));
+    if (!tmpvv)
+    {
+        fprintf(stderr, "[falcon_wrapper] malloc failed for tmpvv\n");
+        free(st);
+        return -100;
+    }
+
+    int r;
+    int16_t *s2 = verify_tmp_s2(tmpvv);
+    if (st->ct)
+    {
+        r = st->sig[0] != FALCON_DET1024_SIG_CT_HEADER ? FALCON_ERR_BADSIG
+            : trim12_decode_1024(s2, st->sig + 2, 1) != 0 ? FALCON_ERR_FORMAT : 0;
+    }
+    else if (st->sig[0] != FALCON_DET1024_SIG_COMPRESSED_HEADER)
+    {
+        r = FALCON_ERR_BADSIG;
+    }
+    else
+    {
+        // The compressed encoding must use every remaining byte
+        size_t s2_len = Zf(comp_decode)(s2, FALCON_DET1024_LOGN, st->sig + 2, st->sig_len - 2);
+        r = s2_len == 0 || s2_len != st->sig_len - 2 ? FALCON_ERR_FORMAT : 0;
+    }
+
+    if (r == 0)
+    {
+        inner_shake256_flip(&st->hd);
+        r = det1024_verify_s2_hashed(&st->hd, st->pk, st->ct, tmpvv);
+    }
+
+    free(tmpvv);
+    free(st);
+    return r;
+}
@@ -3,16 +3,147 @@
  */
 import ModuleFactory from './falcon.js';
 
+// Key and signature sizes reported by the module, shared by all instances
+let moduleSizes = null;
+
+// Compiled falcon.wasm, shared by all instances (and re-warms) in this realm
+let wasmModulePromise = null;
+
+/**
+ * Compile falcon.wasm once; instances then only instantiate it
+ * @returns {Promise<WebAssembly.Module|null>} Compiled module, or null to let
+ *   the Emscripten loader fetch and compile it itself
+ */
+function compileWasmModule() {
+  wasmModulePromise ??= (async () => {
+    const url = new URL('./falcon.wasm', import.meta.url);
+    if (typeof process === 'object' && process.versions?.node && url.protocol === 'file:') {
+      const { readFile } = await import('fs/promises');
+      return WebAssembly.compile(await readFile(url));
+    }
+    const response = await fetch(url);
+    if (!response.ok) throw new Error(`Failed to fetch ${url}: ${response.status}`);
+    return WebAssembly.compile(await response.arrayBuffer());
+  })().catch(() => null);
+  return wasmModulePromise;
+}
+
+// Node's synchronous SHA-256, looked up on first use (null elsewhere)
+let nodeSha256;
+
+/**
+ * SHA-256 of a byte array: Node's native hash, or WebCrypto in browsers
+ * @param {Uint8Array} bytes - Bytes to hash
+ * @returns {Promise<Uint8Array>} 32-byte digest
+ */
+async function sha256(bytes) {
+  if (nodeSha256 === undefined) {
+    nodeSha256 = null;
+    if (typeof process === 'object' && process.versions?.node) {
+      const { createHash, hash } = await import('crypto');
+      nodeSha256 = hash ? (data) => hash('sha256', data, 'buffer') : (data) => createHash('sha256').update(data).digest();
+    }
+  }
+  if (nodeSha256) return new Uint8Array(nodeSha256(bytes));
+  return new Uint8Array(await globalThis.crypto.subtle.digest('SHA-256', bytes));
+}
+
+// Operations recorded while a trace is active (see Falcon.startTrace)
+const TRACED_OPS = ['keypair', 'sign', 'verify', 'verifyConstantTime', 'verifyBatch', 'convertToConstantTime'];
+
+/**
+ * Keyed fingerprint of byte arrays: HMAC-SHA-256 under the trace's random
+ * key, truncated to 64 bits
+ *
+ * The key never leaves the recording instance, so a recorded fingerprint
+ * cannot be checked against guessed inputs, even by someone who knows some
+ * of the traced keys or messages. The parts are copied before the first
+ * await, so callers may reuse their buffers once the operation starts.
+ * @param {Promise<CryptoKey>} key - HMAC key of the trace
+ * @param {Array<Uint8Array>} parts - Byte arrays hashed in order, each length-prefixed
+ * @returns {Promise<string>} 16 hex digits
+ */
+async function traceHash(key, parts) {
+  const data = new Uint8Array(parts.reduce((n, bytes) => n + 4 + bytes.length, 0));
+  const view = new DataView(data.buffer);
+  let offset = 0;
+  for (const bytes of parts) {
+    view.setUint32(offset, bytes.length);
+    data.set(bytes, offset + 4);
+    offset += 4 + bytes.length;
+  }
+  const mac = new Uint8Array(await globalThis.crypto.subtle.sign('HMAC', await key, data));
+  return Array.from(mac.subarray(0, 8), (b) => b.toString(16).padStart(2, '0')).join('');
+}
+
+/**
+ * FalconKey - A secret or public key held in WebAssembly memory
+ *
+ * Returned by Falcon.loadKey(); pass it to sign()/verify() in place of the key
+ * bytes to skip the per-call allocation and copy of the key.
+ */
+export class FalconKey {
+  /**
+   * @param {Falcon} falcon - Owning Falcon instance
+   * @param {'secret'|'public'|'midstate'} type - Key type
+   * @param {number} ptr - Address of the key in WebAssembly memory
+   * @param {number} length - Key length in bytes
+   * @param {number} byteLength - Bytes held in WebAssembly memory (default: length)
+   * @param {number|null} treeLevels - Cached LDL-tree levels of an expanded secret key, or null
+   */
+  constructor(falcon, type, ptr, length, byteLength = length, treeLevels = null) {
+    this.falcon = falcon;
+    this.type = type;
+    this.ptr = ptr;
+    this.length = length;
+    this.byteLength = byteLength;
+    this.treeLevels = treeLevels;
+    // Address of the key's SHAKE256 midstate, held after a plain secret key
+    this.midstate = null;
+    // SHA-256 of the secret key a midstate was computed from
+    this.keyDigest = null;
+    this.released = false;
+  }
+
+  /**
+   * Check whether the loaded key equals the given key bytes
+   * @param {Uint8Array} bytes - Key bytes to compare against
+   * @returns {boolean} True if the bytes match the loaded key
+   */
+  matches(bytes) {
+    if (this.released || bytes.length !== this.length) return false;
+    const heap = this.falcon._module.HEAPU8;
+    for (let i = 0; i < this.length; i++) {
+      if (heap[this.ptr + i] !== bytes[i]) return false;
+    }
+    return true;
+  }
+}
+
 /**
  * Falcon - A class for Falcon post-quantum cryptography signature operations
  */
 class Falcon {
   /**
    * Create a new Falcon instance
+   * @param {Object} options - Instance options
+   * @param {Function} options.print - Handler for the module's standard output (default: console.log)
+   * @param {Function} options.printErr - Handler for the module's standard error (default: console.error)
+   * @param {number} options.idleTimeoutMs - Dispose the module after this long without use; the next
+   *   operation re-instantiates it (default: never)
    */
-  constructor() {
+  constructor({ print, printErr, idleTimeoutMs = null } = {}) {
+    this._moduleOptions = {};
+    if (print) this._moduleOptions.print = print;
+    if (printErr) this._moduleOptions.printErr = printErr;
     this._module = null;
     this._initialized = false;
+    this._keys = new Set();
+    this._idleTimeoutMs = idleTimeoutMs;
+    this._idleTimer = null;
+    this._lastUsed = 0;
+    this._lifecycle = { disposals: 0, reclaimedBytes: 0, rewarms: 0, lastRewarmMs: null };
+    this._trace = null;
     this._initPromise = this._init();
   }
 
@@ -24,13 +155,42 @@ class Falcon {
     if (this._initialized) return;
     
     try {
-      this._module = await ModuleFactory();
+      const wasmModule = await compileWasmModule();
+      const options = { ...this._moduleOptions };
+      // The Emscripten loader waits for receiveInstance forever, so a failed
+      // instantiation settles the initialization through this promise instead
+      let instantiation = null;
+      if (wasmModule) {
+        let fail;
+        instantiation = new Promise((resolve, reject) => { fail = reject; });
+        options.instantiateWasm = (imports, receiveInstance) => {
+          WebAssembly.instantiate(wasmModule, imports).then(
+            (instance) => receiveInstance(instance, wasmModule),
+            (error) => {
+              // Compile afresh on the next attempt
+              wasmModulePromise = null;
+              fail(error);
+            },
+          );
+          return {};
+        };
+      }
+      this._module = await (instantiation ? Promise.race([ModuleFactory(options), instantiation]) : ModuleFactory(options));
       
-      // Get key and signature sizes from the module
-      this._PK_LEN = this._module._get_pk_size();
-      this._SK_LEN = this._module._get_sk_size();
-      this._SIG_COMPRESSED_MAX = this._module._get_sig_compressed_max_size();
-      this._SIG_CT_SIZE = this._module._get_sig_ct_size();
+      // Get key and signature sizes from the module (fixed per build, so
+      // only the first instance in the process queries them)
+      if (!moduleSizes) {
+        moduleSizes = {
+          pk: this._module._get_pk_size(),
+          sk: this._module._get_sk_size(),
+          sigCompressedMax: this._module._get_sig_compressed_max_size(),
+          sigCt: this._module._get_sig_ct_size(),
+        };
+      }
+      this._PK_LEN = moduleSizes.pk;
+      this._SK_LEN = moduleSizes.sk;
+      this._SIG_COMPRESSED_MAX = moduleSizes.sigCompressedMax;
+      this._SIG_CT_SIZE = moduleSizes.sigCt;
       
       this._initialized = true;
     } catch (error) {
@@ -45,7 +205,214 @@ class Falcon {
    */
   async _ensureInitialized() {
     if (!this._initialized) {
-      await this._initPromise;
+      this._initPromise ??= this._rewarm();
+      const pending = this._initPromise;
+      try {
+        await pending;
+      } catch (error) {
+        // Let the next operation try again
+        if (this._initPromise === pending) this._initPromise = null;
+        throw error;
+      }
+    }
+    if (this._idleTimeoutMs !== null) this._touch();
+  }
+
+  /**
+   * Re-instantiate the module after dispose(), timing it
+   * @private
+   */
+  async _rewarm() {
+    const start = performance.now();
+    await this._init();
+    this._lifecycle.rewarms++;
+    this._lifecycle.lastRewarmMs = performance.now() - start;
+  }
+
+  /**
+   * Record a use and arm the idle timer
+   * @private
+   */
+  _touch() {
+    this._lastUsed = Date.now();
+    if (this._idleTimer) return;
+    const check = () => {
+      const idle = Date.now() - this._lastUsed;
+      if (idle < this._idleTimeoutMs) {
+        this._idleTimer = setTimeout(check, this._idleTimeoutMs - idle);
+        this._idleTimer.unref?.();
+        return;
+      }
+      this._idleTimer = null;
+      this.dispose().catch(() => {});
+    };
+    this._idleTimer = setTimeout(check, this._idleTimeoutMs);
+    this._idleTimer.unref?.();
+  }
+
+  /**
+   * Release the WebAssembly instance and its memory
+   *
+   * All of linear memory is zeroized first, so secret keys (loaded ones and
+   * any left behind in freed blocks) do not outlive the instance. Loaded keys
+   * become unusable; keys passed as bytes keep working, since the next
+   * operation re-instantiates the module from the cached compiled module.
+   * @returns {Promise<Object>} { reclaimedBytes, releasedKeys }
+   */
+  async dispose() {
+    clearTimeout(this._idleTimer);
+    this._idleTimer = null;
+    if (this._initPromise) await this._initPromise.catch(() => {});
+    if (!this._initialized) return { reclaimedBytes: 0, releasedKeys: 0 };
+
+    const heap = this._module.HEAPU8;
+    const reclaimedBytes = heap.byteLength;
+    const releasedKeys = this._keys.size;
+    for (const key of this._keys) key.released = true;
+    this._keys.clear();
+    heap.fill(0);
+
+    this._module = null;
+    this._initialized = false;
+    this._initPromise = null;
+    this._lifecycle.disposals++;
+    this._lifecycle.reclaimedBytes += reclaimedBytes;
+    return { reclaimedBytes, releasedKeys };
+  }
+
+  /**
+   * Instance lifecycle statistics
+   * @returns {Object} State ('ready', 'warming' or 'disposed'), WebAssembly memory and loaded keys held,
+   *   disposals and total bytes reclaimed, re-warms and the latest re-warm time in milliseconds
+   */
+  lifecycleStats() {
+    return {
+      state: this._initialized ? 'ready' : this._initPromise ? 'warming' : 'disposed',
+      memoryBytes: this._initialized ? this._module.HEAPU8.byteLength : 0,
+      loadedKeys: this._keys.size,
+      idleTimeoutMs: this._idleTimeoutMs,
+      ...this._lifecycle,
+    };
+  }
+
+  /**
+   * Start recording a trace of this instance's operations, for replay with
+   * falcon-replay.js
+   *
+   * Each operation records its arrival time, duration, message and signature
+   * sizes, a fingerprint of its key and a hash of its inputs (and the result
+   * of a verification). No key, message or signature bytes are recorded.
+   * Fingerprints and hashes are HMACs under a random key that is discarded
+   * with the trace, so they only tell keys and inputs apart within the trace
+   * and cannot be matched against guessed inputs. Nothing is added to
+   * operations while no trace is being recorded.
+   * @param {Object} options - Trace options
+   * @param {number} options.maxEvents - Operations kept; later ones are only counted (default: 100000)
+   */
+  startTrace({ maxEvents = 100000 } = {}) {
+    if (this._trace) throw new Error('A trace is already being recorded');
+    this._trace = {
+      startedAt: Date.now(),
+      origin: performance.now(),
+      key: globalThis.crypto.subtle.importKey('raw', globalThis.crypto.getRandomValues(new Uint8Array(32)),
+        { name: 'HMAC', hash: 'SHA-256' }, false, ['sign']),
+      events: [],
+      maxEvents,
+      dropped: 0,
+    };
+    for (const op of TRACED_OPS) {
+      const method = Falcon.prototype[op];
+      this[op] = (...args) => this._traced(op, method, args);
+    }
+  }
+
+  /**
+   * Stop recording and return the trace
+   * @returns {Object} { version, startedAt, events, dropped }, JSON-serializable
+   */
+  stopTrace() {
+    if (!this._trace) throw new Error('No trace is being recorded');
+    for (const op of TRACED_OPS) delete this[op];
+    const { startedAt, events, dropped } = this._trace;
+    this._trace = null;
+    events.sort((a, b) => a.t - b.t);
+    return { version: 1, startedAt: new Date(startedAt).toISOString(), events, dropped };
+  }
+
+  /**
+   * Run an operation and record it in the active trace
+   * @private
+   */
+  async _traced(op, method, args) {
+    const trace = this._trace;
+    const arrival = performance.now();
+    // Inputs are read before the call, while a loaded key is certainly still
+    // loaded, and hashed while the operation runs
+    const described = this._describeInputs(op, args, trace.key).catch(() => ({}));
+    const event = { t: arrival - trace.origin, op };
+    let result;
+    try {
+      result = await method.apply(this, args);
+      return result;
+    } catch (error) {
+      event.error = true;
+      throw error;
+    } finally {
+      event.ms = performance.now() - arrival;
+      Object.assign(event, await described);
+      if (!event.error) {
+        if (op === 'verify' || op === 'verifyConstantTime') event.ok = result;
+        if (op === 'verifyBatch') event.items?.forEach((item, i) => { item.ok = result[i].ok; });
+      }
+      if (trace.events.length < trace.maxEvents) trace.events.push(event);
+      else trace.dropped++;
+    }
+  }
+
+  /**
+   * Sizes, key fingerprint and input hash of a traced operation
+   * @private
+   */
+  async _describeInputs(op, args, key) {
+    const bytes = (value, isText) => {
+      if (value instanceof FalconKey) {
+        return value.released ? new Uint8Array(0) : this._module.HEAPU8.slice(value.ptr, value.ptr + value.length);
+      }
+      // A malformed hex string fails in the operation itself, not here
+      if (typeof value === 'string') return isText || !/^([0-9a-f]{2})+$/i.test(value) ? new TextEncoder().encode(value) : Falcon.hexToBytes(value);
+      return value instanceof Uint8Array ? value : new Uint8Array(0);
+    };
+    // Both hashes start (and copy their inputs) before the first await
+    const verifyItem = async (message, signature, publicKey) => {
+      const msg = bytes(message, true);
+      const sig = bytes(signature);
+      const pk = bytes(publicKey);
+      const [keyHash, input] = await Promise.all([traceHash(key, [pk]), traceHash(key, [msg, sig, pk])]);
+      return { messageBytes: msg.length, signatureBytes: sig.length, key: keyHash, input };
+    };
+
+    switch (op) {
+      case 'sign': {
+        const [message, secretKey] = args;
+        const msg = bytes(message, true);
+        const sk = bytes(secretKey);
+        const [keyHash, input] = await Promise.all([traceHash(key, [sk]), traceHash(key, [msg, sk])]);
+        return { messageBytes: msg.length, key: keyHash, input };
+      }
+      case 'verify':
+      case 'verifyConstantTime':
+        return verifyItem(...args);
+      case 'verifyBatch':
+        return {
+          constantTime: Boolean(args[1]?.constantTime),
+          items: await Promise.all(args[0].map(({ message, signature, publicKey }) => verifyItem(message, signature, publicKey))),
+        };
+      case 'convertToConstantTime': {
+        const sig = bytes(args[0]);
+        return { signatureBytes: sig.length, input: await traceHash(key, [sig]) };
+      }
+      default:
+        return {};
     }
   }
 
@@ -97,34 +464,238 @@ class Falcon {
     }
   }
 
+  /**
+   * Whether the module can expand secret keys with a partial LDL tree
+   * (see loadKey); builds older than the wrapper's partial-tree exports can't
+   * @returns {Promise<boolean>} True if treeLevels is supported
+   */
+  async supportsTreeLevels() {
+    await this._ensureInitialized();
+    return typeof this._module._falcon_det1024_expand_partial_wrapper === 'function';
+  }
+
+  /**
+   * Load a key into WebAssembly memory for repeated use
+   *
+   * With treeLevels, a secret key is expanded: its basis in FFT form and the
+   * top treeLevels levels of its ffLDL tree (0 to 10) are cached, trading
+   * memory (about 35 KB at 0 levels, 58 KB at 1, plus 8 KB per further
+   * level) for signing time. Signatures are identical either way. Ignored for public keys and
+   * by builds without partial-tree support.
+   * @param {Uint8Array|string} key - Secret or public key (Uint8Array or hex string)
+   * @param {'secret'|'public'} type - Key type
+   * @param {Object} options - Load options
+   * @param {number} options.treeLevels - LDL-tree levels to cache for a secret key (default: none)
+   * @returns {Promise<FalconKey>} Loaded key, usable in place of the key bytes
+   * @throws {Error} If the key length is invalid
+   */
+  async loadKey(key, type, { treeLevels = null } = {}) {
+    await this._ensureInitialized();
+
+    const bytes = typeof key === 'string' ? Falcon.hexToBytes(key) : key;
+    const expected = type === 'secret' ? this._SK_LEN : this._PK_LEN;
+    if (bytes.length !== expected) {
+      throw new Error(`Invalid ${type} key length: ${bytes.length}, expected ${expected}`);
+    }
+
+    if (type === 'secret' && treeLevels !== null && await this.supportsTreeLevels()) {
+      return this._expandKey(bytes, treeLevels);
+    }
+
+    // A plain secret key carries its midstate, so signing skips absorbing the key
+    const midstateSize = type === 'secret' && await this.supportsMidstates()
+      ? this._module._falcon_det1024_sk_midstate_size()
+      : 0;
+    const ptr = this._module._malloc(expected + midstateSize);
+    this._module.HEAPU8.set(bytes, ptr);
+    const loaded = new FalconKey(this, type, ptr, expected, expected + midstateSize);
+    if (midstateSize > 0) {
+      const res = this._module._falcon_det1024_sk_midstate_wrapper(ptr + expected, ptr);
+      if (res !== 0) {
+        this._module.HEAPU8.fill(0, ptr, ptr + expected);
+        this._module._free(ptr);
+        throw new Error(`Midstate computation failed with error code: ${res}`);
+      }
+      loaded.midstate = ptr + expected;
+    }
+    this._keys.add(loaded);
+    return loaded;
+  }
+
+  /**
+   * Whether the module can cache secret-key midstates (see loadMidstate);
+   * builds older than the wrapper's midstate exports can't
+   * @returns {Promise<boolean>} True if midstates are supported
+   */
+  async supportsMidstates() {
+    await this._ensureInitialized();
+    return typeof this._module._falcon_det1024_sk_midstate_wrapper === 'function';
+  }
+
+  /**
+   * Compute the SHAKE256 midstate of a secret key
+   *
+   * Signing first absorbs the secret key (2306 bytes, 17 Keccak
+   * permutations) into its deterministic RNG, which dominates hashing for
+   * short messages. The midstate is that RNG state, 208 bytes; passed to
+   * sign() with the same key, it is copied instead of recomputed. Signatures
+   * are identical either way. The midstate is bound to the SHA-256 digest of
+   * its key, which sign() checks the given key against: another key's
+   * midstate would give valid but non-deterministic signatures. It
+   * reproduces the key's signing randomness, so it is as secret as the key:
+   * releaseKey() zeroizes it. Plain keys from loadKey() already carry theirs.
+   * @param {Uint8Array|string} secretKey - The secret key (Uint8Array or hex string)
+   * @returns {Promise<FalconKey|null>} Midstate, or null on builds without the midstate exports
+   * @throws {Error} If the key is invalid, or WebAssembly memory is exhausted
+   */
+  async loadMidstate(secretKey) {
+    if (!await this.supportsMidstates()) return null;
+    const bytes = typeof secretKey === 'string' ? Falcon.hexToBytes(secretKey) : secretKey;
+    if (bytes.length !== this._SK_LEN) {
+      throw new Error(`Invalid secret key length: ${bytes.length}, expected ${this._SK_LEN}`);
+    }
+    const keyDigest = await sha256(bytes);
+    await this._ensureInitialized();
+    // Memory is fixed, so running out fails this call rather than the instance
+    const module = this._module;
+    const size = module._falcon_det1024_sk_midstate_size();
+    const skPtr = this._tryMalloc(module, this._SK_LEN);
+    const ptr = skPtr && this._tryMalloc(module, size);
+    if (!ptr) {
+      if (skPtr) module._free(skPtr);
+      throw new Error('Out of WebAssembly memory for a midstate');
+    }
+    module.HEAPU8.set(bytes, skPtr);
+    try {
+      const res = module._falcon_det1024_sk_midstate_wrapper(ptr, skPtr);
+      if (res !== 0) {
+        module._free(ptr);
+        throw new Error(`Midstate computation failed with error code: ${res}`);
+      }
+      const loaded = new FalconKey(this, 'midstate', ptr, size);
+      loaded.keyDigest = keyDigest;
+      this._keys.add(loaded);
+      return loaded;
+    } finally {
+      module.HEAPU8.fill(0, skPtr, skPtr + this._SK_LEN);
+      module._free(skPtr);
+    }
+  }
+
+  /**
+   * Expand a secret key with a partial LDL tree
+   * @private
+   */
+  _expandKey(bytes, treeLevels) {
+    const size = Number.isInteger(treeLevels) ? this._module._falcon_det1024_partial_key_size(treeLevels) : 0;
+    if (size === 0) {
+      throw new Error(`Invalid treeLevels: ${treeLevels}, expected an integer from 0 to 10`);
+    }
+
+    const skPtr = this._module._malloc(bytes.length);
+    const ptr = this._module._malloc(size);
+    this._module.HEAPU8.set(bytes, skPtr);
+    try {
+      const res = this._module._falcon_det1024_expand_partial_wrapper(ptr, skPtr, treeLevels);
+      if (res !== 0) {
+        this._module._free(ptr);
+        throw new Error(`Key expansion failed with error code: ${res}`);
+      }
+      const loaded = new FalconKey(this, 'secret', ptr, bytes.length, size, treeLevels);
+      this._keys.add(loaded);
+      return loaded;
+    } finally {
+      this._module.HEAPU8.fill(0, skPtr, skPtr + bytes.length);
+      this._module._free(skPtr);
+    }
+  }
+
+  /**
+   * Release a loaded key, zeroizing secret keys and midstates before freeing them
+   * @param {FalconKey} key - Key returned by loadKey() or loadMidstate()
+   */
+  releaseKey(key) {
+    if (key.released) return;
+    if (key.type !== 'public') {
+      this._module.HEAPU8.fill(0, key.ptr, key.ptr + key.byteLength);
+    }
+    this._module._free(key.ptr);
+    key.released = true;
+    this._keys.delete(key);
+  }
+
+  /**
+   * Resolve a key argument to a pointer in WebAssembly memory
+   * @private
+   * @returns {{ptr: number, owned: boolean}} Pointer and whether the caller must free it
+   */
+  _keyArg(key, type) {
+    const expected = type === 'secret' ? this._SK_LEN : this._PK_LEN;
+
+    if (key instanceof FalconKey) {
+      if (key.released || key.falcon !== this || key.type !== type) {
+        throw new Error(`Invalid loaded ${type} key`);
+      }
+      return { ptr: key.ptr, owned: false };
+    }
+
+    // Convert the key to Uint8Array if it's a hex string
+    const bytes = typeof key === 'string' ? Falcon.hexToBytes(key) : key;
+    if (bytes.length !== expected) {
+      throw new Error(`Invalid ${type} key length: ${bytes.length}, expected ${expected}`);
+    }
+
+    const ptr = this._module._malloc(expected);
+    this._module.HEAPU8.set(bytes, ptr);
+    return { ptr, owned: true };
+  }
+
+  /**
+   * Check that a midstate was computed from the given secret key bytes,
+   * comparing SHA-256 digests in constant time
+   * @private
+   */
+  async _checkMidstate(midstate, secretKey) {
+    if (!(midstate instanceof FalconKey) || midstate.released || midstate.falcon !== this || midstate.type !== 'midstate') {
+      throw new Error('Invalid midstate');
+    }
+    if (secretKey instanceof FalconKey) {
+      throw new Error('Midstates are passed with secret key bytes; loaded keys carry their own');
+    }
+    const bytes = typeof secretKey === 'string' ? Falcon.hexToBytes(secretKey) : secretKey;
+    if (bytes.length !== this._SK_LEN) {
+      throw new Error(`Invalid secret key length: ${bytes.length}, expected ${this._SK_LEN}`);
+    }
+    const digest = await sha256(bytes);
+    let diff = 0;
+    for (let i = 0; i < digest.length; i++) diff |= digest[i] ^ midstate.keyDigest[i];
+    if (diff !== 0) throw new Error('Midstate does not belong to this secret key');
+  }
+
   /**
    * Sign a message with a secret key using deterministic Falcon-1024
    * @param {Uint8Array|string} message - The message to sign (string or Uint8Array)
-   * @param {Uint8Array|string} secretKey - The secret key (Uint8Array or hex string)
+   * @param {Uint8Array|string|FalconKey} secretKey - The secret key (Uint8Array, hex string or loaded key)
+   * @param {Object} options - Sign options
+   * @param {FalconKey} options.midstate - Midstate of secretKey (key bytes) from loadMidstate() (default: none)
    * @returns {Promise<Uint8Array>} The compressed signature
-   * @throws {Error} If signing fails
+   * @throws {Error} If signing fails, or the midstate was computed from another key
    */
-  async sign(message, secretKey) {
+  async sign(message, secretKey, { midstate = null } = {}) {
+    if (midstate) await this._checkMidstate(midstate, secretKey);
     await this._ensureInitialized();
+    // The instance may have been disposed meanwhile
+    if (midstate?.released) throw new Error('Invalid midstate');
 
     // Convert message to Uint8Array if it's a string
     const msg = typeof message === 'string' ? new TextEncoder().encode(message) : message;
     
-    // Convert secretKey to Uint8Array if it's a hex string
-    const sk = typeof secretKey === 'string' ? Falcon.hexToBytes(secretKey) : secretKey;
+    // Resolve the secret key (validates its length unless already loaded)
+    const { ptr: skPtr, owned: skOwned } = this._keyArg(secretKey, 'secret');
 
-    // Verify the secret key length
-    if (sk.length !== this._SK_LEN) {
-      throw new Error(`Invalid secret key length: ${sk.length}, expected ${this._SK_LEN}`);
-    }
-
-    // Allocate memory for message and secret key
+    // Allocate memory for message and copy it to WebAssembly memory
     const msgPtr = this._module._malloc(msg.length);
-    const skPtr = this._module._malloc(this._SK_LEN);
-    
-    // Copy message and secret key to WebAssembly memory
     this._module.HEAPU8.set(msg, msgPtr);
-    this._module.HEAPU8.set(sk, skPtr);
 
     // Allocate memory for signature and signature length
     const sigPtr = this._module._malloc(this._SIG_COMPRESSED_MAX);
@@ -134,8 +705,17 @@ class Falcon {
     this._module.setValue(sigLenPtr, this._SIG_COMPRESSED_MAX, "i32");
 
     try {
-      // Call the deterministic signature function
-      const res = this._module._falcon_det1024_sign_compressed_wrapper(sigPtr, sigLenPtr, skPtr, msgPtr, msg.length);
+      // Call the deterministic signature function (expanded keys skip
+      // rebuilding the cached part of the LDL tree, midstates skip absorbing the key)
+      const msPtr = secretKey instanceof FalconKey ? secretKey.midstate : midstate?.ptr;
+      let res;
+      if (secretKey instanceof FalconKey && secretKey.treeLevels !== null) {
+        res = this._module._falcon_det1024_sign_compressed_partial_wrapper(sigPtr, sigLenPtr, skPtr, msgPtr, msg.length);
+      } else if (msPtr) {
+        res = this._module._falcon_det1024_sign_compressed_midstate_wrapper(sigPtr, sigLenPtr, skPtr, msPtr, msgPtr, msg.length);
+      } else {
+        res = this._module._falcon_det1024_sign_compressed_wrapper(sigPtr, sigLenPtr, skPtr, msgPtr, msg.length);
+      }
       
       if (res !== 0) {
         throw new Error(`Sign failed with error code: ${res}`);
@@ -149,7 +729,7 @@ class Falcon {
     } finally {
       // Free allocated memory
       this._module._free(msgPtr);
-      this._module._free(skPtr);
+      if (skOwned) this._module._free(skPtr);
       this._module._free(sigPtr);
       this._module._free(sigLenPtr);
     }
@@ -225,7 +805,7 @@ class Falcon {
    * Verify a compressed signature
    * @param {Uint8Array|string} message - The message (string or Uint8Array)
    * @param {Uint8Array|string} signature - The compressed signature (Uint8Array or hex string)
-   * @param {Uint8Array|string} publicKey - The public key (Uint8Array or hex string)
+   * @param {Uint8Array|string|FalconKey} publicKey - The public key (Uint8Array, hex string or loaded key)
    * @returns {Promise<boolean>} True if the signature is valid, false otherwise
    * @throws {Error} If verification fails with an error
    */
@@ -235,24 +815,24 @@ class Falcon {
     // Convert message to Uint8Array if it's a string
     const msg = typeof message === 'string' ? new TextEncoder().encode(message) : message;
     
-    // Convert signature and publicKey to Uint8Array if they're hex strings
+    // Convert signature to Uint8Array if it's a hex string
     const sig = typeof signature === 'string' ? Falcon.hexToBytes(signature) : signature;
-    const pk = typeof publicKey === 'string' ? Falcon.hexToBytes(publicKey) : publicKey;
 
-    // Verify the public key length
-    if (pk.length !== this._PK_LEN) {
-      throw new Error(`Invalid public key length: ${pk.length}, expected ${this._PK_LEN}`);
+    // No valid signature is longer than the signer's maximum: reject before copying
+    if (sig.length < 2 || sig.length > this._SIG_COMPRESSED_MAX) {
+      return false;
     }
 
-    // Allocate memory for message, signature, and public key
+    // Resolve the public key (validates its length unless already loaded)
+    const { ptr: pkPtr, owned: pkOwned } = this._keyArg(publicKey, 'public');
+
+    // Allocate memory for message and signature
     const msgPtr = this._module._malloc(msg.length);
     const sigPtr = this._module._malloc(sig.length);
-    const pkPtr = this._module._malloc(this._PK_LEN);
     
-    // Copy message, signature, and public key to WebAssembly memory
+    // Copy message and signature to WebAssembly memory
     this._module.HEAPU8.set(msg, msgPtr);
     this._module.HEAPU8.set(sig, sigPtr);
-    this._module.HEAPU8.set(pk, pkPtr);
 
     try {
       // Use the deterministic verify function for compressed signatures
@@ -263,7 +843,7 @@ class Falcon {
       // Free allocated memory
       this._module._free(msgPtr);
       this._module._free(sigPtr);
-      this._module._free(pkPtr);
+      if (pkOwned) this._module._free(pkPtr);
     }
   }
 
@@ -271,7 +851,7 @@ class Falcon {
    * Verify a constant-time signature
    * @param {Uint8Array|string} message - The message (string or Uint8Array)
    * @param {Uint8Array|string} signature - The constant-time signature (Uint8Array or hex string)
-   * @param {Uint8Array|string} publicKey - The public key (Uint8Array or hex string)
+   * @param {Uint8Array|string|FalconKey} publicKey - The public key (Uint8Array, hex string or loaded key)
    * @returns {Promise<boolean>} True if the signature is valid, false otherwise
    * @throws {Error} If verification fails with an error
    */
@@ -281,27 +861,24 @@ class Falcon {
     // Convert message to Uint8Array if it's a string
     const msg = typeof message === 'string' ? new TextEncoder().encode(message) : message;
     
-    // Convert signature and publicKey to Uint8Array if they're hex strings
+    // Convert signature to Uint8Array if it's a hex string
     const sig = typeof signature === 'string' ? Falcon.hexToBytes(signature) : signature;
-    const pk = typeof publicKey === 'string' ? Falcon.hexToBytes(publicKey) : publicKey;
 
-    // Verify the public key length and signature length
-    if (pk.length !== this._PK_LEN) {
-      throw new Error(`Invalid public key length: ${pk.length}, expected ${this._PK_LEN}`);
-    }
+    // Verify the signature length
     if (sig.length !== this._SIG_CT_SIZE) {
       throw new Error(`Invalid CT signature length: ${sig.length}, expected ${this._SIG_CT_SIZE}`);
     }
 
-    // Allocate memory for message, signature, and public key
+    // Resolve the public key (validates its length unless already loaded)
+    const { ptr: pkPtr, owned: pkOwned } = this._keyArg(publicKey, 'public');
+
+    // Allocate memory for message and signature
     const msgPtr = this._module._malloc(msg.length);
     const sigPtr = this._module._malloc(sig.length);
-    const pkPtr = this._module._malloc(this._PK_LEN);
     
-    // Copy message, signature, and public key to WebAssembly memory
+    // Copy message and signature to WebAssembly memory
     this._module.HEAPU8.set(msg, msgPtr);
     this._module.HEAPU8.set(sig, sigPtr);
-    this._module.HEAPU8.set(pk, pkPtr);
 
     try {
       // Use the deterministic verify function for CT signatures
@@ -312,8 +889,336 @@ class Falcon {
       // Free allocated memory
       this._module._free(msgPtr);
       this._module._free(sigPtr);
-      this._module._free(pkPtr);
+      if (pkOwned) this._module._free(pkPtr);
+    }
+  }
+
+  /**
+   * Verify a batch of signatures
+   *
+   * Messages and signatures are copied into one WebAssembly allocation, and a
+   * public key shared by consecutive items is copied once. A malformed item
+   * (wrong key or CT signature length) does not fail the batch; its result
+   * carries the error instead.
+   * @param {Array<Object>} items - Items of { message, signature, publicKey }, as accepted by verify()
+   * @param {Object} options - Batch options
+   * @param {boolean} options.constantTime - Signatures are in constant-time format (default: false)
+   * @returns {Promise<Array<Object>>} One { ok, error? } per item, in order
+   */
+  async verifyBatch(items, { constantTime = false } = {}) {
+    await this._ensureInitialized();
+
+    const entries = items.map(({ message, signature, publicKey }) => ({
+      msg: typeof message === 'string' ? new TextEncoder().encode(message) : message,
+      sig: typeof signature === 'string' ? Falcon.hexToBytes(signature) : signature,
+      publicKey,
+    }));
+    const total = entries.reduce((n, e) => n + e.msg.length + e.sig.length, 0);
+    const arena = this._module._malloc(Math.max(1, total));
+
+    const results = new Array(entries.length);
+    let pk = { ptr: 0, owned: false };
+    let pkSource = null;
+    try {
+      let offset = arena;
+      for (let i = 0; i < entries.length; i++) {
+        const { msg, sig, publicKey } = entries[i];
+        const msgPtr = offset;
+        const sigPtr = offset + msg.length;
+        offset += msg.length + sig.length;
+
+        if (constantTime && sig.length !== this._SIG_CT_SIZE) {
+          results[i] = { ok: false, error: `Invalid CT signature length: ${sig.length}, expected ${this._SIG_CT_SIZE}` };
+          continue;
+        }
+        if (!constantTime && (sig.length < 2 || sig.length > this._SIG_COMPRESSED_MAX)) {
+          results[i] = { ok: false };
+          continue;
+        }
+
+        if (!this._sameBatchKey(publicKey, pkSource, pk)) {
+          if (pk.owned) this._module._free(pk.ptr);
+          pk = { ptr: 0, owned: false };
+          pkSource = null;
+          try {
+            pk = this._keyArg(publicKey, 'public');
+            pkSource = publicKey;
+          } catch (error) {
+            results[i] = { ok: false, error: error.message };
+            continue;
+          }
+        }
+
+        this._module.HEAPU8.set(msg, msgPtr);
+        this._module.HEAPU8.set(sig, sigPtr);
+        const res = constantTime
+          ? this._module._falcon_det1024_verify_ct_wrapper(sigPtr, pk.ptr, msgPtr, msg.length)
+          : this._module._falcon_det1024_verify_compressed_wrapper(sigPtr, sig.length, pk.ptr, msgPtr, msg.length);
+        results[i] = { ok: res === 0 };
+      }
+      return results;
+    } finally {
+      if (pk.owned) this._module._free(pk.ptr);
+      this._module._free(arena);
+    }
+  }
+
+  /**
+   * Check whether a batch item uses the public key already in WebAssembly memory
+   * @private
+   */
+  _sameBatchKey(publicKey, pkSource, pk) {
+    if (pkSource === null) return false;
+    if (publicKey === pkSource) return true;
+    if (!pk.owned || !(publicKey instanceof Uint8Array) || publicKey.length !== this._PK_LEN) return false;
+    const heap = this._module.HEAPU8;
+    for (let i = 0; i < publicKey.length; i++) {
+      if (heap[pk.ptr + i] !== publicKey[i]) return false;
     }
+    return true;
+  }
+
+  /**
+   * Verify a stream of signatures, yielding results as each batch completes
+   *
+   * Items are pulled from the source only as results are consumed, so at most
+   * one batch (bounded by batchSize and maxBatchBytes) is held in memory and a
+   * slow consumer slows the producer down.
+   * @param {AsyncIterable<Object>|Iterable<Object>} source - Items of { message, signature, publicKey }
+   * @param {Object} options - Stream options
+   * @param {number} options.batchSize - Items per batch (default: 64)
+   * @param {number} options.maxBatchBytes - Message and signature bytes per batch (default: 1 MiB)
+   * @param {boolean} options.constantTime - Signatures are in constant-time format (default: false)
+   * @returns {AsyncGenerator<Object>} { index, ok, error? } per item, in source order
+   */
+  async *verifyStream(source, { batchSize = 64, maxBatchBytes = 1 << 20, constantTime = false } = {}) {
+    let batch = [];
+    let bytes = 0;
+    let start = 0;
+    for await (const item of source) {
+      batch.push(item);
+      bytes += (item.message?.length ?? 0) + (item.signature?.length ?? 0);
+      if (batch.length >= batchSize || bytes >= maxBatchBytes) {
+        const results = await this.verifyBatch(batch, { constantTime });
+        batch = [];
+        bytes = 0;
+        for (let i = 0; i < results.length; i++) yield { index: start + i, ...results[i] };
+        start += results.length;
+      }
+    }
+    if (batch.length > 0) {
+      const results = await this.verifyBatch(batch, { constantTime });
+      for (let i = 0; i < results.length; i++) yield { index: start + i, ...results[i] };
+    }
+  }
+
+  /**
+   * Whether the build exports the streaming sign/verify functions, which
+   * let signFile()/verifyFile() handle files larger than WebAssembly memory
+   * @returns {Promise<boolean>} True if the streaming exports are available
+   */
+  async supportsStreaming() {
+    await this._ensureInitialized();
+    return typeof this._module._falcon_det1024_sign_stream_init === 'function';
+  }
+
+  /**
+   * Sign a file (Node.js), reading it straight into WebAssembly memory
+   *
+   * File bytes are copied once, from the file into a WebAssembly buffer. With
+   * the streaming exports, one chunkSize buffer is reused and each chunk is
+   * absorbed as it is read, so files of any size can be signed. Otherwise
+   * the whole file is read into WebAssembly memory and must fit in it. The
+   * signature is the one sign() returns for the file's contents.
+   * @param {string|URL} path - File to sign
+   * @param {Uint8Array|string|FalconKey} secretKey - The secret key (Uint8Array, hex string or loaded key)
+   * @param {Object} options - File options
+   * @param {number} options.chunkSize - Bytes read at a time (default: 1 MiB)
+   * @returns {Promise<Uint8Array>} The compressed signature
+   * @throws {Error} If the file cannot be read or signing fails
+   */
+  async signFile(path, secretKey, { chunkSize = 1 << 20 } = {}) {
+    await this._ensureInitialized();
+    const module = this._module;
+    const { ptr: skPtr, owned: skOwned } = this._keyArg(secretKey, 'secret');
+    const sigPtr = module._malloc(this._SIG_COMPRESSED_MAX);
+    const sigLenPtr = module._malloc(4);
+    module.setValue(sigLenPtr, this._SIG_COMPRESSED_MAX, 'i32');
+
+    try {
+      let res;
+      if (typeof module._falcon_det1024_sign_stream_init === 'function') {
+        const stream = module._falcon_det1024_sign_stream_init(skPtr);
+        if (!stream) throw new Error('Invalid secret key');
+        try {
+          await this._readFileChunks(module, path, chunkSize, (ptr, length) => {
+            module._falcon_det1024_sign_stream_update(stream, ptr, length);
+          });
+        } catch (error) {
+          if (this._module === module) module._falcon_det1024_sign_stream_abort(stream);
+          throw error;
+        }
+        res = module._falcon_det1024_sign_stream_finish(stream, sigPtr, sigLenPtr);
+      } else {
+        res = await this._withFileInMemory(module, path, chunkSize, (msgPtr, length) =>
+          secretKey instanceof FalconKey && secretKey.treeLevels !== null
+            ? module._falcon_det1024_sign_compressed_partial_wrapper(sigPtr, sigLenPtr, skPtr, msgPtr, length)
+            : module._falcon_det1024_sign_compressed_wrapper(sigPtr, sigLenPtr, skPtr, msgPtr, length));
+      }
+
+      if (res !== 0) {
+        throw new Error(`Sign failed with error code: ${res}`);
+      }
+      const sigLen = module.getValue(sigLenPtr, 'i32');
+      return new Uint8Array(module.HEAPU8.buffer, sigPtr, sigLen).slice();
+    } finally {
+      if (this._module === module) {
+        if (skOwned) {
+          module.HEAPU8.fill(0, skPtr, skPtr + this._SK_LEN);
+          module._free(skPtr);
+        }
+        module._free(sigPtr);
+        module._free(sigLenPtr);
+      }
+    }
+  }
+
+  /**
+   * Verify a signature over a file (Node.js), reading it straight into
+   * WebAssembly memory in the same way as signFile()
+   * @param {string|URL} path - Signed file
+   * @param {Uint8Array|string} signature - The signature (Uint8Array or hex string)
+   * @param {Uint8Array|string|FalconKey} publicKey - The public key (Uint8Array, hex string or loaded key)
+   * @param {Object} options - File options
+   * @param {boolean} options.constantTime - The signature is in constant-time format (default: false)
+   * @param {number} options.chunkSize - Bytes read at a time (default: 1 MiB)
+   * @returns {Promise<boolean>} True if the signature is valid for the file's contents
+   * @throws {Error} If the file cannot be read
+   */
+  async verifyFile(path, signature, publicKey, { constantTime = false, chunkSize = 1 << 20 } = {}) {
+    await this._ensureInitialized();
+    const module = this._module;
+    const sig = typeof signature === 'string' ? Falcon.hexToBytes(signature) : signature;
+    if (constantTime ? sig.length !== this._SIG_CT_SIZE : sig.length < 2 || sig.length > this._SIG_COMPRESSED_MAX) {
+      return false;
+    }
+
+    const { ptr: pkPtr, owned: pkOwned } = this._keyArg(publicKey, 'public');
+    const sigPtr = module._malloc(sig.length);
+    module.HEAPU8.set(sig, sigPtr);
+
+    try {
+      let res;
+      if (typeof module._falcon_det1024_verify_stream_init === 'function') {
+        const stream = module._falcon_det1024_verify_stream_init(sigPtr, sig.length, pkPtr, constantTime ? 1 : 0);
+        if (!stream) return false;
+        try {
+          await this._readFileChunks(module, path, chunkSize, (ptr, length) => {
+            module._falcon_det1024_verify_stream_update(stream, ptr, length);
+          });
+        } catch (error) {
+          if (this._module === module) module._falcon_det1024_verify_stream_abort(stream);
+          throw error;
+        }
+        res = module._falcon_det1024_verify_stream_finish(stream);
+      } else {
+        res = await this._withFileInMemory(module, path, chunkSize, (msgPtr, length) => constantTime
+          ? module._falcon_det1024_verify_ct_wrapper(sigPtr, pkPtr, msgPtr, length)
+          : module._falcon_det1024_verify_compressed_wrapper(sigPtr, sig.length, pkPtr, msgPtr, length));
+      }
+      return res === 0;
+    } finally {
+      if (this._module === module) {
+        if (pkOwned) module._free(pkPtr);
+        module._free(sigPtr);
+      }
+    }
+  }
+
+  /**
+   * Read a file chunk by chunk into one WebAssembly buffer
+   *
+   * Reads are synchronous, so WebAssembly memory cannot grow (and move)
+   * under a read in flight; the event loop runs between chunks.
+   * @private
+   * @returns {Promise<number>} Bytes read
+   */
+  async _readFileChunks(module, path, chunkSize, consume) {
+    const { openSync, readSync, closeSync } = await import('fs');
+    const fd = openSync(path, 'r');
+    const chunkPtr = this._tryMalloc(module, chunkSize);
+    if (!chunkPtr) {
+      closeSync(fd);
+      throw new Error(`Cannot allocate a ${chunkSize}-byte chunk in WebAssembly memory`);
+    }
+    try {
+      let position = 0;
+      for (;;) {
+        const bytesRead = readSync(fd, module.HEAPU8, chunkPtr, chunkSize, position);
+        if (bytesRead === 0) return position;
+        consume(chunkPtr, bytesRead);
+        position += bytesRead;
+        await new Promise((resolve) => setImmediate(resolve));
+        this._checkFileModule(module);
+      }
+    } finally {
+      if (this._module === module) module._free(chunkPtr);
+      closeSync(fd);
+    }
+  }
+
+  /**
+   * Read a whole file into WebAssembly memory (builds without the streaming
+   * exports) and run an operation on it
+   * @private
+   */
+  async _withFileInMemory(module, path, chunkSize, operation) {
+    const { openSync, readSync, fstatSync, closeSync } = await import('fs');
+    const fd = openSync(path, 'r');
+    let ptr = 0;
+    try {
+      const { size } = fstatSync(fd);
+      ptr = this._tryMalloc(module, Math.max(1, size));
+      if (!ptr) {
+        throw new Error(`File of ${size} bytes does not fit in WebAssembly memory; rebuild falcon.wasm with the streaming exports`);
+      }
+      let position = 0;
+      while (position < size) {
+        const bytesRead = readSync(fd, module.HEAPU8, ptr + position, Math.min(chunkSize, size - position), position);
+        if (bytesRead === 0) throw new Error('File shrank while being read');
+        position += bytesRead;
+        await new Promise((resolve) => setImmediate(resolve));
+        this._checkFileModule(module);
+      }
+      return operation(ptr, size);
+    } finally {
+      if (ptr && this._module === module) module._free(ptr);
+      closeSync(fd);
+    }
+  }
+
+  /**
+   * Allocate WebAssembly memory, returning 0 instead of aborting when the
+   * (fixed-size) memory is exhausted
+   * @private
+   */
+  _tryMalloc(module, size) {
+    if (size >= module.HEAPU8.byteLength) return 0;
+    try {
+      return module._malloc(size);
+    } catch {
+      return 0;
+    }
+  }
+
+  /**
+   * Keep the instance alive through a long file operation, and fail it if
+   * the instance was disposed between chunks
+   * @private
+   */
+  _checkFileModule(module) {
+    if (this._module !== module) throw new Error('Falcon instance was disposed during the file operation');
+    if (this._idleTimeoutMs !== null) this._touch();
   }
 }
 